@@ -0,0 +1,561 @@
+#!/usr/bin/env python3
+"""
+Static opcode-mix analysis of wasm modules, classification from measured characteristics, and a
+per-engine regression of time against opcode-class mix.
+
+Examples:
+  python3 analyze_wasm.py --root wasm/corpus --per-wasm --out logs/mix.json
+  python3 analyze_wasm.py --results logs/results.json --baseline wasm3:int:full
+"""
+
+from __future__ import annotations
+
+import argparse
+import hashlib
+import json
+import math
+import os
+import sys
+from collections import Counter
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+
+from wasm.wasm_binary import (
+    PREFIX_FB,
+    PREFIX_FC,
+    PREFIX_FD,
+    PREFIX_FE,
+    ModuleInfo,
+    iter_ops,
+    read_locals,
+    read_module,
+)
+
+OP_CLASSES = (
+    "control",  # br/br_if/br_table/if/else/return/unreachable
+    "structure",  # block/loop/end/nop (no work of their own in most engines)
+    "call",
+    "call_indirect",
+    "host",  # direct calls to imported functions (WASI)
+    "local",
+    "global",
+    "const",
+    "parametric",  # drop/select
+    "load",
+    "store",
+    "memory",  # memory.size/grow and bulk memory
+    "int",
+    "float",
+    "convert",
+    "simd",
+    "ref",  # reference types, tables and GC
+    "atomic",
+)
+
+# Instructions inside loops dominate execution; weight them by LOOP_WEIGHT per nesting level (capped).
+LOOP_WEIGHT = 8.0
+MAX_LOOP_LEVEL = 3
+
+_MVP_NAMES = {
+    0x00: "unreachable", 0x01: "nop", 0x02: "block", 0x03: "loop", 0x04: "if", 0x05: "else", 0x0B: "end",
+    0x0C: "br", 0x0D: "br_if", 0x0E: "br_table", 0x0F: "return", 0x10: "call", 0x11: "call_indirect",
+    0x12: "return_call", 0x13: "return_call_indirect", 0x14: "call_ref", 0x15: "return_call_ref",
+    0x1A: "drop", 0x1B: "select", 0x1C: "select_t", 0x20: "local.get", 0x21: "local.set", 0x22: "local.tee",
+    0x23: "global.get", 0x24: "global.set", 0x25: "table.get", 0x26: "table.set", 0x3F: "memory.size",
+    0x40: "memory.grow", 0x41: "i32.const", 0x42: "i64.const", 0x43: "f32.const", 0x44: "f64.const",
+    0xD0: "ref.null", 0xD1: "ref.is_null", 0xD2: "ref.func", 0xD3: "ref.eq", 0xD4: "ref.as_non_null",
+    0xD5: "br_on_null", 0xD6: "br_on_non_null",
+}  # fmt: skip
+_MEM_NAMES = (
+    "i32.load i64.load f32.load f64.load i32.load8_s i32.load8_u i32.load16_s i32.load16_u i64.load8_s i64.load8_u "
+    "i64.load16_s i64.load16_u i64.load32_s i64.load32_u i32.store i64.store f32.store f64.store i32.store8 "
+    "i32.store16 i64.store8 i64.store16 i64.store32"
+).split()
+_NUM_NAMES = (
+    "i32.eqz i32.eq i32.ne i32.lt_s i32.lt_u i32.gt_s i32.gt_u i32.le_s i32.le_u i32.ge_s i32.ge_u i64.eqz i64.eq "
+    "i64.ne i64.lt_s i64.lt_u i64.gt_s i64.gt_u i64.le_s i64.le_u i64.ge_s i64.ge_u f32.eq f32.ne f32.lt f32.gt f32.le "
+    "f32.ge f64.eq f64.ne f64.lt f64.gt f64.le f64.ge i32.clz i32.ctz i32.popcnt i32.add i32.sub i32.mul i32.div_s "
+    "i32.div_u i32.rem_s i32.rem_u i32.and i32.or i32.xor i32.shl i32.shr_s i32.shr_u i32.rotl i32.rotr i64.clz "
+    "i64.ctz i64.popcnt i64.add i64.sub i64.mul i64.div_s i64.div_u i64.rem_s i64.rem_u i64.and i64.or i64.xor "
+    "i64.shl i64.shr_s i64.shr_u i64.rotl i64.rotr f32.abs f32.neg f32.ceil f32.floor f32.trunc f32.nearest f32.sqrt "
+    "f32.add f32.sub f32.mul f32.div f32.min f32.max f32.copysign f64.abs f64.neg f64.ceil f64.floor f64.trunc "
+    "f64.nearest f64.sqrt f64.add f64.sub f64.mul f64.div f64.min f64.max f64.copysign i32.wrap_i64 "
+    "i32.trunc_f32_s i32.trunc_f32_u i32.trunc_f64_s i32.trunc_f64_u i64.extend_i32_s i64.extend_i32_u "
+    "i64.trunc_f32_s i64.trunc_f32_u i64.trunc_f64_s i64.trunc_f64_u f32.convert_i32_s f32.convert_i32_u "
+    "f32.convert_i64_s f32.convert_i64_u f32.demote_f64 f64.convert_i32_s f64.convert_i32_u f64.convert_i64_s "
+    "f64.convert_i64_u f64.promote_f32 i32.reinterpret_f32 i64.reinterpret_f64 f32.reinterpret_i32 "
+    "f64.reinterpret_i64 i32.extend8_s i32.extend16_s i64.extend8_s i64.extend16_s i64.extend32_s"
+).split()
+_PREFIX_NAMES = {PREFIX_FC: "fc", PREFIX_FD: "simd", PREFIX_FB: "gc", PREFIX_FE: "atomic"}
+
+# SIMD sub-opcodes by arity (everything else is a binary v128 op).
+_SIMD_UNARY = {
+    *range(0, 11), 15, 16, 17, 18, 19, 20, 21, 22, 24, 25, 27, 29, 31, 33, 77, 83, 92, 93, 94, 95, 96, 97, 98, 99,
+    100, 103, 104, 105, 106, 116, 117, 122, 124, 125, 126, 127, 128, 129, 131, 132, 135, 136, 137, 138, 148, 160,
+    161, 163, 164, 167, 168, 169, 170, 192, 193, 195, 196, 199, 200, 201, 202, 224, 225, 227, 236, 237, 239,
+    *range(248, 256), *range(0x101, 0x105),
+}  # fmt: skip
+_SIMD_TERNARY = {82, *range(0x105, 0x10D), 0x113}
+
+
+def op_name(key: int) -> str:
+    if key <= 0xFF:
+        if key in _MVP_NAMES:
+            return _MVP_NAMES[key]
+        if 0x28 <= key <= 0x3E:
+            return _MEM_NAMES[key - 0x28]
+        if 0x45 <= key <= 0xC4:
+            return _NUM_NAMES[key - 0x45]
+        return f"0x{key:02x}"
+    return f"{_PREFIX_NAMES.get(key >> 12, hex(key >> 12))}.{key & 0xFFF}"
+
+
+def op_class(key: int) -> str:
+    if key > 0xFF:
+        prefix, sub = key >> 12, key & 0xFFF
+        if prefix == PREFIX_FC:
+            return "convert" if sub <= 7 else ("memory" if sub <= 11 else "ref")
+        return {PREFIX_FD: "simd", PREFIX_FB: "ref", PREFIX_FE: "atomic"}.get(prefix, "control")
+    if key in (0x02, 0x03, 0x0B, 0x01):
+        return "structure"
+    if key in (0x10, 0x12, 0x14, 0x15):
+        return "call"
+    if key in (0x11, 0x13):
+        return "call_indirect"
+    if key <= 0x1F and key not in (0x1A, 0x1B, 0x1C):
+        return "control"
+    if key in (0x1A, 0x1B, 0x1C):
+        return "parametric"
+    if 0x20 <= key <= 0x22:
+        return "local"
+    if key in (0x23, 0x24):
+        return "global"
+    if key in (0x25, 0x26) or 0xD0 <= key <= 0xD6:
+        return "ref"
+    if 0x28 <= key <= 0x35:
+        return "load"
+    if 0x36 <= key <= 0x3E:
+        return "store"
+    if key in (0x3F, 0x40):
+        return "memory"
+    if 0x41 <= key <= 0x44:
+        return "const"
+    if 0x5B <= key <= 0x66 or 0x8B <= key <= 0xA6:
+        return "float"
+    if 0xA7 <= key <= 0xBF:
+        return "convert"
+    return "int"
+
+
+_TERMINAL = {0x00, 0x0C, 0x0E, 0x0F, 0x12, 0x13, 0x15, 0x08, 0x09, 0x0A}
+
+
+def stack_effect(key: int, imm: int | None, info: ModuleInfo) -> tuple[int, int]:
+    """(pops, pushes) for non-block instructions; approximate for SIMD lane shapes and GC."""
+
+    if key > 0xFF:
+        prefix, sub = key >> 12, key & 0xFFF
+        if prefix == PREFIX_FC:
+            return (1, 1) if sub <= 7 else {9: (0, 0), 13: (0, 0), 15: (2, 1), 16: (0, 1)}.get(sub, (3, 0))
+        if prefix == PREFIX_FD:
+            if sub == 12:
+                return (0, 1)
+            if sub == 11 or 88 <= sub <= 91:
+                return (2, 0)
+            return (1, 1) if sub in _SIMD_UNARY else ((3, 1) if sub in _SIMD_TERNARY else (2, 1))
+        if prefix == PREFIX_FB:
+            if sub == 0:
+                return (info.struct_fields.get(imm or 0, 0), 1)
+            return {1: (0, 1), 5: (2, 0), 6: (2, 1), 8: (0, 1), 9: (2, 1), 10: (2, 1), 11: (2, 1), 12: (2, 1),
+                    13: (2, 1), 14: (3, 0), 16: (4, 0), 17: (5, 0), 18: (4, 0), 19: (4, 0)}.get(sub, (1, 1))  # fmt: skip
+        if prefix == PREFIX_FE:
+            if sub == 3:
+                return (0, 0)
+            if 0x17 <= sub <= 0x1D:
+                return (2, 0)
+            return (3, 1) if sub in (1, 2) or 0x48 <= sub <= 0x4E else ((1, 1) if 0x10 <= sub <= 0x16 else (2, 1))
+        return (0, 0)
+    if key in (0x10, 0x12):
+        ft = info.types.get(info.func_types[imm]) if imm is not None and imm < len(info.func_types) else None
+        return (len(ft.params), len(ft.results)) if ft else (0, 0)
+    if key in (0x11, 0x13, 0x14, 0x15):
+        ft = info.types.get(imm or 0)
+        return (len(ft.params) + 1, len(ft.results)) if ft else (1, 0)
+    if key in (0x0D, 0x0E, 0x1A, 0x21, 0x24, 0xD6):
+        return (1, 0)
+    if key in (0x1B, 0x1C):
+        return (3, 1)
+    if key in (0x20, 0x23, 0x3F, 0xD0, 0xD2) or 0x41 <= key <= 0x44:
+        return (0, 1)
+    if key == 0x26 or 0x36 <= key <= 0x3E:
+        return (2, 0)
+    if key in (0x46, 0x47) or 0x48 <= key <= 0x4F or 0x51 <= key <= 0x66 or key == 0xD3:
+        return (2, 1)
+    if 0x6A <= key <= 0x78 or 0x7C <= key <= 0x8A or 0x92 <= key <= 0x98 or 0xA0 <= key <= 0xA6:
+        return (2, 1)
+    if key in (0x00, 0x01, 0x0C, 0x0F, 0x0B, 0x05):
+        return (0, 0)
+    return (1, 1)  # tests, unary numerics, conversions, loads, local.tee, memory.grow, table.get, ref tests
+
+
+def _block_arity(imm: int | None, info: ModuleInfo) -> tuple[int, int]:
+    if imm is None:
+        return 0, 0
+    if imm < 0:
+        return 0, 1
+    ft = info.types.get(imm)
+    return (len(ft.params), len(ft.results)) if ft else (0, 0)
+
+
+@dataclass
+class WasmStats:
+    wasm: str
+    size_bytes: int
+    code_bytes: int
+    funcs: int
+    imports: list[str]
+    max_locals: int
+    max_stack: int
+    ops: int
+    op_classes: dict[str, int] = field(default_factory=dict)  # static instruction counts
+    hot_mix: dict[str, float] = field(default_factory=dict)  # loop-weighted share per class (sums to 1)
+    top_ops: dict[str, int] = field(default_factory=dict)
+    static_kind: str = "unknown"
+    runtime_funcs: int = 0  # bodies shared with many other modules (libc, printf); left out of hot_mix and max_*
+
+
+def body_hashes(data: bytes) -> list[str]:
+    """Per defined function, a hash of its instruction stream with call targets masked (they shift per module)."""
+
+    info = read_module(data)
+    out = []
+    for body in info.bodies:
+        _, pos = read_locals(data, body)
+        h = hashlib.sha1()
+        for key, _, imm in iter_ops(data, pos, body[1]):
+            h.update(f"{key}:{'' if key in (0x10, 0x12) else imm};".encode())
+        out.append(h.hexdigest())
+    return out
+
+
+def analyze_bytes(data: bytes, wasm: str = "", runtime: set[str] | None = None) -> WasmStats:
+    """runtime: body hashes (see body_hashes) to count but leave out of hot_mix, max_locals/max_stack and the kind."""
+
+    info = read_module(data)
+    classes: Counter[str] = Counter()
+    hot: Counter[str] = Counter()
+    names: Counter[int] = Counter()
+    max_locals = max_stack = ops = skipped = 0
+    hashes = body_hashes(data) if runtime else []
+    for fi, body in enumerate(info.bodies):
+        is_runtime = bool(runtime) and hashes[fi] in runtime  # type: ignore[operator]
+        skipped += is_runtime
+        decls, pos = read_locals(data, body)
+        ft = info.types.get(info.func_types[info.num_imported_funcs + fi])
+        if not is_runtime:
+            max_locals = max(max_locals, sum(n for n, _ in decls) + (len(ft.params) if ft else 0))
+        # frames: (entry height, params, results, is_loop); height is clamped at the frame entry after
+        # unconditional branches, which is where the polymorphic stack starts.
+        frames = [(0, 0, len(ft.results) if ft else 0, False)]
+        height = loop_level = 0
+        for key, _, imm in iter_ops(data, pos, body[1]):
+            ops += 1
+            names[key] += 1
+            cls = op_class(key)
+            if key in (0x10, 0x12) and imm is not None and imm < info.num_imported_funcs:
+                cls = "host"
+            classes[cls] += 1
+            if not is_runtime:
+                hot[cls] += LOOP_WEIGHT ** min(loop_level, MAX_LOOP_LEVEL)
+            if key in (0x02, 0x03, 0x04, 0x06, 0x1F):
+                params, results = _block_arity(imm, info)
+                height -= 1 if key == 0x04 else 0
+                frames.append((height - params, params, results, key == 0x03))
+                loop_level += key == 0x03
+            elif key in (0x05, 0x07, 0x19):  # else / catch / catch_all restart the frame
+                entry, params, _, _ = frames[-1]
+                height = entry + params
+            elif key in (0x0B, 0x18):  # end / delegate
+                entry, _, results, is_loop = frames.pop() if len(frames) > 1 else frames[-1]
+                height = entry + results
+                loop_level -= is_loop
+            else:
+                pops, pushes = stack_effect(key, imm, info)
+                floor = frames[-1][0]
+                height = max(height - pops, floor) + pushes
+                if key in _TERMINAL:
+                    height = floor
+            if not is_runtime:
+                max_stack = max(max_stack, height)
+    total_hot = sum(hot.values()) or 1.0
+    stats = WasmStats(
+        wasm=wasm,
+        size_bytes=len(data),
+        code_bytes=info.code_section[1] - info.code_section[0],
+        funcs=len(info.bodies),
+        imports=[f"{m}.{n}" for m, n, kind, _ in info.imports if kind == "func"],
+        max_locals=max_locals,
+        max_stack=max_stack,
+        ops=ops,
+        op_classes={c: classes[c] for c in OP_CLASSES if classes[c]},
+        hot_mix={c: hot[c] / total_hot for c in OP_CLASSES if hot[c]},
+        top_ops={op_name(k): n for k, n in names.most_common(16)},
+        runtime_funcs=skipped,
+    )
+    stats.static_kind = static_kind(stats)
+    return stats
+
+
+def analyze_corpus(paths: dict[str, Path], *, shared_fraction: float = 0.25) -> dict[str, WasmStats]:
+    """
+    Analyze {rel: path}. Function bodies that occur in at least shared_fraction of the modules (and at
+    least 3) are treated as runtime code, so the mix reflects each benchmark's own kernels.
+    """
+
+    blobs: dict[str, bytes] = {}
+    for rel, p in sorted(paths.items()):
+        try:
+            blobs[rel] = p.read_bytes()
+        except OSError as e:
+            print(f"warning: {rel}: {e}", file=sys.stderr)
+    seen: Counter[str] = Counter()
+    for rel, data in list(blobs.items()):
+        try:
+            seen.update(set(body_hashes(data)))
+        except ValueError as e:
+            print(f"warning: {rel}: {e}", file=sys.stderr)
+            del blobs[rel]
+    cutoff = max(3, math.ceil(len(blobs) * shared_fraction))
+    runtime = {h for h, n in seen.items() if n >= cutoff}
+    stats = {rel: analyze_bytes(data, rel, runtime) for rel, data in blobs.items()}
+    if len(stats) >= 8:
+        medians = {k: _median([_kind_feature(s, k) for s in stats.values()]) for k in KIND_FEATURES}
+        for s in stats.values():
+            s.static_kind = relative_kind(s, medians)
+    return stats
+
+
+# Feature per bench_kind; relative_kind picks the one furthest above its corpus median. The floor keeps
+# rare classes (a median call share near 0) from turning one stray call into a huge lift.
+KIND_FEATURES = {
+    "call_dense": ("call", "call_indirect"),
+    "memory_dense": ("load", "store", "memory"),
+    "control_flow_dense": ("control", "structure"),
+    "local_dense": ("local", "global"),
+    "operand_stack_dense": ("parametric", "const"),
+    "syscall_dense": ("host",),
+}
+KIND_FLOOR = {
+    "call_dense": 0.04,
+    "memory_dense": 0.08,
+    "control_flow_dense": 0.10,
+    "local_dense": 0.30,
+    "operand_stack_dense": 0.20,
+    "syscall_dense": 0.01,
+}
+KIND_LIFT = 1.5
+
+
+def _median(vals: list[float]) -> float:
+    v = sorted(vals)
+    return (v[(len(v) - 1) // 2] + v[len(v) // 2]) / 2.0 if v else 0.0
+
+
+def _kind_feature(s: WasmStats, kind: str) -> float:
+    share = sum(s.hot_mix.get(c, 0.0) for c in KIND_FEATURES[kind])
+    if kind == "operand_stack_dense":
+        share *= max(1.0, s.max_stack / 8.0)
+    return share
+
+
+def relative_kind(s: WasmStats, medians: dict[str, float]) -> str:
+    """Kind whose feature is at least KIND_LIFT times the corpus median (largest lift wins), else compute_dense."""
+
+    best, best_lift = "compute_dense", KIND_LIFT
+    for kind in KIND_FEATURES:
+        lift = _kind_feature(s, kind) / max(medians[kind], KIND_FLOOR[kind])
+        if lift >= best_lift:
+            best, best_lift = kind, lift
+    return best
+
+
+def static_kind(s: WasmStats) -> str:
+    """
+    bench_kind of a single module from absolute thresholds on the loop-weighted mix (heuristics, checked
+    in order: calls, memory traffic, branches, locals, deep operand stacks, else compute). analyze_corpus
+    replaces it with relative_kind once there are enough modules to take medians over.
+    """
+
+    m = s.hot_mix
+    if m.get("call", 0.0) + m.get("call_indirect", 0.0) >= 0.06:
+        return "call_dense"
+    if m.get("load", 0.0) + m.get("store", 0.0) + m.get("memory", 0.0) >= 0.25:
+        return "memory_dense"
+    if m.get("control", 0.0) >= 0.12:
+        return "control_flow_dense"
+    if m.get("local", 0.0) >= 0.5:
+        return "local_dense"
+    if s.max_stack >= 32 or m.get("parametric", 0.0) >= 0.15:
+        return "operand_stack_dense"
+    return "compute_dense"
+
+
+def _solve(a: list[list[float]], b: list[float]) -> list[float]:
+    """Gaussian elimination with partial pivoting (a is small and, with the ridge term, well-conditioned)."""
+
+    n = len(b)
+    m = [row[:] + [b[i]] for i, row in enumerate(a)]
+    for col in range(n):
+        piv = max(range(col, n), key=lambda r: abs(m[r][col]))
+        m[col], m[piv] = m[piv], m[col]
+        if abs(m[col][col]) < 1e-12:
+            continue
+        for r in range(n):
+            if r != col:
+                f = m[r][col] / m[col][col]
+                for c in range(col, n + 1):
+                    m[r][c] -= f * m[col][c]
+    return [m[i][n] / m[i][i] if abs(m[i][i]) >= 1e-12 else 0.0 for i in range(n)]
+
+
+def fit_class_costs(rows: list[tuple[dict[str, float], float]], classes: list[str], ridge: float) -> tuple[dict[str, float], float]:
+    """
+    Ridge fit of y ~ sum_c w_c * share_c without intercept (shares sum to 1), so exp(w_c) reads as the
+    time ratio of a program made only of class c. Returns ({class: w_c}, r2).
+    """
+
+    xs = [[r[0].get(c, 0.0) for c in classes] for r in rows]
+    ys = [r[1] for r in rows]
+    k = len(classes)
+    ata = [[sum(x[i] * x[j] for x in xs) + (ridge if i == j else 0.0) for j in range(k)] for i in range(k)]
+    aty = [sum(x[i] * y for x, y in zip(xs, ys)) for i in range(k)]
+    w = _solve(ata, aty)
+    mean = sum(ys) / len(ys)
+    ss_tot = sum((y - mean) ** 2 for y in ys)
+    ss_res = sum((y - sum(wi * xi for wi, xi in zip(w, x))) ** 2 for x, y in zip(xs, ys))
+    return dict(zip(classes, w)), (1.0 - ss_res / ss_tot) if ss_tot > 0 else 0.0
+
+
+def regression_report(
+    results: list, stats: dict[str, WasmStats], *, baseline: str, metric: str, min_share: float, ridge: float
+) -> dict[str, object]:
+    from runbench import _metric_value, variant_key
+
+    times: dict[str, dict[str, float]] = {}
+    for r in results:
+        v = _metric_value(r, metric)
+        if r.ok and v and v > 0.0 and math.isfinite(v) and r.wasm in stats:
+            times.setdefault(variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label), {})[r.wasm] = v
+    if baseline not in times:
+        raise SystemExit(f"baseline has no usable results: {baseline}")
+    base = times[baseline]
+
+    mean_share = {c: sum(s.hot_mix.get(c, 0.0) for s in stats.values()) / len(stats) for c in OP_CLASSES}
+    classes = [c for c in OP_CLASSES if mean_share[c] >= min_share] + ["other"]
+
+    def features(s: WasmStats) -> dict[str, float]:
+        f = {c: s.hot_mix.get(c, 0.0) for c in classes[:-1]}
+        f["other"] = max(0.0, 1.0 - sum(f.values()))
+        return f
+
+    report: dict[str, object] = {}
+    for key, per_wasm in sorted(times.items()):
+        if key == baseline:
+            continue
+        rows = [(features(stats[w]), math.log(ms / base[w])) for w, ms in per_wasm.items() if w in base]
+        if len(rows) < 3:
+            continue
+        w, r2 = fit_class_costs(rows, classes, ridge)
+        report[key] = {"n": len(rows), "r2": r2, "class_ratio": {c: math.exp(v) for c, v in w.items()}}
+    return report
+
+
+def _resolve_bench_paths(meta: dict[str, object]) -> dict[str, Path]:
+    root = Path(str(meta.get("root", ".")))
+    out: dict[str, Path] = {}
+    for rel, bm in dict(meta.get("bench_meta", {})).items():  # type: ignore[arg-type]
+        app = bm.get("app") if isinstance(bm, dict) else None
+        out[rel] = Path(app["root"]) / app["wasm"] if app else root / rel
+    return out
+
+
+def _fmt_mix(mix: dict[str, float], top: int = 5) -> str:
+    return ", ".join(f"{c} {v:.2f}" for c, v in sorted(mix.items(), key=lambda t: -t[1])[:top])
+
+
+def main(argv: list[str]) -> int:
+    ap = argparse.ArgumentParser(description="Static opcode-mix analysis and per-engine opcode-class regression")
+    ap.add_argument("--root", action="append", default=[], help="directory of wasm files to analyze (repeatable)")
+    ap.add_argument("--results", default="", help="results.json: analyze its benchmarks and regress time vs opcode mix")
+    ap.add_argument("--baseline", default="", help="variant key the regression is relative to (default: the run's baseline)")
+    ap.add_argument("--metric", choices=["wall", "internal", "auto"], default="auto")
+    ap.add_argument("--min-share", type=float, default=0.02, help="classes below this mean share are folded into 'other'")
+    ap.add_argument("--ridge", type=float, default=0.05, help="ridge penalty toward ratio 1.0 (default: 0.05)")
+    ap.add_argument(
+        "--shared-fraction",
+        type=float,
+        default=0.25,
+        help="function bodies present in at least this share of modules count as runtime code (default: 0.25)",
+    )
+    ap.add_argument("--per-wasm", action="store_true", help="print one line per module")
+    ap.add_argument("--out", default="", help="optional JSON output path")
+    args = ap.parse_args(argv)
+
+    from runbench import classify_bench, find_wasms
+
+    paths: dict[str, Path] = {}
+    payload_meta: dict[str, object] = {}
+    results: list = []
+    if args.results:
+        from plot_results import load_payload
+
+        payload_meta, results, _ = load_payload(Path(args.results))
+        paths = _resolve_bench_paths(payload_meta)
+    for root in args.root:
+        rp = Path(root).resolve()
+        for w in find_wasms(rp):
+            paths[os.path.relpath(w, rp)] = w
+    if not paths:
+        raise SystemExit("nothing to analyze: pass --root and/or --results")
+
+    stats = analyze_corpus(paths, shared_fraction=args.shared_fraction)
+
+    agree = sum(1 for rel, s in stats.items() if classify_bench(rel)[0] == s.static_kind)
+    print("=== Static opcode mix (loop-weighted) ===")
+    print(f"modules {len(stats)}, static kind agrees with name-based kind for {agree}")
+    if args.per_wasm:
+        for rel, s in stats.items():
+            name_kind = classify_bench(rel)[0]
+            print(
+                f"{rel}: funcs {s.funcs} ({s.runtime_funcs} runtime), code {s.code_bytes / 1024:.1f} KiB, ops {s.ops}, max_locals {s.max_locals}, "
+                f"max_stack {s.max_stack}, kind {s.static_kind} (name: {name_kind}); {_fmt_mix(s.hot_mix)}"
+            )
+
+    report: dict[str, object] = {"stats": {rel: asdict(s) for rel, s in stats.items()}}
+    if results:
+        baseline = args.baseline or str(payload_meta.get("baseline", ""))
+        reg = regression_report(
+            results, stats, baseline=baseline, metric=args.metric, min_share=args.min_share, ridge=args.ridge
+        )
+        print(f"\n=== Opcode-class cost vs {baseline} ({args.metric}, time ratio of a pure-class program) ===")
+        for key, fit in reg.items():
+            ratios: dict[str, float] = fit["class_ratio"]  # type: ignore[index,assignment]
+            order = sorted((c for c in ratios if c != "other"), key=lambda c: -ratios[c])
+            print(
+                f"{key}: n {fit['n']}, r2 {fit['r2']:.2f}; slowest: "  # type: ignore[index]
+                + ", ".join(f"{c} x{ratios[c]:.2f}" for c in order[:3])
+                + "; fastest: "
+                + ", ".join(f"{c} x{ratios[c]:.2f}" for c in reversed(order[-3:]))
+            )
+        report["regression"] = {"baseline": baseline, "metric": args.metric, "variants": reg}
+
+    if args.out:
+        out_path = Path(args.out)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        out_path.write_text(json.dumps(report, indent=2), encoding="utf-8")
+        print(f"\nwrote: {out_path}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv[1:]))
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import statistics
+import sys
+from pathlib import Path
+
+from plot_results import load_payload
+from runbench import RunResult, _metric_value, geomean, variant_key
+
+
+def metric_values(results: list[RunResult], metric: str) -> dict[str, dict[str, float]]:
+    """Return {variant_key: {wasm_rel: ms}} for results that produced a usable metric."""
+
+    out: dict[str, dict[str, float]] = {}
+    for r in results:
+        if not r.ok:
+            continue
+        v = _metric_value(r, metric)
+        if v is None or not (v > 0.0 and math.isfinite(v)):
+            continue
+        key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+        out.setdefault(key, {})[r.wasm] = float(v)
+    return out
+
+
+def guest_results(results: list[RunResult]) -> dict[str, dict[str, float]]:
+    """Return {variant_key: {wasm_rel: value}} for guests that printed `Metric: result <value>`."""
+
+    out: dict[str, dict[str, float]] = {}
+    for r in results:
+        if r.ok and "result" in r.guest_metrics:
+            key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+            out.setdefault(key, {})[r.wasm] = float(r.guest_metrics["result"])
+    return out
+
+
+def rel_drift(base: float, new: float) -> float:
+    """|new - base| relative to |base| (absolute when base is 0); inf when either side is not finite."""
+
+    if not (math.isfinite(base) and math.isfinite(new)):
+        return 0.0 if (base == new or (math.isnan(base) and math.isnan(new))) else math.inf
+    if base == new:
+        return 0.0
+    return abs(new - base) / (abs(base) if base != 0.0 else 1.0)
+
+
+def pair(
+    base: list[RunResult], new: list[RunResult], *, metric: str
+) -> dict[str, list[tuple[str, str, float, float]]]:
+    """
+    Pair two runs of the same corpus layout per engine variant.
+
+    Returns {variant_key: [(wasm_rel, bench_kind, base_ms, new_ms), ...]} over the common subset.
+    """
+
+    kinds = {r.wasm: r.bench_kind for r in base}
+    bv = metric_values(base, metric)
+    nv = metric_values(new, metric)
+    paired: dict[str, list[tuple[str, str, float, float]]] = {}
+    for key in sorted(set(bv) & set(nv)):
+        rows = [(w, kinds.get(w, "unknown"), bv[key][w], nv[key][w]) for w in sorted(bv[key]) if w in nv[key]]
+        if rows:
+            paired[key] = rows
+    return paired
+
+
+def main(argv: list[str]) -> int:
+    ap = argparse.ArgumentParser(
+        description=(
+            "Paired report between two u2bench results.json files that ran the same corpus layout "
+            "(e.g. wasm/corpus vs wasm/corpus_mvp_plus). Speedup = base/new, higher means the new build is faster."
+        )
+    )
+    ap.add_argument("--base", required=True, help="baseline results.json (e.g. the MVP corpus run)")
+    ap.add_argument("--new", required=True, help="results.json for the alternative build (e.g. the MVP+ corpus run)")
+    ap.add_argument("--base-label", default="base")
+    ap.add_argument("--new-label", default="new")
+    ap.add_argument("--metric", choices=["wall", "internal", "auto"], default="auto")
+    ap.add_argument("--bench-tag", action="append", default=[], help="only pair benchmarks carrying this tag (repeatable, OR)")
+    ap.add_argument("--per-wasm", action="store_true", help="print every paired benchmark, sorted by speedup")
+    ap.add_argument(
+        "--max-drift",
+        type=float,
+        default=-1.0,
+        help="determinism check: exit 1 if any guest 'result' drifts more than this relative amount (default: report only)",
+    )
+    ap.add_argument("--out", default="", help="optional JSON output path")
+    args = ap.parse_args(argv)
+
+    _, base_results, _ = load_payload(Path(args.base))
+    _, new_results, _ = load_payload(Path(args.new))
+
+    if args.bench_tag:
+        wanted = {t.strip().lower() for t in args.bench_tag if t.strip()}
+        base_results = [r for r in base_results if wanted & set(r.bench_tags)]
+        new_results = [r for r in new_results if r.wasm in {b.wasm for b in base_results}]
+
+    paired = pair(base_results, new_results, metric=args.metric)
+    if not paired:
+        raise SystemExit("no common (variant, wasm) pairs with a valid metric")
+    base_res = guest_results(base_results)
+    new_res = guest_results(new_results)
+    worst_drift = 0.0
+
+    report: dict[str, object] = {
+        "base": args.base,
+        "new": args.new,
+        "base_label": args.base_label,
+        "new_label": args.new_label,
+        "metric": args.metric,
+        "variants": {},
+    }
+
+    print(f"=== Paired speedup {args.base_label} -> {args.new_label} ({args.metric}, base/new, higher is faster) ===")
+    for key, rows in paired.items():
+        speedups = [b / n for _, _, b, n in rows]
+        by_kind: dict[str, list[float]] = {}
+        for (_, kind, b, n) in rows:
+            by_kind.setdefault(kind, []).append(b / n)
+
+        print(
+            f"{key}: common {len(rows)}, geomean {geomean(speedups):.4f}x, "
+            f"median {statistics.median(speedups):.4f}x, max {max(speedups):.4f}x"
+        )
+        for kind in sorted(by_kind):
+            vals = by_kind[kind]
+            print(f"  [{kind}] n {len(vals)}, geomean {geomean(vals):.4f}x")
+
+        # Result drift (speed/accuracy trade): guests that print a `result` checksum on both sides.
+        drift: dict[str, tuple[float, float, float]] = {}
+        for w, _, _, _ in rows:
+            bres = base_res.get(key, {}).get(w)
+            nres = new_res.get(key, {}).get(w)
+            if bres is not None and nres is not None:
+                drift[w] = (bres, nres, rel_drift(bres, nres))
+        if drift:
+            exact = sum(1 for _, _, d in drift.values() if d == 0.0)
+            w_max = max(drift, key=lambda w: drift[w][2])
+            worst_drift = max(worst_drift, drift[w_max][2])
+            print(f"  drift: checked {len(drift)}, bit-exact {exact}, max rel {drift[w_max][2]:.3g} ({w_max})")
+
+        if args.per_wasm:
+            for w, _, b, n in sorted(rows, key=lambda t: t[2] / t[3], reverse=True):
+                d = f", drift {drift[w][2]:.3g}" if w in drift else ""
+                print(f"    {w}: {b:.3f} ms -> {n:.3f} ms ({b / n:.3f}x{d})")
+
+        report["variants"][key] = {  # type: ignore[index]
+            "common": len(rows),
+            "speedup_geomean": geomean(speedups),
+            "speedup_median": statistics.median(speedups),
+            "by_kind": {k: geomean(v) for k, v in sorted(by_kind.items())},
+            "per_wasm": [
+                {
+                    "wasm": w,
+                    "bench_kind": kind,
+                    "base_ms": b,
+                    "new_ms": n,
+                    "speedup": b / n,
+                    **(
+                        {"base_result": drift[w][0], "new_result": drift[w][1], "rel_drift": drift[w][2]}
+                        if w in drift
+                        else {}
+                    ),
+                }
+                for w, kind, b, n in rows
+            ],
+        }
+
+    if args.out:
+        out_path = Path(args.out)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        out_path.write_text(json.dumps(report, indent=2), encoding="utf-8")
+        print(f"\nwrote: {out_path}")
+    if args.max_drift >= 0.0 and worst_drift > args.max_drift:
+        print(f"drift check failed: max rel drift {worst_drift:.3g} > {args.max_drift:g}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv[1:]))
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""
+Native interpreter-dispatch benchmark: builds wasm3_test/internal/tailcall/dispatch_bench.c once per compiler
+config and runs the same synthetic op streams through each dispatch strategy (tailcall with pinned _r0/_fp0,
+tailcall_mem, switch, computed goto). Results use the u2bench results.json layout, so plot_results.py and
+compare_results.py work on them: engine `native`, label = config, runtime = strategy, wasm = `dispatch/<stream>`.
+
+Examples:
+  python3 dispatch_bench.py --out logs/dispatch.json
+  python3 dispatch_bench.py --config "gcc-O2=gcc -O2" --config "clang-O3-native=clang -O3 -march=native" \\
+      --strategy tailcall --strategy switch --iters 2000000 --out logs/dispatch.json
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import shlex
+import shutil
+import subprocess
+import sys
+import time
+from dataclasses import asdict
+from pathlib import Path
+
+from runbench import (
+    EngineVariant,
+    RunResult,
+    extract_guest_metrics,
+    extract_internal_ms,
+    geomean,
+    metric_kind_and_value,
+    run_one,
+    summarize,
+    tail,
+)
+
+REPO = Path(__file__).resolve().parent
+SOURCE = REPO / "wasm3_test" / "internal" / "tailcall" / "dispatch_bench.c"
+STRATEGIES = ("tailcall", "tailcall_mem", "switch", "goto")
+# stream -> bench_kind, matching the corpus kinds so per-kind summaries line up.
+STREAMS = {
+    "alu": "compute_dense",
+    "mem": "memory_dense",
+    "float": "compute_dense",
+    "branchy": "control_flow_dense",
+    "mixed": "compute_dense",
+}
+
+
+def default_configs() -> dict[str, str]:
+    return {f"{cc}-O2": f"{cc} -O2" for cc in ("gcc", "clang") if shutil.which(cc)}
+
+
+def build(label: str, cmd: str, out_dir: Path) -> Path | None:
+    exe = out_dir / label / "dispatch_bench"
+    exe.parent.mkdir(parents=True, exist_ok=True)
+    argv = [*shlex.split(cmd), "-std=gnu11", "-o", str(exe), str(SOURCE)]
+    cp = subprocess.run(argv, capture_output=True, text=True)
+    if cp.returncode != 0:
+        print(f"build failed for {label}: {' '.join(argv)}\n{tail(cp.stderr)}", file=sys.stderr)
+        return None
+    return exe
+
+
+def main(argv: list[str]) -> int:
+    ap = argparse.ArgumentParser(description="Native dispatch-strategy benchmark (see module docstring)")
+    ap.add_argument(
+        "--config",
+        action="append",
+        default=[],
+        help='LABEL=COMPILER FLAGS..., e.g. "gcc-O2=gcc -O2" (repeatable; default: gcc/clang -O2 when present)',
+    )
+    ap.add_argument("--strategy", action="append", choices=STRATEGIES, default=[], help="default: all")
+    ap.add_argument("--stream", action="append", choices=sorted(STREAMS), default=[], help="default: all")
+    ap.add_argument("--body-ops", type=int, default=64, help="ops per loop body (default: 64)")
+    ap.add_argument("--iters", type=int, default=1000000, help="loop iterations (default: 1000000)")
+    ap.add_argument("--repeat", type=int, default=3, help="timed runs per process, best is reported (default: 3)")
+    ap.add_argument("--seed", type=int, default=12345)
+    ap.add_argument("--timeout", type=float, default=60.0)
+    ap.add_argument("--baseline", default="", help="variant key (default: the first config's switch strategy)")
+    ap.add_argument("--build-dir", default=str(REPO / "cache" / "u2bench" / "dispatch"))
+    ap.add_argument("--out", default="logs/dispatch.json")
+    args = ap.parse_args(argv)
+
+    configs: dict[str, str] = {}
+    for spec in args.config:
+        label, sep, cmd = spec.partition("=")
+        if not sep or not label.strip() or not cmd.strip():
+            raise SystemExit(f"--config expects LABEL=COMMAND: {spec}")
+        configs[label.strip()] = cmd.strip()
+    if not configs:
+        configs = default_configs()
+    if not configs:
+        raise SystemExit("no C compiler found: pass --config LABEL=COMMAND")
+    strategies = args.strategy or list(STRATEGIES)
+    streams = args.stream or list(STREAMS)
+
+    variants: list[EngineVariant] = []
+    for label, cmd in configs.items():
+        exe = build(label, cmd, Path(args.build_dir))
+        if exe is not None:
+            variants += [EngineVariant("native", s, "full", str(exe), label, cmd) for s in strategies]
+    if not variants:
+        raise SystemExit("no config built")
+    baseline = args.baseline or next((v.key for v in variants if v.runtime == "switch"), variants[0].key)
+    if not any(v.key == baseline for v in variants):
+        raise SystemExit(f"baseline not present in variants: {baseline}")
+
+    results: list[RunResult] = []
+    for stream in streams:
+        print(f"[{stream}]", flush=True)
+        for v in variants:
+            cmd = [v.bin, v.runtime, stream, str(args.body_ops), str(args.iters), str(args.repeat), str(args.seed)]
+            cp = run_one(cmd, REPO, args.timeout)
+            text = cp.out + "\n" + cp.err
+            internal = extract_internal_ms(text)
+            guest_metrics = extract_guest_metrics(text)
+            metric_kind, metric_ms = metric_kind_and_value(wall_ms=cp.wall_ms, internal_ms=internal, metric="internal")
+            results.append(
+                RunResult(
+                    engine=v.engine,
+                    runtime=v.runtime,
+                    mode=v.mode,
+                    label=v.label,
+                    wasm=f"dispatch/{stream}",
+                    bench_kind=STREAMS[stream],
+                    bench_tags=["dispatch", stream],
+                    ok=cp.rc == 0 and guest_metrics.get("checksum_ok") == 1.0,
+                    rc=cp.rc,
+                    wall_ms=cp.wall_ms,
+                    internal_ms=internal,
+                    metric="internal",
+                    metric_kind=metric_kind,
+                    metric_ms=metric_ms,
+                    stdout_tail=tail(cp.out),
+                    stderr_tail=tail(cp.err),
+                    guest_metrics=guest_metrics,
+                    max_rss_kb=cp.max_rss_kb,
+                )
+            )
+            ns = guest_metrics.get("ns_per_op")
+            print(f"  {v.key}: " + (f"{ns:.3f} ns/op" if ns is not None and results[-1].ok else f"failed (rc {cp.rc})"))
+
+    out_path = Path(args.out)
+    out_path.parent.mkdir(parents=True, exist_ok=True)
+    payload = {
+        "meta": {
+            "root": str(SOURCE.parent),
+            "count_wasm": len(streams),
+            "bench_meta": {f"dispatch/{s}": {"kind": STREAMS[s], "tags": ["dispatch", s]} for s in streams},
+            "variants": [asdict(v) for v in variants],
+            "baseline": baseline,
+            "metric": "internal",
+            "dispatch": {
+                "source": str(SOURCE.relative_to(REPO)),
+                "configs": configs,
+                "body_ops": args.body_ops,
+                "iters": args.iters,
+                "repeat": args.repeat,
+                "seed": args.seed,
+            },
+            "guest_metric_semantics": {
+                "ops": "ops executed (counted by the reference interpreter; br skips make it stream-dependent)",
+                "ns_per_op": "best-of-repeat time / ops",
+                "checksum_ok": "1 when registers, slots and memory match the reference interpreter",
+            },
+            "date_epoch": time.time(),
+            "argv": sys.argv,
+        },
+        "results": [asdict(r) for r in results],
+    }
+    out_path.write_text(json.dumps(payload, indent=2), encoding="utf-8")
+
+    print("\n=== ns/op by strategy (geomean over streams) ===")
+    for v in variants:
+        vals = [r.guest_metrics["ns_per_op"] for r in results if r.ok and r.runtime == v.runtime and r.label == v.label]
+        print(f"{v.key}: {geomean(vals):.3f} ns/op ({1e3 / geomean(vals):.0f} Mops/s)" if vals else f"{v.key}: no valid runs")
+    summ = summarize(results, baseline, metric="internal")
+    print(f"\n=== Ratios vs {baseline} (variant/baseline, lower is faster) ===")
+    for key, r in summ["ratios_vs_baseline"].items():  # type: ignore[union-attr]
+        print(f"{key}: common_ok {r['common_ok']}, geomean {r['ratio_geomean']:.4f}, median {r['ratio_median']:.4f}")
+    print(f"\nwrote: {out_path}")
+    return 0 if all(r.ok for r in results) else 1
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv[1:]))
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""
+Dynamic instruction counting: rewrite WASI modules so they count executed wasm instructions per opcode class
+and print the counts as `Metric:` lines at exit. Run the instrumented tree once (any engine), then hand the
+results to `runbench.py --op-counts` to turn internal_ms into ns/op and Mops/s.
+
+Each basic block (a run of instructions ending at a branch, block boundary or call) adds its per-class
+instruction counts to i64 globals on entry. Calls to `clock_time_get` snapshot the counters, so `ops` covers
+the guest's timed region (first to last clock read, the same span as `Time:`); `ops_all` is the whole run.
+
+Examples:
+  python3 instrument_wasm.py --root wasm/corpus --out-root wasm/corpus_counted
+  python3 runbench.py --add-wasm3 --runtime int --mode full --root wasm/corpus_counted --out logs/opcounts.json
+  python3 runbench.py ... --root wasm/corpus --op-counts logs/opcounts.json
+"""
+
+from __future__ import annotations
+
+import argparse
+import os
+import sys
+from pathlib import Path
+
+from analyze_wasm import OP_CLASSES, op_class
+from wasm import wasm_binary as wb
+from wasm.wasm_binary import iter_ops, read_locals, read_module
+
+_WASI = "wasi_snapshot_preview1"
+_NAMES = 1024  # metric name scratch; print_helpers uses [0, 1024)
+# Basic blocks also end after these (branches on GC/exception ops that op_class files under ref/control).
+_BR_ON = {0xD5, 0xD6, wb.op_key(wb.PREFIX_FB, 24), wb.op_key(wb.PREFIX_FB, 25)}
+_BOUNDARY_CLASSES = {"control", "structure", "call", "call_indirect", "host"}
+
+
+def _import_index(info: wb.ModuleInfo, nm: str) -> int | None:
+    fi = 0
+    for mod, n, kind, _ in info.imports:
+        if kind != "func":
+            continue
+        if mod == _WASI and n == nm:
+            return fi
+        fi += 1
+    return None
+
+
+def _global(init_i64: bool = True) -> bytes:
+    return (bytes([wb.I64, 1, 0x42, 0]) if init_i64 else bytes([wb.I32, 1, 0x41, 0])) + b"\x0b"
+
+
+def _count(g: int, n: int) -> bytes:
+    return wb.code(("global.get", g), ("i64.const", n), "i64.add", ("global.set", g))
+
+
+def instrument(data: bytes) -> bytes:
+    """Instrumented copy of a WASI command module; ValueError when it does not import fd_write or has no memory."""
+
+    info = read_module(data)
+    fd_write = _import_index(info, "fd_write")
+    if fd_write is None:
+        raise ValueError("no wasi fd_write import to report through")
+    if not any(sid == wb.SEC_MEMORY for sid, _, _ in info.sections) and not any(
+        k == "memory" for _, _, k, _ in info.imports
+    ):
+        raise ValueError("no memory")
+    clock = _import_index(info, "clock_time_get")
+    proc_exit = _import_index(info, "proc_exit")
+    start = next((i for n, k, i in info.exports if n == "_start" and k == 0), None)
+    if start is None:
+        raise ValueError("no _start export")
+
+    # First pass: class of every instruction, so only classes that occur get counters.
+    bodies: list[list[tuple[int, int, int, int | None, str]]] = []  # (key, pos, end, imm, class)
+    for body in info.bodies:
+        _, pos = read_locals(data, body)
+        ops = list(iter_ops(data, pos, body[1]))
+        rows = []
+        for i, (key, p, imm) in enumerate(ops):
+            cls = op_class(key)
+            if key in (0x10, 0x12) and imm is not None and imm < info.num_imported_funcs:
+                cls = "host"
+            rows.append((key, p, ops[i + 1][1] if i + 1 < len(ops) else body[1], imm, cls))
+        bodies.append(rows)
+    classes = [c for c in OP_CLASSES if any(r[4] == c for rows in bodies for r in rows)]
+
+    # Globals: per class counter, first and last clock snapshot; then the clock call count.
+    g0 = info.num_globals
+    counter = {c: g0 + 3 * i for i, c in enumerate(classes)}
+    snap0 = {c: g + 1 for c, g in counter.items()}
+    snap1 = {c: g + 2 for c, g in counter.items()}
+    g_clocks = g0 + 3 * len(classes)
+    new_globals = [_global() for _ in range(3 * len(classes))] + [_global(init_i64=False)]
+
+    # Functions appended after the existing ones: print helpers, dump, _start wrapper, then the import hooks.
+    t0 = info.num_types
+    new_types = [
+        wb.functype([wb.I32, wb.I32], []),
+        wb.functype([wb.I64, wb.I32], [wb.I32]),
+        wb.functype([wb.I32, wb.I32, wb.I64], []),
+        wb.functype([], []),
+    ]
+    f0 = len(info.func_types)
+    f_metric, f_dump, f_start = f0 + 2, f0 + 3, f0 + 4
+    new_funcs = [t0, t0 + 1, t0 + 2, t0 + 3, t0 + 3]  # type index per appended function
+    redirect: dict[int, int] = {}  # import -> hook that dumps (proc_exit) or snapshots (clock_time_get) first
+    for imp in (proc_exit, clock):
+        if imp is not None:
+            redirect[imp] = f0 + len(new_funcs)
+            new_funcs.append(info.func_types[imp])
+
+    code_entries = []
+    for body, rows in zip(info.bodies, bodies):
+        locals_end = read_locals(data, body)[1]
+        out = bytearray(data[body[0] : locals_end])
+        i = 0
+        while i < len(rows):
+            j = i
+            while j < len(rows) and not (rows[j][4] in _BOUNDARY_CLASSES or rows[j][0] in _BR_ON):
+                j += 1
+            seg = rows[i : min(j + 1, len(rows))]
+            per: dict[str, int] = {}
+            for r in seg:
+                per[r[4]] = per.get(r[4], 0) + 1
+            for c, n in per.items():
+                out += _count(counter[c], n)
+            for key, p, end, imm, _ in seg:
+                if key in (0x10, 0x12) and imm in redirect:
+                    out += bytes([key]) + wb.uleb(redirect[imm])
+                else:
+                    out += data[p:end]
+            i = j + 1
+        code_entries.append(wb.uleb(len(out)) + bytes(out))
+
+    # dump: "Metric: ops_<class> <n>" per class (timed region when the guest read the clock twice), then totals.
+    timed = wb.code(("global.get", g_clocks), ("i32.const", 2), "i32.ge_u")
+    dump = bytearray()
+    metrics: list[tuple[str, bytes]] = []
+    for c in classes:
+        val = timed + wb.code(("if", wb.I64), ("global.get", snap1[c]), ("global.get", snap0[c]), "i64.sub", "else", ("global.get", counter[c]), "end")
+        dump += val + wb.code(("local.get", 0), "i64.add", ("local.set", 0))
+        dump += wb.code(("global.get", counter[c]), ("local.get", 1), "i64.add", ("local.set", 1))
+        metrics.append((f"ops_{c}", val))
+    metrics += [
+        ("ops", wb.code(("local.get", 0))),
+        ("ops_all", wb.code(("local.get", 1))),
+        ("clock_calls", wb.code(("global.get", g_clocks), "i64.extend_i32_u")),
+    ]
+    for nm, val in metrics:
+        raw = nm.encode("ascii")
+        for k, b in enumerate(raw):
+            dump += wb.code(("i32.const", _NAMES + k), ("i32.const", b), ("i32.store8", 0))
+        dump += wb.code(("i32.const", _NAMES), ("i32.const", len(raw))) + val + wb.code(("call", f_metric))
+    dump += wb.code("end")
+
+    hooks = [
+        *wb.print_helpers(fd_write, f0),
+        wb.func_body(bytes(dump), [(2, wb.I64)]),
+        wb.func_body(wb.code(("call", start), ("call", f_dump), "end")),
+    ]
+    if proc_exit is not None:
+        hooks.append(wb.func_body(wb.code(("call", f_dump), ("local.get", 0), ("call", proc_exit), "end")))
+    if clock is not None:
+        first = b"".join(wb.code(("global.get", counter[c]), ("global.set", snap0[c])) for c in classes)
+        last = b"".join(wb.code(("global.get", counter[c]), ("global.set", snap1[c])) for c in classes)
+        hooks.append(
+            wb.func_body(
+                wb.code(("global.get", g_clocks), "i32.eqz", "if") + first + wb.code("end")
+                + last
+                + wb.code(("global.get", g_clocks), ("i32.const", 1), "i32.add", ("global.set", g_clocks))
+                + wb.code(("local.get", 0), ("local.get", 1), ("local.get", 2), ("call", clock), "end")
+            )
+        )  # fmt: skip
+
+    def extend(payload: bytes, items: list[bytes]) -> bytes:
+        r = wb.Reader(payload, 0)
+        n = r.uleb()
+        return wb.uleb(n + len(items)) + payload[r.pos :] + b"".join(items)
+
+    out = bytearray(wb.MAGIC)
+    have_globals = any(sid == wb.SEC_GLOBAL for sid, _, _ in info.sections)
+    for sid, s, e in info.sections:
+        payload = data[s:e]
+        if sid in (wb.SEC_EXPORT, wb.SEC_START, wb.SEC_ELEM, wb.SEC_DATACOUNT, wb.SEC_CODE, wb.SEC_DATA) and not have_globals:
+            out += wb.section(wb.SEC_GLOBAL, wb.vec(new_globals))
+            have_globals = True
+        if sid == wb.SEC_TYPE:
+            payload = extend(payload, new_types)
+        elif sid == wb.SEC_FUNCTION:
+            payload = extend(payload, [wb.uleb(t) for t in new_funcs])
+        elif sid == wb.SEC_GLOBAL:
+            payload = extend(payload, new_globals)
+        elif sid == wb.SEC_EXPORT:
+            payload = wb.vec(
+                wb.name(n) + bytes([k]) + wb.uleb(f_start if (n == "_start" and k == 0) else i) for n, k, i in info.exports
+            )
+        elif sid == wb.SEC_CODE:
+            payload = wb.vec(code_entries + hooks)
+        out += wb.section(sid, payload)
+    return bytes(out)
+
+
+def main(argv: list[str]) -> int:
+    ap = argparse.ArgumentParser(description="Write op-counting copies of a wasm tree (see module docstring)")
+    ap.add_argument("--root", required=True, help="tree of WASI modules (e.g. wasm/corpus)")
+    ap.add_argument("--out-root", required=True, help="output tree, same relative layout (e.g. wasm/corpus_counted)")
+    ap.add_argument("--force", action="store_true", help="rewrite outputs that are newer than their input")
+    args = ap.parse_args(argv)
+
+    from runbench import find_wasms
+
+    root = Path(args.root).resolve()
+    out_root = Path(args.out_root).resolve()
+    done = skipped = 0
+    for w in find_wasms(root):
+        rel = os.path.relpath(w, root)
+        dst = out_root / rel
+        if not args.force and dst.exists() and dst.stat().st_mtime >= w.stat().st_mtime:
+            continue
+        try:
+            blob = instrument(w.read_bytes())
+        except ValueError as e:
+            print(f"skip {rel}: {e}", file=sys.stderr)
+            skipped += 1
+            continue
+        dst.parent.mkdir(parents=True, exist_ok=True)
+        dst.write_bytes(blob)
+        done += 1
+    print(f"instrumented {done}, skipped {skipped} -> {out_root}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv[1:]))
@@ -10,7 +10,7 @@ import re
 import statistics
 from pathlib import Path
 
-from runbench import EngineVariant, RunResult, summarize, variant_key
+from runbench import EngineVariant, RunResult, largest_step, summarize, threshold_curves, variant_key
 
 
 def load_payload(path: Path) -> tuple[dict[str, object], list[RunResult], list[EngineVariant]]:
@@ -84,6 +84,11 @@ def main(argv: list[str]) -> int:
     ap.add_argument("--plot-out", default="logs/plot.png")
     ap.add_argument("--plot-per-wasm", action="store_true", help="render one plot per wasm benchmark")
     ap.add_argument("--plot-dir", default="logs/plots")
+    ap.add_argument(
+        "--plot-thresholds",
+        action="store_true",
+        help="render ns/iter vs parameter curves for generated minvar/ sweeps into <plot-dir>/thresholds/",
+    )
     args = ap.parse_args(argv)
 
     try:
@@ -254,6 +259,27 @@ def main(argv: list[str]) -> int:
         idx.write_text("\n".join(parts) + "\n", encoding="utf-8")
         print(f"plot-per-wasm: {idx}")
 
+    if args.plot_thresholds:
+        curves = threshold_curves(results, metric)
+        out_dir = Path(args.plot_dir) / "thresholds"
+        out_dir.mkdir(parents=True, exist_ok=True)
+        for stem, per_key in sorted(curves.items()):
+            fig, ax = plt.subplots(figsize=(12, 5))
+            for key, pts in sorted(per_key.items()):
+                line = ax.plot([p for p, _ in pts], [y for _, y in pts], marker=".", label=key)[0]
+                step = largest_step(pts)
+                if step and step[2] >= 1.2:
+                    ax.axvline(step[1], color=line.get_color(), linestyle=":", linewidth=1.0)
+            ax.set_xlabel("parameter (locals / params / stack depth)")
+            ax.set_ylabel(f"{metric} ns per iteration")
+            ax.set_title(f"{stem}  (dotted: largest step >= 1.2x)")
+            ax.legend(loc="upper left", fontsize="small")
+            fig.tight_layout()
+            img = out_dir / (sanitize_artifact_name(stem) + ".png")
+            fig.savefig(img)
+            plt.close(fig)
+        print(f"plot-thresholds: {len(curves)} families under {out_dir}")
+
     return 0
 
 
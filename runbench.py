@@ -2,6 +2,7 @@
 from __future__ import annotations
 
 import argparse
+import fnmatch
 import hashlib
 import html
 import json
@@ -12,8 +13,10 @@ import shutil
 import statistics
 import subprocess
 import sys
+import tempfile
+import threading
 import time
-from dataclasses import asdict, dataclass
+from dataclasses import asdict, dataclass, field
 from pathlib import Path
 from typing import Iterable, NamedTuple
 
@@ -56,6 +59,96 @@ class RunResult:
     metric_ms: float | None
     stdout_tail: str
     stderr_tail: str
+    guest_metrics: dict[str, float] = field(default_factory=dict)
+    output_check: str = ""  # apps only: "pass" or "fail: ..." against the manifest's expected output
+    max_rss_kb: float | None = None  # peak RSS of the engine process (wait4 rusage; None where unavailable)
+    compile_ms: float | None = None  # wasmtime full mode: wall time of the `wasmtime compile` step when it ran
+    clock_biased: bool = False  # internal_ms within CLOCK_BIAS_FACTOR clock reads of this variant's calibration
+    syscalls: dict[str, int] = field(default_factory=dict)  # --strace: per-syscall counts of a separate run
+
+
+@dataclass
+class AppSpec:
+    """
+    One real-world app from an --apps manifest (e.g. wasm/apps/wasi_apps.json).
+
+    wasm/stdin/args/inputs are relative to `root`, which is also the run's working directory.
+    """
+
+    name: str
+    root: Path
+    wasm: str
+    args: list[str] = field(default_factory=list)
+    stdin: str = ""
+    inputs: list[str] = field(default_factory=list)
+    kind: str = "unknown"
+    tags: list[str] = field(default_factory=list)
+    expect_sha1: str = ""  # sha1 of raw stdout
+    expect_pattern: str = ""  # fnmatch pattern over decoded stdout
+    time_pattern: str = ""  # regex with a `value` group; replaces the Time: patterns for this app
+    time_scale_ms: float = 1.0
+    metrics: dict[str, str] = field(default_factory=dict)  # guest_metrics name -> regex with a `value` group
+
+    @property
+    def rel(self) -> str:
+        return f"apps/{self.name}"
+
+
+def load_apps(manifest: Path) -> tuple[list[AppSpec], list[str]]:
+    """Return (apps, warnings); apps whose wasm/stdin/inputs are missing are dropped with a warning."""
+
+    data = json.loads(manifest.read_text(encoding="utf-8"))
+    root = (manifest.parent / str(data.get("root", "."))).resolve()
+    apps: list[AppSpec] = []
+    warnings: list[str] = []
+    for item in data.get("apps", []):
+        time_spec = item.get("time", {})
+        app = AppSpec(
+            name=str(item["name"]),
+            root=root,
+            wasm=str(item["wasm"]),
+            args=[str(a) for a in item.get("args", [])],
+            stdin=str(item.get("stdin", "")),
+            inputs=[str(i) for i in item.get("inputs", [])],
+            kind=str(item.get("kind", "unknown")),
+            tags=sorted({"apps", *(str(t) for t in item.get("tags", []))}),
+            expect_sha1=str(item.get("expect_sha1", "")),
+            expect_pattern=str(item.get("expect_pattern", "")),
+            time_pattern=str(time_spec.get("pattern", "")),
+            time_scale_ms=float(time_spec.get("scale_ms", 1.0)),
+            metrics={str(k): str(v) for k, v in item.get("metrics", {}).items()},
+        )
+        missing = [f for f in [app.wasm, app.stdin, *app.inputs] if f and not (root / f).is_file()]
+        if missing:
+            warnings.append(f"warning: app {app.name} skipped (missing under {root}: {', '.join(missing)})")
+            continue
+        apps.append(app)
+    return apps, warnings
+
+
+def app_internal_ms(app: AppSpec, out: str) -> float | None:
+    if not app.time_pattern:
+        return extract_internal_ms(out)
+    last: float | None = None
+    for m in re.finditer(app.time_pattern, out, re.MULTILINE):
+        last = float(m.group("value")) * app.time_scale_ms
+    return last
+
+
+def app_metrics(app: AppSpec, out: str) -> dict[str, float]:
+    metrics: dict[str, float] = {}
+    for name, pat in app.metrics.items():
+        for m in re.finditer(pat, out, re.MULTILINE):
+            metrics[name] = float(m.group("value"))
+    return metrics
+
+
+def check_app_output(app: AppSpec, cp: "CmdOut") -> str:
+    if app.expect_sha1 and cp.out_sha1 != app.expect_sha1:
+        return f"fail: stdout sha1 {cp.out_sha1}"
+    if app.expect_pattern and not fnmatch.fnmatch(cp.out, app.expect_pattern):
+        return "fail: stdout does not match expect_pattern"
+    return "pass" if (app.expect_sha1 or app.expect_pattern) else ""
 
 
 TIME_PATTERNS: list[re.Pattern[str]] = [
@@ -79,6 +172,102 @@ def extract_internal_ms(out: str) -> float | None:
     return None
 
 
+# Extra guest-reported numbers, one per line: "Metric: <name> <value>" (last occurrence wins).
+METRIC_PATTERN = re.compile(r"^Metric:\s*(?P<name>[A-Za-z0-9_.]+)\s+(?P<value>[-+]?(?:nan|inf|\d+(?:\.\d*)?(?:[eE][-+]?\d+)?))\s*$", re.MULTILINE)
+
+
+def extract_guest_metrics(out: str) -> dict[str, float]:
+    metrics: dict[str, float] = {}
+    for m in METRIC_PATTERN.finditer(out):
+        metrics[m.group("name")] = float(m.group("value"))
+    return metrics
+
+
+def derived_guest_metrics(r: RunResult) -> dict[str, float]:
+    """
+    Views computed from raw guest metrics:
+      - alloc_mops: million allocations per second of guest-timed work (needs allocs + internal_ms)
+      - pause_ratio: worst batch / median batch; ~1 means collection cost is spread evenly
+      - run_ms: large-module tier, wall minus time-to-first-instruction (guest run + exit)
+    """
+
+    m = r.guest_metrics
+    out: dict[str, float] = {}
+    if "ttfi_ms" in m:
+        out["run_ms"] = r.wall_ms - m["ttfi_ms"]
+    if "allocs" in m and r.internal_ms:
+        out["alloc_mops"] = m["allocs"] / r.internal_ms / 1000.0
+    if m.get("batch_p50_us") and "batch_max_us" in m:
+        out["pause_ratio"] = m["batch_max_us"] / m["batch_p50_us"]
+    return out
+
+
+MINVAR_NAME = re.compile(r"^(?P<stem>.+)_(?P<param>\d+)_(?P<iters>\d+)\.wasm$")
+
+
+def threshold_curves(results: list[RunResult], metric: str) -> dict[str, dict[str, list[tuple[int, float]]]]:
+    """
+    {family stem: {variant_key: [(param, ns_per_iter), ...]}} for the generated minvar/ sweeps
+    (`<stem>_<param>_<iters>.wasm`, guest prints `Metric: param` / `Metric: iters`), sorted by param.
+    """
+
+    curves: dict[str, dict[str, list[tuple[int, float]]]] = {}
+    for r in results:
+        m = MINVAR_NAME.match(Path(r.wasm).name)
+        v = _metric_value(r, metric)
+        if not (r.ok and "minvar" in r.bench_tags and m and v and "param" in r.guest_metrics):
+            continue
+        iters = r.guest_metrics.get("iters", float(m.group("iters")))
+        key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+        curves.setdefault(m.group("stem"), {}).setdefault(key, []).append((int(r.guest_metrics["param"]), v * 1e6 / iters))
+    for per_key in curves.values():
+        for pts in per_key.values():
+            pts.sort()
+    return curves
+
+
+def largest_step(points: list[tuple[int, float]]) -> tuple[int, int, float] | None:
+    """(param_before, param_after, ratio) of the biggest relative jump between neighbouring sweep points."""
+
+    steps = [(a[0], b[0], b[1] / a[1]) for a, b in zip(points, points[1:]) if a[1] > 0.0]
+    return max(steps, key=lambda t: t[2]) if steps else None
+
+
+def load_op_counts(path: Path) -> dict[str, dict[str, float]]:
+    """
+    Dynamic op counts per wasm rel from a results.json of an instrument_wasm.py tree: the first ok result that
+    printed `Metric: ops`. Counts are deterministic, so which engine ran it does not matter.
+    """
+
+    payload = json.loads(path.read_text(encoding="utf-8"))
+    counts: dict[str, dict[str, float]] = {}
+    for r in payload.get("results", []):
+        gm = r.get("guest_metrics") or {}
+        if r.get("ok") and "ops" in gm and r.get("wasm") not in counts:
+            counts[r["wasm"]] = {k: float(v) for k, v in gm.items() if k.startswith("ops") or k == "clock_calls"}
+    return counts
+
+
+def op_throughput(
+    results: list[RunResult], counts: dict[str, dict[str, float]], metric: str
+) -> dict[str, dict[str, list[float]]]:
+    """
+    {bench_kind: {variant_key: [ns_per_op, ...]}}. internal_ms is divided by the timed-region count (`ops`),
+    wall_ms by the whole-run count (`ops_all`).
+    """
+
+    out: dict[str, dict[str, list[float]]] = {}
+    for r in results:
+        c = counts.get(r.wasm)
+        kind, v = metric_kind_and_value(wall_ms=r.wall_ms, internal_ms=r.internal_ms, metric=metric)
+        ops = c.get("ops" if kind == "internal" else "ops_all", 0.0) if c else 0.0
+        if not (r.ok and v and ops > 0.0):
+            continue
+        key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+        out.setdefault(r.bench_kind, {}).setdefault(key, []).append(v * 1e6 / ops)
+    return out
+
+
 def tail(s: str, max_chars: int = 800) -> str:
     s = s.strip("\n")
     if len(s) <= max_chars:
@@ -99,25 +288,93 @@ class CmdOut(NamedTuple):
     wall_ms: float
     out: str
     err: str
+    out_sha1: str = ""  # of the raw stdout bytes (binary app output does not survive decode())
+    max_rss_kb: float | None = None
+    spawn_ns: int = 0  # CLOCK_REALTIME just before spawn; pairs with a guest's start_realtime_ns stamp
+    compile_ms: float | None = None  # separate AOT compile step, when one ran
+
+
+STDOUT_MODES = ("pipe", "file", "null")
+STDOUT_FILE_TAIL = 64 * 1024  # bytes of a file-captured stdout kept for Time/Metric parsing
+
 
+def run_one(
+    cmd: list[str], cwd: Path, timeout_s: float, stdin_path: Path | None = None, stdout_mode: str = "pipe"
+) -> CmdOut:
+    """
+    Run cmd to completion (killed after timeout_s, rc 124).
+
+    Reaped with os.wait4 where available so the child's own peak RSS is recorded; getrusage(RUSAGE_CHILDREN)
+    would only give the max over every child so far.
+
+    stdout_mode: "pipe" reads all of stdout into memory; "file" sends it to an unlinked temp file ($TMPDIR) and
+    keeps the last STDOUT_FILE_TAIL bytes (out_sha1 still covers all of it); "null" discards it (out and
+    out_sha1 empty). stderr is always piped.
+    """
 
-def run_one(cmd: list[str], cwd: Path, timeout_s: float) -> CmdOut:
+    stdin = open(stdin_path, "rb") if stdin_path is not None else None
+    sink = None
+    if stdout_mode == "file":
+        sink = tempfile.TemporaryFile(prefix="u2bench_stdout_")
+    elif stdout_mode == "null":
+        sink = open(os.devnull, "wb")
+    spawn_ns = time.time_ns()
     t0 = time.perf_counter()
     try:
-        cp = subprocess.run(
-            cmd,
-            cwd=str(cwd),
-            stdout=subprocess.PIPE,
-            stderr=subprocess.PIPE,
-            text=False,
-            timeout=timeout_s,
-            check=False,
+        p = subprocess.Popen(
+            cmd, cwd=str(cwd), stdin=stdin, stdout=sink if sink is not None else subprocess.PIPE, stderr=subprocess.PIPE
         )
+        bufs: dict[str, bytes] = {}
+        readers = [
+            threading.Thread(target=lambda k, f: bufs.__setitem__(k, f.read()), args=(k, f), daemon=True)
+            for k, f in (("out", p.stdout), ("err", p.stderr))
+            if f is not None
+        ]
+        for t in readers:
+            t.start()
+        timed_out = threading.Event()
+
+        def kill() -> None:
+            timed_out.set()
+            p.kill()
+
+        timer = threading.Timer(timeout_s, kill)
+        timer.start()
+        max_rss_kb: float | None = None
+        try:
+            if hasattr(os, "wait4"):
+                _, status, ru = os.wait4(p.pid, 0)
+                p.returncode = os.waitstatus_to_exitcode(status)
+                # ru_maxrss is KiB on Linux, bytes on macOS.
+                max_rss_kb = ru.ru_maxrss / 1024.0 if sys.platform == "darwin" else float(ru.ru_maxrss)
+            else:
+                p.wait()
+        finally:
+            timer.cancel()
         wall_ms = (time.perf_counter() - t0) * 1000.0
-        return CmdOut(cp.returncode, wall_ms, decode(cp.stdout), decode(cp.stderr))
-    except subprocess.TimeoutExpired as e:
-        wall_ms = (time.perf_counter() - t0) * 1000.0
-        return CmdOut(124, wall_ms, decode(e.stdout), decode(e.stderr))
+        for t in readers:
+            t.join()
+        out_b, err_b = bufs.get("out", b""), bufs.get("err", b"")
+        sha1 = ""
+        if stdout_mode == "file" and sink is not None:
+            h = hashlib.sha1()
+            sink.seek(0)
+            for block in iter(lambda: sink.read(1 << 20), b""):
+                h.update(block)
+            size = sink.tell()
+            sink.seek(max(0, size - STDOUT_FILE_TAIL))
+            out_b = sink.read()
+            sha1 = h.hexdigest()
+        elif stdout_mode == "pipe":
+            sha1 = hashlib.sha1(out_b).hexdigest()
+        if timed_out.is_set():
+            return CmdOut(124, wall_ms, decode(out_b), decode(err_b), spawn_ns=spawn_ns)
+        return CmdOut(p.returncode, wall_ms, decode(out_b), decode(err_b), sha1, max_rss_kb, spawn_ns)
+    finally:
+        if stdin is not None:
+            stdin.close()
+        if sink is not None:
+            sink.close()
 
 
 def geomean(values: Iterable[float]) -> float:
@@ -254,6 +511,34 @@ def detect_wamr_cli_kind(bin_path: str, *, cwd: Path, timeout_s: float = 2.0) ->
     return "minimal"
 
 
+def load_root_features(root: Path) -> list[str]:
+    """Proposals a build_corpus.py profile enabled for the whole tree (from its u2bench_profile.json)."""
+    p = root / "u2bench_profile.json"
+    if not p.is_file():
+        return []
+    try:
+        data = json.loads(p.read_text(encoding="utf-8"))
+    except Exception:
+        return []
+    feats = data.get("features", []) if isinstance(data, dict) else []
+    return [str(f) for f in feats]
+
+
+def load_dir_features(root: Path) -> dict[str, list[str]]:
+    """Per top-level directory proposals (the proposals tree mixes families; see build_corpus.py)."""
+    p = root / "u2bench_profile.json"
+    if not p.is_file():
+        return {}
+    try:
+        data = json.loads(p.read_text(encoding="utf-8"))
+    except Exception:
+        return {}
+    dirs = data.get("dirs", {}) if isinstance(data, dict) else {}
+    if not isinstance(dirs, dict):
+        return {}
+    return {str(d): [str(f) for f in feats] for d, feats in dirs.items() if isinstance(feats, list)}
+
+
 def find_wasms(root: Path) -> list[Path]:
     skip_parts = {".git", "__pycache__", ".venv", "logs", "cache"}
     wasms: list[Path] = []
@@ -302,6 +587,10 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
         if "file_rw" in name or "small_io" in name:
             tags.add("io_dense")
             return ret("io_dense")
+        if "stdout_" in name:
+            tags.add("io_dense")
+            tags.add("stdout")
+            return ret("io_dense")
         if "readv" in name or "writev" in name:
             tags.add("io_dense")
             return ret("io_dense")
@@ -313,6 +602,51 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
             return ret("io_dense")
         return ret("syscall_dense")
 
+    # Post-MVP proposal families under wasm/corpus_proposals/.
+    if rel.startswith("multivalue/"):
+        tags.add("proposal")
+        tags.add("multivalue")
+        if "block_params" in name:
+            tags.add("operand_stack_dense")
+            return ret("control_flow_dense")
+        tags.add("compute_dense")
+        return ret("call_dense")
+    if rel.startswith("reftypes/"):
+        tags.add("proposal")
+        tags.add("reftypes")
+        tags.add("compute_dense")
+        return ret("call_dense")
+    # Generated legacy_minvar_microbenches families under wasm/corpus_minvar/: same names, so the
+    # legacy rules below pick the kind.
+    if rel.startswith("minvar/"):
+        tags.add("minvar")
+
+    # Generated large-module tier under wasm/corpus_large/ (startup/compile scaling; tiny executed subset).
+    if rel.startswith("large/"):
+        tags.add("large_module")
+        return ret("call_dense")
+    # Generated host-call overhead tier under wasm/corpus_hostcall/ (one cheap WASI import in a loop).
+    if rel.startswith("hostcall/"):
+        tags.add("hostcall")
+        return ret("syscall_dense")
+    # Generated memory.grow scaling tier under wasm/corpus_grow/ (grow latency, RSS, access speed after growth).
+    if rel.startswith("grow/"):
+        tags.add("memory_grow")
+        return ret("memory_dense")
+    # Generated instantiate-latency tier under wasm/corpus_instantiate/ (empty _start; wall time is startup).
+    if rel.startswith("instantiate/"):
+        tags.add("instantiate")
+        if name.startswith(("data_", "pages_")):
+            return ret("memory_dense")
+        return ret("call_dense")
+    if rel.startswith("gc/"):
+        tags.add("proposal")
+        tags.add("gc")
+        if "dispatch" in name:
+            return ret("call_dense")
+        tags.add("alloc_dense")
+        return ret("memory_dense")
+
     if rel.startswith("micro/"):
         tags.add("micro")
         if "global_dense" in name:
@@ -361,6 +695,7 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
         if "memory_grow" in name:
             return ret("memory_dense")
         if "malloc" in name or "alloc" in name:
+            tags.add("alloc_dense")
             return ret("memory_dense")
         if "rle_" in name or name.startswith("rle"):
             tags.add("control_flow_dense")
@@ -368,6 +703,14 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
         if "utf8" in name:
             tags.add("control_flow_dense")
             return ret("control_flow_dense")
+        if "compress_" in name:
+            tags.add("control_flow_dense")
+            tags.add("int_dense")
+            return ret("memory_dense")
+        if "regex" in name:
+            tags.add("control_flow_dense")
+            tags.add("memory_dense")
+            return ret("control_flow_dense")
         if "json" in name:
             tags.add("control_flow_dense")
             tags.add("memory_dense")
@@ -412,6 +755,15 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
             tags.add("memory_dense")
             tags.add("control_flow_dense")
             return ("memory_dense", sorted(tags))
+        if "qnn_" in name:
+            tags.add("ml_inference")
+            tags.add("int_dense")
+            return ("compute_dense", sorted(tags))
+        if "transformer" in name:
+            tags.add("ml_inference")
+            tags.add("float_dense")
+            tags.add("memory_dense")
+            return ("compute_dense", sorted(tags))
         if "kalman" in name:
             tags.add("estimation")
             tags.add("iterative_solver")
@@ -713,6 +1065,10 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
         tags.add("int_dense")
         tags.add("memory_dense")
         tags.add("control_flow_dense")
+        if name.startswith("lsm_"):
+            # Storage-engine path: SSTable pwrite/pread mixed with in-memory index work.
+            tags.add("io_dense")
+            tags.add("storage")
         return ("memory_dense", sorted(tags))
 
     if rel.startswith("vm/"):
@@ -770,6 +1126,289 @@ def classify_bench(wasm_rel: str) -> tuple[str, list[str]]:
     return ret("unknown")
 
 
+# Proposals an engine may not implement at all. Benchmarks tagged with one are only run on
+# variants that pass the probe module below; the rest are skipped rather than counted as failures.
+GATED_PROPOSALS = ("gc", "simd128", "relaxed-simd", "reference-types", "bulk-memory")
+
+
+def _wasi_probe(body: bytes, *, extra_types: tuple[bytes, ...] = (), memory: bool = False) -> bytes:
+    """
+    Smallest WASI command whose `_start` runs `body` (WAMR only runs _start for modules importing WASI).
+
+    extra_types go first in the type section; memory adds one 1-page memory; every section stays < 128 bytes
+    (single-byte LEB sizes).
+    """
+
+    def vec(items: list[bytes]) -> bytes:
+        return bytes([len(items)]) + b"".join(items)
+
+    def section(sid: int, payload: bytes) -> bytes:
+        return bytes([sid, len(payload)]) + payload
+
+    def name(s: str) -> bytes:
+        return bytes([len(s)]) + s.encode("ascii")
+
+    n = len(extra_types)
+    types = vec([*extra_types, bytes.fromhex("600000"), bytes.fromhex("60017f00")])
+    imports = vec([name("wasi_snapshot_preview1") + name("proc_exit") + bytes([0x00, n + 1])])
+    funcs = vec([bytes([n])])
+    exports = vec([name("_start") + bytes([0x00, 0x01])])
+    code = vec([bytes([len(body) + 1, 0x00]) + body])
+    return (
+        b"\0asm\x01\0\0\0"
+        + section(1, types)
+        + section(2, imports)
+        + section(3, funcs)
+        + (section(5, vec([bytes([0x00, 0x01])])) if memory else b"")
+        + section(7, exports)
+        + section(10, code)
+    )
+
+
+_V128_ZERO = bytes.fromhex("fd0c") + bytes(16)
+
+PROPOSAL_PROBES: dict[str, bytes] = {
+    # (type (struct (field i32))); struct.new + drop
+    "gc": _wasi_probe(bytes.fromhex("4107fb00001a0b"), extra_types=(bytes.fromhex("5f017f00"),)),
+    # v128.const + drop
+    "simd128": _wasi_probe(_V128_ZERO + bytes.fromhex("1a0b")),
+    # f32x4.relaxed_madd over three v128.const + drop
+    "relaxed-simd": _wasi_probe(_V128_ZERO * 3 + bytes.fromhex("fd85021a0b")),
+    # ref.null func + ref.is_null + drop
+    "reference-types": _wasi_probe(bytes.fromhex("d070d11a0b")),
+    # memory.fill 0 bytes at offset 0
+    "bulk-memory": _wasi_probe(bytes.fromhex("410041004100fc0b000b"), memory=True),
+}
+
+# CLI switches an engine needs before it accepts a proposal (absent = on by default or no switch).
+PROPOSAL_ENGINE_FLAGS: dict[str, dict[str, list[str]]] = {
+    "wasmtime": {"gc": ["-W", "function-references=y,gc=y"], "relaxed-simd": ["-W", "relaxed-simd=y"]},
+    "wasmedge": {"gc": ["--enable-gc"]},
+}
+
+
+def proposal_flags(engine: str, tags: Iterable[str]) -> list[str]:
+    per_engine = PROPOSAL_ENGINE_FLAGS.get(engine, {})
+    flags: list[str] = []
+    for t in sorted(set(tags)):
+        flags.extend(per_engine.get(t, []))
+    return flags
+
+
+def write_proposal_probe(root: Path, proposal: str) -> str:
+    out_dir = root / "cache" / "u2bench" / "probe"
+    out_dir.mkdir(parents=True, exist_ok=True)
+    path = out_dir / f"{proposal}.wasm"
+    path.write_bytes(PROPOSAL_PROBES[proposal])
+    return os.path.relpath(path, root)
+
+
+# A guest-timed region spans roughly one clock_time_get call on top of the work (the rest of the first read
+# plus the second read up to its sample). Regions under this many calls (or clock steps) are flagged.
+CLOCK_BIAS_FACTOR = 100.0
+
+
+def write_clock_probe(root: Path) -> str:
+    from wasm.wasm_binary import clock_calibration_module
+
+    out_dir = root / "cache" / "u2bench" / "probe"
+    out_dir.mkdir(parents=True, exist_ok=True)
+    path = out_dir / "clock_calibration.wasm"
+    path.write_bytes(clock_calibration_module())
+    return os.path.relpath(path, root)
+
+
+def apply_clock_bias(results: list[RunResult], calibration: dict[str, dict[str, float]], *, subtract: bool) -> None:
+    """Flag (and with subtract, correct) internal_ms values that are within CLOCK_BIAS_FACTOR of the clock cost."""
+
+    for r in results:
+        cal = calibration.get(variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label))
+        if not cal or r.internal_ms is None:
+            continue
+        floor_ms = CLOCK_BIAS_FACTOR * max(cal["call_ns"], cal["step_ns"]) / 1e6
+        if r.internal_ms >= floor_ms:
+            continue
+        r.clock_biased = True
+        if subtract:
+            r.internal_ms = max(0.0, r.internal_ms - cal["call_ns"] / 1e6)
+            if r.metric_kind == "internal":
+                r.metric_ms = r.internal_ms
+
+
+# Runs of the empty-module probe per variant; the median is that variant's process startup.
+STARTUP_CALIBRATION_RUNS = 5
+
+
+def write_startup_probe(root: Path) -> str:
+    from wasm.wasm_binary import empty_command_module
+
+    out_dir = root / "cache" / "u2bench" / "probe"
+    out_dir.mkdir(parents=True, exist_ok=True)
+    path = out_dir / "empty_start.wasm"
+    path.write_bytes(empty_command_module())
+    return os.path.relpath(path, root)
+
+
+def apply_startup_calibration(results: list[RunResult], calibration: dict[str, dict[str, float]]) -> None:
+    """net_wall_ms = wall_ms minus the variant's calibrated startup (engine launch + minimal instantiate + exit)."""
+
+    for r in results:
+        cal = calibration.get(variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label))
+        if cal and r.ok:
+            r.guest_metrics["net_wall_ms"] = r.wall_ms - cal["wall_ms"]
+
+
+INSTANTIATE_NAME = re.compile(r"^(?P<dim>.+)_(?P<param>\d+)\.wasm$")
+INSTANTIATE_UNITS = {
+    "data_bytes": "KiB",
+    "data_segments": "1k segments",
+    "pages": "64 pages",
+    "table": "1k entries",
+    "elem": "1k entries",
+    "globals": "1k globals",
+    "imports": "1k imports",
+}
+_INSTANTIATE_UNIT_SIZE = {"data_bytes": 1024, "pages": 64}
+
+
+def instantiate_curves(results: list[RunResult]) -> dict[str, dict[str, list[tuple[int, float]]]]:
+    """{dimension: {variant_key: [(param, net_wall_ms), ...]}} for the instantiate/ tier, sorted by param."""
+
+    curves: dict[str, dict[str, list[tuple[int, float]]]] = {}
+    for r in results:
+        m = INSTANTIATE_NAME.match(Path(r.wasm).name)
+        if not (r.ok and "instantiate" in r.bench_tags and m and "net_wall_ms" in r.guest_metrics):
+            continue
+        key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+        curves.setdefault(m.group("dim"), {}).setdefault(key, []).append((int(m.group("param")), r.guest_metrics["net_wall_ms"]))
+    for per_key in curves.values():
+        for pts in per_key.values():
+            pts.sort()
+    return curves
+
+
+GROW_NAME = re.compile(r"^grow_(?P<step>\d+)p_to(?P<target>\d+)p(?P<touch>_touch)?\.wasm$")
+
+
+def grow_report(results: list[RunResult]) -> list[str]:
+    """
+    One line per grow/ result: grow latency percentiles, RSS, and steady-state access cost relative to the
+    same variant's static_<target>p control (memory allocated up front, never grown).
+    """
+
+    static: dict[tuple[str, int], float] = {}
+    rows: list[tuple[str, str, RunResult]] = []
+    for r in results:
+        if not (r.ok and "memory_grow" in r.bench_tags):
+            continue
+        key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+        gm = r.guest_metrics
+        if gm.get("step_pages") == 0 and "access_ps_per_op" in gm:
+            static[(key, int(gm.get("target_pages", 0)))] = gm["access_ps_per_op"]
+        rows.append((r.wasm, key, r))
+    lines: list[str] = []
+    for wasm, key, r in sorted(rows, key=lambda t: (t[0], t[1])):
+        gm = r.guest_metrics
+        cols = []
+        if "grows" in gm:
+            cols.append(
+                f"{gm['grows']:.0f} grows, p50 {gm.get('grow_ns_p50', 0) / 1e3:.1f} us, p99 {gm.get('grow_ns_p99', 0) / 1e3:.1f} us, "
+                f"max {gm.get('grow_ns_max', 0) / 1e3:.1f} us"
+            )
+            if gm.get("grow_failed"):
+                cols.append(f"FAILED at {gm.get('pages', 0):.0f} pages")
+        if "touch_ns_total" in gm:
+            cols.append(f"touch {gm['touch_ns_total'] / 1e6:.3f} ms")
+        if r.max_rss_kb is not None:
+            cols.append(f"rss {r.max_rss_kb / 1024.0:.1f} MiB")
+        if "access_ps_per_op" in gm:
+            ctrl = static.get((key, int(gm.get("target_pages", 0))))
+            rel = f" (x{gm['access_ps_per_op'] / ctrl:.2f} vs static)" if ctrl and gm.get("step_pages") else ""
+            cols.append(f"access {gm['access_ps_per_op'] / 1e3:.3f} ns/op{rel}")
+        lines.append(f"{wasm} {key}: " + ", ".join(cols))
+    return lines
+
+
+# `strace -c` summary rows: % time, seconds, usecs/call, calls, [errors], syscall
+STRACE_ROW = re.compile(
+    r"^\s*\d+(?:\.\d+)?\s+\d+(?:\.\d+)?\s+\d+\s+(?P<calls>\d+)\s+(?:\d+\s+)?(?P<name>[a-z_][a-z0-9_]*)\s*$", re.MULTILINE
+)
+
+
+def parse_strace_counts(text: str) -> dict[str, int]:
+    return {m.group("name"): int(m.group("calls")) for m in STRACE_ROW.finditer(text) if m.group("name") != "total"}
+
+
+def count_syscalls(strace: str, cmd: list[str], cwd: Path, timeout_s: float) -> dict[str, int] | None:
+    """Syscall counts of one extra run of cmd under `strace -f -c` (its timing is discarded); None if it failed."""
+
+    fd, path = tempfile.mkstemp(prefix="u2bench_strace_", suffix=".txt")
+    os.close(fd)
+    try:
+        cp = run_one([strace, "-f", "-c", "-qq", "-o", path, *cmd], cwd, timeout_s * 4)
+        counts = parse_strace_counts(Path(path).read_text(encoding="utf-8", errors="replace"))
+    finally:
+        os.unlink(path)
+    return counts if cp.rc == 0 and counts else None
+
+
+HOSTCALL_NAME = re.compile(r"^(?P<stem>[a-z_]+?)_(?:p|iov)?(?P<n>\d+)b?\.wasm$")
+
+
+def _linear_fit(points: list[tuple[float, float]]) -> tuple[float, float] | None:
+    """(intercept, slope) by least squares; None with fewer than two distinct x."""
+
+    if len({x for x, _ in points}) < 2:
+        return None
+    mx = statistics.fmean(x for x, _ in points)
+    my = statistics.fmean(y for _, y in points)
+    slope = sum((x - mx) * (y - my) for x, y in points) / sum((x - mx) ** 2 for x, _ in points)
+    return my - slope * mx, slope
+
+
+def hostcall_breakdown(results: list[RunResult]) -> dict[str, dict[str, float]]:
+    """
+    Per variant, from the hostcall/ tier (internal_ms / calls):
+      transition_ns: cheapest call that does no syscall (clock_res_get / args_sizes_get; with --strace, any call
+        under 0.5 syscalls per call)
+      per_ptr_ns: args_sizes_get (2 pointers) minus clock_res_get (1 pointer)
+      fd_write_base_ns / per_iovec_ns: fit of fd_write ns/call over iovec counts >= 1
+      pwrite_base_ns / per_kib_ns: fit of fd_pwrite ns/call over buffer sizes
+      syscall_ns: sched_yield (one trivial syscall) minus transition_ns
+    """
+
+    per: dict[str, dict[str, list[tuple[int, float, float | None]]]] = {}
+    for r in results:
+        m = HOSTCALL_NAME.match(Path(r.wasm).name)
+        calls = r.guest_metrics.get("calls", 0.0)
+        if not (r.ok and "hostcall" in r.bench_tags and m and r.internal_ms and calls > 0):
+            continue
+        key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+        sc = sum(r.syscalls.values()) / calls if r.syscalls else None
+        per.setdefault(key, {}).setdefault(m.group("stem"), []).append((int(m.group("n")), r.internal_ms * 1e6 / calls, sc))
+
+    out: dict[str, dict[str, float]] = {}
+    for key, stems in per.items():
+        b: dict[str, float] = {}
+        one = {stem: pts[0][1] for stem, pts in stems.items()}
+        quiet = [ns for pts in stems.values() for _, ns, sc in pts if sc is not None and sc < 0.5]
+        cheap = [one[s] for s in ("clock_res_get", "args_sizes_get") if s in one]
+        if quiet or cheap:
+            b["transition_ns"] = min(quiet or cheap)
+        if "clock_res_get" in one and "args_sizes_get" in one:
+            b["per_ptr_ns"] = one["args_sizes_get"] - one["clock_res_get"]
+        fit = _linear_fit([(n, ns) for n, ns, _ in stems.get("fd_write", []) if n >= 1])
+        if fit:
+            b["fd_write_base_ns"], b["per_iovec_ns"] = fit
+        fit = _linear_fit([(n / 1024.0, ns) for n, ns, _ in stems.get("fd_pwrite", [])])
+        if fit:
+            b["pwrite_base_ns"], b["per_kib_ns"] = fit
+        if "sched_yield" in one and "transition_ns" in b:
+            b["syscall_ns"] = one["sched_yield"] - b["transition_ns"]
+        out[key] = b
+    return out
+
+
 def wasm3_cmd(bin_path: str, wasm_rel: str, mode: str) -> list[str]:
     cmd = [bin_path]
     if mode == "full":
@@ -805,21 +1444,21 @@ def wamr_cmd_with_cli(bin_path: str, wasm_rel: str, cli: str) -> list[str]:
     return [bin_path, "--dir=.", wasm_rel]
 
 
-def wasmtime_cmd(bin_path: str, wasm_rel: str) -> list[str]:
-    return [bin_path, "run", "--dir", ".", wasm_rel]
+def wasmtime_cmd(bin_path: str, wasm_rel: str, flags: list[str] | None = None) -> list[str]:
+    return [bin_path, "run", *(flags or []), "--dir", ".", wasm_rel]
 
 
 def wasmer_cmd(bin_path: str, wasm_rel: str) -> list[str]:
     return [bin_path, "run", "--dir", ".", wasm_rel]
 
 
-def wasmedge_cmd(bin_path: str, wasm_rel: str, runtime: str) -> list[str]:
+def wasmedge_cmd(bin_path: str, wasm_rel: str, runtime: str, flags: list[str] | None = None) -> list[str]:
     # WasmEdge uses guest:host mapping; ".:." is safe (same either way).
-    cmd = [bin_path, "--dir", ".:.", wasm_rel]
+    flags = flags or []
     if runtime == "jit":
-        return [bin_path, "--enable-jit", "--dir", ".:.", wasm_rel]
+        return [bin_path, "--enable-jit", *flags, "--dir", ".:.", wasm_rel]
     if runtime == "int":
-        return [bin_path, "--force-interpreter", "--dir", ".:.", wasm_rel]
+        return [bin_path, "--force-interpreter", *flags, "--dir", ".:.", wasm_rel]
     raise ValueError(f"unsupported wasmedge runtime: {runtime}")
 
 
@@ -879,7 +1518,23 @@ def supported_variants(
     return variants
 
 
-def build_cmd(variant: EngineVariant, wasm_rel: str) -> list[str]:
+def build_cmd(
+    variant: EngineVariant, wasm_rel: str, flags: list[str] | None = None, guest_args: list[str] | None = None
+) -> list[str]:
+    """
+    flags: engine switches from proposal_flags(); only engines listed in PROPOSAL_ENGINE_FLAGS get any.
+    guest_args: argv passed to the wasm after its path (apps suite).
+    """
+    cmd = _engine_cmd(variant, wasm_rel, flags)
+    if guest_args:
+        if variant.engine == "wasmer":
+            # wasmer parses anything after the module as its own options unless separated.
+            cmd.append("--")
+        cmd.extend(guest_args)
+    return cmd
+
+
+def _engine_cmd(variant: EngineVariant, wasm_rel: str, flags: list[str] | None) -> list[str]:
     eng = variant.engine
     if eng == "wasm3":
         return wasm3_cmd(variant.bin, wasm_rel, variant.mode)
@@ -891,12 +1546,12 @@ def build_cmd(variant: EngineVariant, wasm_rel: str) -> list[str]:
         # "full" is handled specially (precompile+run) in the main loop.
         # For "lazy", run the wasm directly.
         if variant.mode == "lazy":
-            return wasmtime_cmd(variant.bin, wasm_rel)
-        return [variant.bin, "run", "--dir", ".", wasm_rel]
+            return wasmtime_cmd(variant.bin, wasm_rel, flags)
+        return [variant.bin, "run", *(flags or []), "--dir", ".", wasm_rel]
     if eng == "wasmer":
         return wasmer_cmd(variant.bin, wasm_rel)
     if eng == "wasmedge":
-        return wasmedge_cmd(variant.bin, wasm_rel, variant.runtime)
+        return wasmedge_cmd(variant.bin, wasm_rel, variant.runtime, flags)
     if eng == "wavm":
         return wavm_cmd(variant.bin, wasm_rel)
     raise ValueError(f"unknown engine: {eng}")
@@ -1005,16 +1660,29 @@ def wasmtime_precompile_path(root: Path, wasm_rel: str, *, bin_path: str) -> Pat
     return out_dir / f"{h}.cwasm"
 
 
-def run_wasmtime_full(bin_path: str, *, root: Path, wasm_rel: str, timeout_s: float) -> CmdOut:
+def run_wasmtime_full(
+    bin_path: str,
+    *,
+    root: Path,
+    wasm_rel: str,
+    timeout_s: float,
+    flags: list[str] | None = None,
+    guest_args: list[str] | None = None,
+    stdin_path: Path | None = None,
+    stdout_mode: str = "pipe",
+) -> CmdOut:
     out_path = wasmtime_precompile_path(root, wasm_rel, bin_path=bin_path)
-    compile_cmd = [bin_path, "compile", wasm_rel, "-o", str(out_path)]
-    run_cmd = [bin_path, "run", "--allow-precompiled", "--dir", ".", str(out_path)]
+    # Precompiled artifacts record the enabled proposals, so compile and run must agree on flags.
+    flags = flags or []
+    compile_cmd = [bin_path, "compile", *flags, wasm_rel, "-o", str(out_path)]
+    run_cmd = [bin_path, "run", *flags, "--allow-precompiled", "--dir", ".", str(out_path), *(guest_args or [])]
 
     # Compile if missing.
     compile_wall_ms = 0.0
     compile_out = ""
     compile_err = ""
-    if not out_path.exists():
+    compile_cmd_ran = not out_path.exists()
+    if compile_cmd_ran:
         cp_c = run_one(compile_cmd, root, timeout_s)
         compile_wall_ms = cp_c.wall_ms
         compile_out = cp_c.out
@@ -1022,12 +1690,16 @@ def run_wasmtime_full(bin_path: str, *, root: Path, wasm_rel: str, timeout_s: fl
         if cp_c.rc != 0:
             return cp_c
 
-    cp_r = run_one(run_cmd, root, timeout_s)
+    cp_r = run_one(run_cmd, root, timeout_s, stdin_path, stdout_mode)
     return CmdOut(
         cp_r.rc,
         compile_wall_ms + cp_r.wall_ms,
         cp_r.out,
         (compile_out + "\n" + compile_err + "\n" + cp_r.err).strip("\n"),
+        cp_r.out_sha1,
+        cp_r.max_rss_kb,
+        cp_r.spawn_ns,
+        compile_wall_ms if compile_cmd_ran else None,
     )
 
 
@@ -1056,7 +1728,17 @@ def main(argv: list[str]) -> int:
     ap.add_argument("--mode", action="append", choices=["full", "lazy"], default=[])
 
     # Corpus
-    ap.add_argument("--root", default="wasm/corpus", help="directory to scan for wasm files (relative to CWD ok)")
+    ap.add_argument(
+        "--root",
+        default="wasm/corpus",
+        help="directory to scan for wasm files (relative to CWD ok); empty string to run only --apps",
+    )
+    ap.add_argument(
+        "--apps",
+        action="append",
+        default=[],
+        help="app manifest to run alongside --root (repeatable), e.g. wasm/apps/wasi_apps.json; results appear as apps/<name>",
+    )
     ap.add_argument("--timeout", type=float, default=25.0, help="timeout per run (seconds)")
     ap.add_argument("--max-wasm", type=int, default=0, help="limit number of wasm files (0 = all)")
     ap.add_argument(
@@ -1082,6 +1764,15 @@ def main(argv: list[str]) -> int:
         default=[],
         help="filter wasm corpus by tag (repeatable; OR semantics, e.g. --bench-tag crypto --bench-tag syscall_dense)",
     )
+    ap.add_argument(
+        "--classify",
+        choices=["name", "static"],
+        default="name",
+        help=(
+            "bench kind source: corpus path/name rules (default) or the static opcode mix from analyze_wasm.py; "
+            "static keeps the name-based kind in meta.benchmarks[].name_kind"
+        ),
+    )
 
     # Output
     ap.add_argument("--out", default="logs/results.json")
@@ -1093,6 +1784,46 @@ def main(argv: list[str]) -> int:
         help="metric for summary/ratios/plot: wall, internal (wasm-reported Time: .. ms), or auto (prefer internal, else wall)",
     )
 
+    ap.add_argument(
+        "--no-clock-calibration",
+        dest="clock_calibration",
+        action="store_false",
+        help="skip the per-variant clock_time_get cost / resolution probe",
+    )
+    ap.add_argument(
+        "--no-startup-calibration",
+        dest="startup_calibration",
+        action="store_false",
+        help=f"skip the per-variant empty-module startup probe ({STARTUP_CALIBRATION_RUNS} runs; gives net_wall_ms)",
+    )
+    ap.add_argument(
+        "--clock-bias",
+        choices=["flag", "subtract"],
+        default="flag",
+        help=f"internal_ms under {CLOCK_BIAS_FACTOR:g}x the calibrated clock cost: flag it, or also subtract one clock read",
+    )
+    ap.add_argument(
+        "--op-counts",
+        default="",
+        help="results.json of a run over an instrument_wasm.py tree; adds ns/op and Mops/s per bench kind",
+    )
+    ap.add_argument(
+        "--stdout",
+        choices=STDOUT_MODES,
+        default="pipe",
+        help=(
+            "engine stdout during benchmark runs: pipe (read into memory), file (temp file, last "
+            f"{STDOUT_FILE_TAIL // 1024} KiB kept) or null (/dev/null; only stderr is parsed, app output checks are skipped)"
+        ),
+    )
+    ap.add_argument(
+        "--strace",
+        nargs="?",
+        const="strace",
+        default="",
+        help="run every benchmark once more under `strace -f -c` (optionally a path to strace) and record syscall counts",
+    )
+
     # Plot
     ap.add_argument("--plot", action="store_true", help="render a bar chart (requires matplotlib)")
     ap.add_argument("--plot-out", default="logs/plot.png")
@@ -1118,17 +1849,61 @@ def main(argv: list[str]) -> int:
     if not args.mode:
         raise SystemExit("no mode selected: pass at least one --mode={full,lazy}")
 
-    root = Path(args.root).resolve()
-    if not root.is_dir():
-        raise SystemExit(f"root not found: {root}")
-
-    wasms = find_wasms(root)
+    apps: list[AppSpec] = []
+    warnings: list[str] = []
+    for manifest in args.apps:
+        loaded, app_warnings = load_apps(Path(manifest))
+        apps.extend(loaded)
+        warnings.extend(app_warnings)
+    apps_by_rel = {a.rel: a for a in apps}
+    op_counts = load_op_counts(Path(args.op_counts)) if args.op_counts else {}
+
+    if args.root:
+        root = Path(args.root).resolve()
+        if not root.is_dir():
+            raise SystemExit(f"root not found: {root}")
+        wasms = find_wasms(root)
+    elif apps:
+        # Apps-only run: probes and caches live under the first manifest's root.
+        root = apps[0].root
+        wasms = []
+    else:
+        raise SystemExit("empty --root needs at least one --apps manifest")
+    # Profile trees (e.g. relaxed-simd) tag every benchmark with the proposals they were built with,
+    # so the gated-proposal probe below covers them too.
+    root_features = load_root_features(root)
+    dir_features = load_dir_features(root)
     # Pre-classify for filtering and reporting.
     wasm_items: list[tuple[Path, str, str, list[str]]] = []
     for w in wasms:
         rel = os.path.relpath(w, root)
         kind, tags = classify_bench(rel)
+        extra = set(root_features) | set(dir_features.get(Path(rel).parts[0], []))
+        if extra:
+            tags = sorted(set(tags) | extra)
         wasm_items.append((w, rel, kind, tags))
+    static_meta: dict[str, dict[str, object]] = {}
+    if args.classify == "static" and wasm_items:
+        from analyze_wasm import analyze_corpus
+
+        stats = analyze_corpus({rel: w for w, rel, _, _ in wasm_items})
+        for i, (w, rel, kind, tags) in enumerate(wasm_items):
+            st = stats.get(rel)
+            if st is None:
+                continue
+            wasm_items[i] = (w, rel, st.static_kind, tags)
+            static_meta[rel] = {
+                "name_kind": kind,
+                "static": {
+                    "funcs": st.funcs,
+                    "code_bytes": st.code_bytes,
+                    "max_locals": st.max_locals,
+                    "max_stack": st.max_stack,
+                    "hot_mix": {c: round(v, 4) for c, v in st.hot_mix.items()},
+                },
+            }
+    for a in apps:
+        wasm_items.append((a.root / a.wasm, a.rel, a.kind, a.tags))
 
     if args.bench_kind:
         keep_kinds = set(args.bench_kind)
@@ -1137,20 +1912,33 @@ def main(argv: list[str]) -> int:
         wanted = {t.strip().lower() for t in args.bench_tag if t.strip()}
         if wanted:
             wasm_items = [it for it in wasm_items if wanted & set(it[3])]
+    if args.stdout == "pipe" and "stdout" not in {t.strip().lower() for t in args.bench_tag}:
+        # The stdout_* guests each push 64 MiB through the pipe into memory; they run under --stdout file|null,
+        # or in pipe mode only when asked for with --bench-tag stdout.
+        n_stdout = sum(1 for it in wasm_items if "stdout" in it[3])
+        if n_stdout:
+            wasm_items = [it for it in wasm_items if "stdout" not in it[3]]
+            warnings.append(f"--stdout pipe: {n_stdout} stdout throughput guests skipped (use --stdout file|null)")
 
     if args.max_wasm and args.max_wasm > 0:
         wasm_items = wasm_items[: args.max_wasm]
 
     wasms = [it[0] for it in wasm_items]
-    bench_meta: dict[str, dict[str, object]] = {it[1]: {"kind": it[2], "tags": it[3]} for it in wasm_items}
+    bench_meta: dict[str, dict[str, object]] = {
+        it[1]: {"kind": it[2], "tags": it[3], "size_bytes": it[0].stat().st_size, **static_meta.get(it[1], {})}
+        for it in wasm_items
+    }
+    for rel, bm in bench_meta.items():
+        if rel in apps_by_rel:
+            a = apps_by_rel[rel]
+            bm["app"] = {"root": str(a.root), "wasm": a.wasm, "args": a.args, "stdin": a.stdin}
     if not wasms:
         raise SystemExit(f"no wasm files found under: {root}")
-    probe_rel = os.path.relpath(wasms[0], root)
+    probe_cwd, probe_rel = (wasms[0].parent, wasms[0].name)
 
     # Resolve binaries (each engine can have multiple bins, e.g. two uwvm2 builds).
     bins: dict[str, list[tuple[str, str]]] = {}
     wamr_cli_by_bin: dict[str, str] = {}
-    warnings: list[str] = []
 
     if args.add_wasm3:
         entries = resolve_bin_entries(engine="wasm3", specs=args.wasm3_bin, default_cmd="wasm3")
@@ -1223,7 +2011,7 @@ def main(argv: list[str]) -> int:
             kept.append(v)
             continue
 
-        cp = run_one(build_cmd(v, probe_rel), root, min(args.timeout, 10.0))
+        cp = run_one(build_cmd(v, probe_rel), probe_cwd, min(args.timeout, 10.0))
         msg = (cp.out + "\n" + cp.err).lower()
         if cp.rc != 0 and "not currently supported" in msg:
             pruned.append(v.key)
@@ -1234,8 +2022,57 @@ def main(argv: list[str]) -> int:
     if not variants:
         raise SystemExit("no runnable engine variants after applying --runtime/--mode filters")
 
+    # Preflight: probe gated proposals that the selected benchmarks need.
+    needed = sorted({p for it in wasm_items for p in GATED_PROPOSALS if p in it[3]})
+    unsupported: dict[str, list[str]] = {}
+    for p in needed:
+        probe_wasm = write_proposal_probe(root, p)
+        for v in variants:
+            cp = run_one(build_cmd(v, probe_wasm, proposal_flags(v.engine, [p])), root, min(args.timeout, 10.0))
+            if cp.rc != 0:
+                unsupported.setdefault(v.key, []).append(p)
+
+    # Preflight: cost and effective resolution of the guest clock, per variant (see CLOCK_BIAS_FACTOR).
+    clock_cal: dict[str, dict[str, float]] = {}
+    if args.clock_calibration:
+        clock_probe = write_clock_probe(root)
+        for v in variants:
+            cp = run_one(build_cmd(v, clock_probe), root, min(args.timeout, 30.0))
+            m = extract_guest_metrics(cp.out + "\n" + cp.err)
+            if cp.rc == 0 and "clock_call_ps" in m:
+                clock_cal[v.key] = {
+                    "call_ns": m["clock_call_ps"] / 1000.0,
+                    "res_ns": m.get("clock_res_ns", 0.0),
+                    "step_ns": m.get("clock_step_ns", 0.0),
+                    "zero_steps": m.get("clock_zero_steps", 0.0),
+                }
+            else:
+                warnings.append(f"clock calibration failed for {v.key} (rc {cp.rc}); its timings are not bias-checked")
+
+    # Preflight: process startup per variant (launch, instantiate an empty module, exit), for net_wall_ms.
+    startup_cal: dict[str, dict[str, float]] = {}
+    if args.startup_calibration:
+        startup_probe = write_startup_probe(root)
+        for v in variants:
+            walls = []
+            for _ in range(STARTUP_CALIBRATION_RUNS):
+                cp = run_one(build_cmd(v, startup_probe), root, min(args.timeout, 10.0))
+                if cp.rc != 0:
+                    break
+                walls.append(cp.wall_ms)
+            if len(walls) == STARTUP_CALIBRATION_RUNS:
+                startup_cal[v.key] = {"wall_ms": statistics.median(walls), "min_ms": min(walls), "max_ms": max(walls)}
+            else:
+                warnings.append(f"startup calibration failed for {v.key} (rc {cp.rc}); no net_wall_ms for it")
+
+    strace = ""
+    if args.strace:
+        strace = which_or(None, args.strace) or ""
+        if not strace:
+            warnings.append(f"--strace: {args.strace} not found; syscall counts are skipped")
+
     print(f"root: {root}")
-    print(f"wasm files: {len(wasms)}")
+    print(f"wasm files: {len(wasms)}" + (f" (apps: {sum(1 for it in wasm_items if it[1] in apps_by_rel)})" if apps else ""))
     print("variants:")
     for v in variants:
         print(f"  - {v.key}  ({v.bin})")
@@ -1245,6 +2082,8 @@ def main(argv: list[str]) -> int:
         print("skipped engines (no supported variants for current filters): " + ", ".join(skipped))
     if pruned:
         print("pruned variants (engine reported unsupported): " + ", ".join(pruned))
+    for key, props in unsupported.items():
+        print(f"proposal probe failed: {key} lacks {', '.join(props)}; those benchmarks are skipped for it")
     print("", flush=True)
 
     baseline = args.baseline
@@ -1255,28 +2094,59 @@ def main(argv: list[str]) -> int:
         raise SystemExit(f"baseline not present in variants: {baseline}")
 
     results: list[RunResult] = []
+    skipped_runs: list[dict[str, str]] = []
 
     total_runs = len(wasms) * len(variants)
     run_idx = 0
-    for wasm_idx, wasm in enumerate(wasms, start=1):
-        rel = os.path.relpath(wasm, root)
+    for wasm_idx, (_, rel, _, _) in enumerate(wasm_items, start=1):
         print(f"[{wasm_idx}/{len(wasms)}] {rel}", flush=True)
+        app = apps_by_rel.get(rel)
+        cwd = app.root if app else root
+        run_rel = app.wasm if app else rel
+        guest_args = app.args if app else []
+        stdin_path = (app.root / app.stdin) if app and app.stdin else None
+        bm = bench_meta.get(rel)
+        if bm:
+            bench_kind = str(bm["kind"])
+            bench_tags = list(bm["tags"])  # type: ignore[arg-type]
+        else:
+            bench_kind, bench_tags = classify_bench(rel)
         for v in variants:
             run_idx += 1
-            cmd = build_cmd(v, rel)
+            missing = [p for p in unsupported.get(v.key, []) if p in bench_tags]
+            if missing:
+                skipped_runs.append({"variant": v.key, "wasm": rel, "reason": "unsupported proposal: " + ",".join(missing)})
+                continue
+            flags = proposal_flags(v.engine, bench_tags)
+            cmd = build_cmd(v, run_rel, flags, guest_args)
             if v.engine == "wasmtime" and v.mode == "full":
-                cp = run_wasmtime_full(v.bin, root=root, wasm_rel=rel, timeout_s=args.timeout)
+                cp = run_wasmtime_full(
+                    v.bin,
+                    root=cwd,
+                    wasm_rel=run_rel,
+                    timeout_s=args.timeout,
+                    flags=flags,
+                    guest_args=guest_args,
+                    stdin_path=stdin_path,
+                    stdout_mode=args.stdout,
+                )
             else:
-                cp = run_one(cmd, root, args.timeout)
-
-            internal = extract_internal_ms(cp.out + "\n" + cp.err)
-            metric_kind, metric_ms = metric_kind_and_value(wall_ms=cp.wall_ms, internal_ms=internal, metric=args.metric)
-            bm = bench_meta.get(rel)
-            if bm:
-                bench_kind = str(bm["kind"])
-                bench_tags = list(bm["tags"])  # type: ignore[arg-type]
+                cp = run_one(cmd, cwd, args.timeout, stdin_path, args.stdout)
+
+            text = cp.out + "\n" + cp.err
+            guest_metrics = extract_guest_metrics(text)
+            start_ns = guest_metrics.pop("start_realtime_ns", None)
+            if start_ns is not None and cp.spawn_ns:
+                # Host and guest both read CLOCK_REALTIME, so the difference is spawn -> first guest instruction.
+                guest_metrics["ttfi_ms"] = (start_ns - cp.spawn_ns) / 1e6
+            output_check = ""
+            if app:
+                internal = app_internal_ms(app, text)
+                guest_metrics.update(app_metrics(app, text))
+                output_check = check_app_output(app, cp) if args.stdout != "null" else ""
             else:
-                bench_kind, bench_tags = classify_bench(rel)
+                internal = extract_internal_ms(text)
+            metric_kind, metric_ms = metric_kind_and_value(wall_ms=cp.wall_ms, internal_ms=internal, metric=args.metric)
             results.append(
                 RunResult(
                     engine=v.engine,
@@ -1286,7 +2156,7 @@ def main(argv: list[str]) -> int:
                     wasm=rel,
                     bench_kind=bench_kind,
                     bench_tags=bench_tags,
-                    ok=(cp.rc == 0),
+                    ok=(cp.rc == 0 and not output_check.startswith("fail")),
                     rc=cp.rc,
                     wall_ms=cp.wall_ms,
                     internal_ms=internal,
@@ -1295,17 +2165,42 @@ def main(argv: list[str]) -> int:
                     metric_ms=metric_ms,
                     stdout_tail=tail(cp.out),
                     stderr_tail=tail(cp.err),
+                    guest_metrics=guest_metrics,
+                    output_check=output_check,
+                    max_rss_kb=cp.max_rss_kb,
+                    compile_ms=cp.compile_ms,
                 )
             )
+            if strace and cp.rc == 0:
+                counts = count_syscalls(strace, cmd, cwd, args.timeout)
+                if counts is None:
+                    print(f"  strace run failed: {v.key}", file=sys.stderr)
+                else:
+                    results[-1].syscalls = counts
+
+    apply_clock_bias(results, clock_cal, subtract=args.clock_bias == "subtract")
+    apply_startup_calibration(results, startup_cal)
 
     out_path = Path(args.out)
     out_path.parent.mkdir(parents=True, exist_ok=True)
     payload = {
         "meta": {
             "root": str(root),
+            "root_features": root_features,
+            "apps": [str(Path(m).resolve()) for m in args.apps],
             "timeout_s": args.timeout,
+            "stdout": args.stdout,
             "count_wasm": len(wasms),
             "bench_meta": bench_meta,
+            "classify": args.classify,
+            "clock_calibration": clock_cal,
+            "clock_bias": {"mode": args.clock_bias, "factor": CLOCK_BIAS_FACTOR},
+            "startup_calibration": startup_cal,
+            "strace": strace,
+            "hostcall_breakdown": hostcall_breakdown(results),
+            "op_counts": {"source": args.op_counts, "per_wasm": {w: c for w, c in op_counts.items() if w in bench_meta}}
+            if op_counts
+            else {},
             "bench_kind_semantics": {
                 "compute_dense": "dense arithmetic/crypto/science compute",
                 "memory_dense": "memory bandwidth / data-structure heavy",
@@ -1326,6 +2221,46 @@ def main(argv: list[str]) -> int:
                 "metric": "metric requested for summary/ratios/plot; auto prefers internal_ms when available, else wall_ms",
                 "per_result": "each result includes metric_kind (wall|internal) and metric_ms (value used for this run under the chosen metric)",
             },
+            "guest_metric_semantics": {
+                "guest_metrics": "extra 'Metric: <name> <value>' lines printed by the guest (e.g. allocs, batch_p50_us, batch_max_us)",
+                "alloc_mops": "derived: allocs / internal_ms / 1000 (million allocations per second)",
+                "pause_ratio": "derived: batch_max_us / batch_p50_us (worst batch vs typical batch; GC pause impact)",
+                "ttfi_ms": "guest CLOCK_REALTIME stamp at _start entry minus host stamp before spawn (time to first instruction)",
+                "run_ms": "derived: wall_ms - ttfi_ms",
+                "grow_ns_p50": (
+                    "grow/ tier: per-grow latency percentile (also p90, p99), floor of a log-linear histogram bucket "
+                    "(within 12.5%); grow_ns_min/max/total are exact"
+                ),
+                "access_ps_per_op": "grow/ tier: i64 read-modify-write over the top 16 MiB after growth, picoseconds per access",
+                "memory_grows": (
+                    "micro/alloc_suite: linear-memory size increases seen via memory.size after each allocation "
+                    "(linear_peak_bytes: final memory size; peak_live_bytes: requested bytes live at the peak)"
+                ),
+                "scan_ms": "db/columnar_query: per-stage guest time (also join_ms, groupby_ms, topk_ms; Time is their sum)",
+                "matvec_ms": (
+                    "science/transformer: per-sub-kernel guest time (also matmul_ms, attn_scores_ms, softmax_ms, "
+                    "attn_v_ms, layernorm_ms, gelu_ms, kv_append_ms; Time is their sum)"
+                ),
+                "text_ratio": (
+                    "micro/compress_*: input bytes / compressed bytes (also random_ratio); <input>_compress_mb_s and "
+                    "<input>_decompress_mb_s are input MB (1e6) per second, each timed on its own"
+                ),
+                "syscalls": (
+                    "per result with --strace: syscall -> count from one extra run under strace -f -c (whole process, "
+                    "startup included; wasmtime full mode runs without its precompiled artifact there)"
+                ),
+                "net_wall_ms": "wall_ms minus the variant's startup_calibration median (empty module, empty _start)",
+                "max_rss_kb": "per result: peak RSS of the engine process from wait4 rusage",
+                "compile_ms": "per result: wasmtime full mode, wall time of the compile step (only when no cached artifact)",
+                "clock_biased": (
+                    "per result: internal_ms below clock_bias.factor x max(call_ns, step_ns) of the variant's "
+                    "clock_calibration; with clock_bias.mode=subtract, one call_ns was taken off internal_ms"
+                ),
+                "ops": "instrument_wasm.py: executed wasm instructions between the first and last clock_time_get (ops_<class> per opcode class)",
+                "ops_all": "instrument_wasm.py: executed wasm instructions over the whole run",
+            },
+            "proposal_unsupported": unsupported,
+            "skipped_runs": skipped_runs,
             "date_epoch": time.time(),
             "argv": sys.argv,
         },
@@ -1370,6 +2305,120 @@ def main(argv: list[str]) -> int:
             for key, r in ssub["ratios_vs_baseline"].items():  # type: ignore[union-attr]
                 print(f"  {key}: common_ok {r['common_ok']}, geomean {r['ratio_geomean']:.4f}, median {r['ratio_median']:.4f}")
 
+    # Guest-reported metrics (e.g. GC allocation throughput / pause impact), per benchmark.
+    with_metrics = [r for r in results if r.ok and r.guest_metrics and "minvar" not in r.bench_tags]
+    if with_metrics:
+        print("\n=== Guest metrics ===")
+        for rel in sorted({r.wasm for r in with_metrics}):
+            print(rel)
+            for r in (x for x in with_metrics if x.wasm == rel):
+                key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+                vals = {**r.guest_metrics, **derived_guest_metrics(r)}
+                print(f"  {key}: " + ", ".join(f"{k} {v:.6g}" for k, v in vals.items()))
+    # Parametric minvar sweeps: where each engine's per-iteration cost jumps (e.g. 255 -> 256 locals).
+    curves = threshold_curves(results, args.metric)
+    if curves:
+        print(f"\n=== Threshold curves (ns/iter, {metric_label}) ===")
+        for stem, per_key in sorted(curves.items()):
+            print(stem)
+            for key, pts in per_key.items():
+                step = largest_step(pts)
+                ys = [y for _, y in pts]
+                step_s = f", largest step x{step[2]:.2f} at {step[0]}->{step[1]}" if step else ""
+                print(f"  {key}: {len(pts)} points, {min(ys):.3f}..{max(ys):.3f} ns/iter{step_s}")
+
+    # Large-module scaling: startup cost vs module size (wasm/corpus_large/).
+    large = [r for r in results if r.ok and "large_module" in r.bench_tags]
+    if large:
+        print("\n=== Large-module scaling (sorted by size) ===")
+        for rel in sorted({r.wasm for r in large}, key=lambda w: (int(bench_meta.get(w, {}).get("size_bytes", 0)), w)):  # type: ignore[call-overload]
+            print(f"{rel} ({int(bench_meta[rel]['size_bytes']) / 1e6:.2f} MB)")  # type: ignore[call-overload]
+            for r in (x for x in large if x.wasm == rel):
+                key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+                cols = [f"wall {r.wall_ms:.3f} ms"]
+                if "ttfi_ms" in r.guest_metrics:
+                    cols.append(f"ttfi {r.guest_metrics['ttfi_ms']:.3f} ms")
+                if r.internal_ms is not None:
+                    cols.append(f"exec {r.internal_ms:.3f} ms")
+                if r.compile_ms is not None:
+                    cols.append(f"compile {r.compile_ms:.3f} ms")
+                if r.max_rss_kb is not None:
+                    cols.append(f"rss {r.max_rss_kb / 1024.0:.1f} MiB")
+                print(f"  {key}: " + ", ".join(cols))
+    # Instantiate-latency tier: cost per unit of each dimension, from the smallest to the largest module.
+    inst = instantiate_curves(results)
+    if inst:
+        print("\n=== Instantiate latency (wall - calibrated startup) ===")
+        for key, cal in startup_cal.items():
+            print(f"{key}: startup {cal['wall_ms']:.3f} ms (min {cal['min_ms']:.3f}, max {cal['max_ms']:.3f})")
+        for dim, per_key in sorted(inst.items()):
+            unit = INSTANTIATE_UNITS.get(dim, "unit")
+            scale = _INSTANTIATE_UNIT_SIZE.get(dim, 1000)
+            print(dim)
+            for key, pts in per_key.items():
+                (p0, y0), (p1, y1) = pts[0], pts[-1]
+                slope = f", {(y1 - y0) / (p1 - p0) * scale * 1e3:.3f} us per {unit}" if p1 > p0 else ""
+                print(f"  {key}: " + " ".join(f"{p}:{y:.3f}" for p, y in pts) + f" ms{slope}")
+    # stdout throughput guests (wasi/stdout_*): MiB/s under this run's --stdout capture mode.
+    stdout_rs = [r for r in results if r.ok and "stdout" in r.bench_tags and "mib_per_s" in r.guest_metrics]
+    if stdout_rs:
+        print(f"\n=== stdout throughput (--stdout {args.stdout}) ===")
+        for r in sorted(stdout_rs, key=lambda x: (x.wasm, x.engine, x.runtime, x.mode, x.label)):
+            key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+            print(f"{r.wasm} {key}: {r.guest_metrics['mib_per_s']:.1f} MiB/s, {r.guest_metrics.get('writes', 0):.0f} writes")
+    # Host-call tier: ns per WASI call by argument shape, split into transition / translation / syscall parts.
+    hostcall = [r for r in results if r.ok and "hostcall" in r.bench_tags and r.internal_ms and r.guest_metrics.get("calls")]
+    if hostcall:
+        print("\n=== Host-call overhead (internal_ms / calls) ===")
+        for r in sorted(hostcall, key=lambda x: (x.wasm, x.engine, x.runtime, x.mode, x.label)):
+            calls = r.guest_metrics["calls"]
+            hot = ", ".join(f"{n} {c / calls:.2f}" for n, c in sorted(r.syscalls.items()) if c >= calls / 2)
+            key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+            print(f"{r.wasm} {key}: {r.internal_ms * 1e6 / calls:.1f} ns/call" + (f" (syscalls/call: {hot})" if hot else ""))
+        for key, b in hostcall_breakdown(results).items():
+            print(f"{key}: " + ", ".join(f"{k} {v:.1f}" for k, v in b.items()))
+    # memory.grow scaling (wasm/corpus_grow/): grow latency, RSS, and access speed after growth vs static memory.
+    grow_lines = grow_report(results)
+    if grow_lines:
+        print("\n=== memory.grow scaling ===")
+        for line in grow_lines:
+            print(line)
+    # Guest clock cost per variant, and which guest-timed regions it noticeably inflates.
+    if clock_cal:
+        print(f"\n=== Clock calibration (clock_time_get, bias check < {CLOCK_BIAS_FACTOR:g}x) ===")
+        for key, cal in clock_cal.items():
+            biased = sorted(
+                r.wasm
+                for r in results
+                if r.clock_biased and variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label) == key
+            )
+            print(
+                f"{key}: call {cal['call_ns']:.1f} ns, res {cal['res_ns']:.0f} ns, step {cal['step_ns']:.0f} ns, "
+                f"repeated reads {cal['zero_steps']:.0f}; {'corrected' if args.clock_bias == 'subtract' else 'flagged'} "
+                f"{len(biased)}" + (f" ({', '.join(biased[:5])}{', ...' if len(biased) > 5 else ''})" if biased else "")
+            )
+
+    # Dynamic op counts (instrument_wasm.py): cost per executed wasm instruction, comparable across benchmarks.
+    if op_counts:
+        thr = op_throughput(results, op_counts, args.metric)
+        print(f"\n=== Throughput per wasm op ({metric_label}, counts: {args.op_counts}) ===")
+        missing = sorted({r.wasm for r in results} - set(op_counts))
+        if missing:
+            print(f"no op count for {len(missing)} wasm (e.g. {missing[0]})")
+        for kind in sorted(thr):
+            print(f"[{kind}]")
+            for key, vals in thr[kind].items():
+                ns = geomean(vals)
+                print(f"  {key}: n {len(vals)}, geomean {ns:.3f} ns/op ({1e3 / ns:.1f} Mops/s), median {statistics.median(vals):.3f} ns/op")
+    if skipped_runs:
+        print(f"\nskipped runs (unsupported proposal): {len(skipped_runs)}")
+    failed_checks = [r for r in results if r.output_check.startswith("fail")]
+    if failed_checks:
+        print(f"\napp output check failures: {len(failed_checks)}")
+        for r in failed_checks:
+            key = variant_key(engine=r.engine, runtime=r.runtime, mode=r.mode, label=r.label)
+            print(f"  {key} {r.wasm}: {r.output_check}")
+
     if args.plot:
         try:
             import matplotlib.pyplot as plt  # type: ignore[import-not-found]
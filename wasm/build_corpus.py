@@ -2,12 +2,16 @@
 from __future__ import annotations
 
 import argparse
+import json
 import os
 import subprocess
 import sys
-from dataclasses import dataclass
+from dataclasses import dataclass, replace
 from pathlib import Path
 
+import minvar_families as mv
+import wasm_binary as wb
+
 
 @dataclass(frozen=True)
 class BuildUnit:
@@ -15,6 +19,125 @@ class BuildUnit:
     src: Path
     out: Path
     cflags: tuple[str, ...] = ()
+    features: tuple[str, ...] = ()  # wasm proposals enabled on top of the MVP baseline
+
+
+@dataclass(frozen=True)
+class Profile:
+    out: str
+    features: tuple[str, ...]
+    wat: bool
+    sysroot_env: str
+    src_prefixes: tuple[str, ...] = ()  # only C++ sources whose file name starts with one of these (empty = all)
+    out_prefixes: tuple[str, ...] = ()  # and only units whose output file name starts with one of these (empty = all)
+
+
+# Proposals that the compatibility-first corpus turns off. Each entry maps a feature
+# name to the clang `-m<feature>` suffixes it controls; units/profiles opt back in.
+CLANG_GATED_FEATURES: dict[str, tuple[str, ...]] = {
+    "bulk-memory": ("bulk-memory", "bulk-memory-opt"),
+    "nontrapping-fptoint": ("nontrapping-fptoint",),
+    "sign-ext": ("sign-ext",),
+    "mutable-globals": ("mutable-globals",),
+    "multivalue": ("multivalue",),
+    "reference-types": ("reference-types",),
+    "call-indirect-overlong": ("call-indirect-overlong",),
+}
+
+WAT2WASM_GATED_FEATURES: dict[str, str] = {
+    "bulk-memory": "--disable-bulk-memory",
+    "sign-ext": "--disable-sign-extension",
+    "nontrapping-fptoint": "--disable-saturating-float-to-int",
+    "multivalue": "--disable-multi-value",
+    "reference-types": "--disable-reference-types",
+}
+
+# Proposals that only exist on top of others. wabt switches reference-types off while bulk-memory is off
+# (Features::UpdateDependencies), and `elem declare` / table.get / table.set need both.
+FEATURE_DEPENDENCIES: dict[str, tuple[str, ...]] = {
+    "reference-types": ("bulk-memory",),
+}
+
+
+def with_feature_dependencies(features: tuple[str, ...]) -> tuple[str, ...]:
+    out = list(features)
+    for feat in features:
+        out.extend(FEATURE_DEPENDENCIES.get(feat, ()))
+    return tuple(dict.fromkeys(out))
+
+
+# - mvp: the default corpus (every gated proposal off).
+# - mvp-plus: same C++ sources with bulk-memory/sign-ext/non-trapping fptoint on, written to a
+#   parallel tree with identical relative paths so results can be paired per benchmark.
+#   WAT sources are hand-written MVP code and would be byte-identical, so they are skipped.
+# - simd128: the science guests autovectorized with strict SIMD.
+# - relaxed-simd: only the guests with explicit f32x4/f64x2.relaxed_madd kernels behind __wasm_relaxed_simd__
+#   (daxpy, f32/f64 matmul, transformer, nbody, Black-Scholes, k-means, and the poisson_cg/bicgstab/gmres
+#   Krylov solvers of science_extra_suite). Contraction alone is not guaranteed to emit a relaxed op, so every
+#   module in this tree is checked for one after the build (see require_relaxed_simd).
+#   The strict tree is the reference for drift checks (compare_results.py --base simd128 --new relaxed).
+#   simd128 also builds the db_hashmap_ guests, whose SwissTable variant switches from SWAR to i8x16 groups.
+#   science_qnn_i8 is integer-only; the simd128 tree swaps its scalar GEMM kernel for i32x4.dot_i16x8.
+PROFILES: dict[str, Profile] = {
+    "mvp": Profile(out="wasm/corpus", features=(), wat=True, sysroot_env="WASI_SYSROOT"),
+    "mvp-plus": Profile(
+        out="wasm/corpus_mvp_plus",
+        features=("bulk-memory", "sign-ext", "nontrapping-fptoint"),
+        wat=False,
+        sysroot_env="WASI_SYSROOT_MVP_PLUS",
+    ),
+    "simd128": Profile(
+        out="wasm/corpus_simd128",
+        features=("simd128",),
+        wat=False,
+        sysroot_env="WASI_SYSROOT",
+        src_prefixes=("science_", "db_hashmap_"),
+    ),
+    "relaxed-simd": Profile(
+        out="wasm/corpus_relaxed_simd",
+        features=("simd128", "relaxed-simd"),
+        wat=False,
+        sysroot_env="WASI_SYSROOT",
+        src_prefixes=("science_",),
+        out_prefixes=(
+            "daxpy_",
+            "matmul_f",
+            "transformer_",
+            "nbody_",
+            "black_scholes_",
+            "kmeans_",
+            "poisson_cg_",
+            "bicgstab_",
+            "gmres_",
+        ),
+    ),
+}
+
+
+def clang_feature_flags(features: tuple[str, ...]) -> list[str]:
+    features = with_feature_dependencies(features)
+    flags: list[str] = []
+    for feat, names in CLANG_GATED_FEATURES.items():
+        prefix = "-m" if feat in features else "-mno-"
+        flags.extend(prefix + n for n in names)
+    for feat in features:
+        if feat not in CLANG_GATED_FEATURES:
+            flags.append("-m" + feat)
+    return flags
+
+
+def wat2wasm_feature_flags(features: tuple[str, ...]) -> list[str]:
+    features = with_feature_dependencies(features)
+    flags = [flag for feat, flag in WAT2WASM_GATED_FEATURES.items() if feat not in features]
+    for feat in features:
+        if feat not in WAT2WASM_GATED_FEATURES:
+            flags.append("--enable-" + feat)
+    return flags
+
+
+# Proposals wabt cannot assemble yet; WAT units that need them go through `wasm-tools parse`,
+# which accepts every proposal it knows about without feature flags.
+WASM_TOOLS_FEATURES = {"gc"}
 
 
 def _run(cmd: list[str], *, cwd: Path, verbose: bool) -> None:
@@ -23,10 +146,12 @@ def _run(cmd: list[str], *, cwd: Path, verbose: bool) -> None:
     subprocess.run(cmd, cwd=str(cwd), check=True)
 
 
-def _default_sysroot() -> Path | None:
-    env = os.environ.get("WASI_SYSROOT")
+def _default_sysroot(env_name: str = "WASI_SYSROOT") -> Path | None:
+    env = os.environ.get(env_name)
     if env and Path(env).is_dir():
         return Path(env)
+    if env_name != "WASI_SYSROOT":
+        return None
     p = Path("/Users/liyinan/Documents/MacroModel/src/wasi-libc/build-mvp/sysroot")
     if p.is_dir():
         return p
@@ -58,51 +183,700 @@ def build_cc(
         "--target=wasm32-wasip1",
         f"--sysroot={sysroot}",
         "-std=c++26",
-        "-mno-bulk-memory",
-        "-mno-bulk-memory-opt",
-        "-mno-nontrapping-fptoint",
-        "-mno-sign-ext",
-        "-mno-mutable-globals",
-        "-mno-multivalue",
-        "-mno-reference-types",
-        "-mno-call-indirect-overlong",
+        *clang_feature_flags(unit.features),
         *unit.cflags,
     ]
     _run(cmd, cwd=unit.src.parent, verbose=verbose)
 
 
-def build_wat(*, unit: BuildUnit, verbose: bool) -> None:
+def build_wat(*, unit: BuildUnit, wasm_tools: str, verbose: bool) -> None:
     unit.out.parent.mkdir(parents=True, exist_ok=True)
+    if WASM_TOOLS_FEATURES & set(unit.features):
+        _run([wasm_tools, "parse", str(unit.src), "-o", str(unit.out)], cwd=unit.src.parent, verbose=verbose)
+        return
     cmd = [
         "wat2wasm",
         str(unit.src),
         "-o",
         str(unit.out),
-        "--disable-bulk-memory",
-        "--disable-sign-extension",
-        "--disable-saturating-float-to-int",
-        "--disable-multi-value",
-        "--disable-reference-types",
+        *wat2wasm_feature_flags(unit.features),
     ]
     _run(cmd, cwd=unit.src.parent, verbose=verbose)
 
 
+# relaxed-simd sub-opcodes under the 0xFD prefix (i8x16.relaxed_swizzle .. i32x4.relaxed_dot_i8x16_i7x16_add_s).
+RELAXED_SIMD_SUBOPS = range(0x100, 0x114)
+
+
+def count_relaxed_simd_ops(data: bytes) -> int:
+    m = wb.read_module(data)
+    n = 0
+    for body in m.bodies:
+        _, start = wb.read_locals(data, body)
+        for key, _, _ in wb.iter_ops(data, start, body[1]):
+            if key >> 12 == wb.PREFIX_FD and (key & 0xFFF) in RELAXED_SIMD_SUBOPS:
+                n += 1
+    return n
+
+
+def require_relaxed_simd(outs: list[Path]) -> None:
+    """Fail the relaxed-simd profile if a module carries no relaxed op (it would be drift-checked as relaxed)."""
+    missing = [str(p) for p in outs if count_relaxed_simd_ops(p.read_bytes()) == 0]
+    if missing:
+        raise SystemExit("relaxed-simd profile: no relaxed SIMD instructions in:\n  " + "\n  ".join(missing))
+
+
+# Large-module tier: thousands of generated functions, of which only a fraction is ever called.
+# _start stamps CLOCK_REALTIME first (printed as `Metric: start_realtime_ns`) so the harness can derive
+# time-to-first-instruction, then times the executed subset as usual.
+LARGE_SHAPES = ("flat", "chain", "tree")
+_LARGE_OPS = ("i32.add", "i32.xor", "i32.mul", "i32.rotl")
+_LARGE_CHAIN = 64  # max call depth of one chain segment
+
+
+def _large_callees(j: int, lo: int, hi: int, shape: str) -> list[int]:
+    r = j - lo
+    if shape == "chain":
+        return [j + 1] if (r + 1) % _LARGE_CHAIN and j + 1 < hi else []
+    if shape == "tree":
+        return [lo + c for c in (2 * r + 1, 2 * r + 2) if lo + c < hi]
+    return []
+
+
+def _large_roots(m: int, shape: str) -> list[int]:
+    if shape == "chain":
+        return list(range(0, m, _LARGE_CHAIN))
+    if shape == "tree":
+        return [0]
+    return list(range(m))
+
+
+def large_module_bytes(*, funcs: int, ops: int, shape: str, exec_fraction: float) -> bytes:
+    """
+    funcs generated `(i32) -> i32` functions of `ops` const+arith pairs each. The first
+    max(1, funcs * exec_fraction) form the hot set reached from _start; the rest have the same
+    call-graph shape among themselves but are never called.
+    """
+
+    hot = max(1, min(funcs, round(funcs * exec_fraction)))
+    f_gen = wb.FIRST_FUNC + 1  # wb.FIRST_FUNC is the timed driver
+    t_gen = wb.FIRST_TYPE
+
+    # locals: 0 acc
+    driver = bytearray()
+    for r in _large_roots(hot, shape):
+        driver += wb.code(("local.get", 0), ("call", f_gen + r), ("local.get", 0), "i32.add", ("local.set", 0))
+    driver += wb.code(("i32.const", wb.SINK), ("local.get", 0), ("i32.store", 0), "end")
+
+    bodies = [(wb.VOID_TYPE, wb.func_body(bytes(driver), [(1, wb.I32)]))]
+    for j in range(funcs):
+        lo, hi = (0, hot) if j < hot else (hot, funcs)
+        body = bytearray(wb.code(("local.get", 0)))
+        for k in range(ops):
+            body += wb.code(("i32.const", ((j * 31 + k * 7) & 0x1FFF) | 1), _LARGE_OPS[k % len(_LARGE_OPS)])
+        for c in _large_callees(j, lo, hi, shape):
+            body += wb.code(("local.get", 0), ("call", f_gen + c), "i32.add")
+        body += wb.code("end")
+        bodies.append((t_gen, wb.func_body(bytes(body))))
+
+    return wb.wasi_timed_module(
+        types=[wb.functype([wb.I32], [wb.I32])],
+        funcs=bodies,
+        bench=wb.FIRST_FUNC,
+        metrics=[("funcs", funcs), ("exec_funcs", hot)],
+        stamp_realtime=True,
+    )
+
+
+def large_module_name(*, funcs: int, ops: int, shape: str, exec_fraction: float) -> str:
+    count = f"{funcs // 1000}k" if funcs % 1000 == 0 else str(funcs)
+    pct = f"{exec_fraction * 100:g}".replace(".", "p")
+    return f"large/f{count}_ops{ops}_{shape}_exec{pct}pct.wasm"
+
+
+def build_large(*, out_root: Path, funcs: list[int], ops: int, shapes: list[str], exec_fraction: float) -> int:
+    built = 0
+    for shape in shapes:
+        for n in funcs:
+            out = out_root / large_module_name(funcs=n, ops=ops, shape=shape, exec_fraction=exec_fraction)
+            out.parent.mkdir(parents=True, exist_ok=True)
+            out.write_bytes(large_module_bytes(funcs=n, ops=ops, shape=shape, exec_fraction=exec_fraction))
+            built += 1
+    return built
+
+
+# Instantiate-latency tier: each module varies one instantiation dimension against a fixed baseline (1 page of
+# memory, nothing else) and has an empty _start, so wall time minus the engine's startup on the baseline is
+# what instantiating that dimension costs.
+INSTANTIATE_DIMS: dict[str, tuple[int, ...]] = {
+    "data_bytes": (0, 4096, 65536, 1 << 20, 16 << 20, 64 << 20),  # one active segment of N bytes
+    "data_segments": (0, 16, 256, 4096, 65536),  # N active 16-byte segments
+    "pages": (1, 16, 256, 4096, 16384),  # initial memory pages
+    "table": (0, 1024, 65536, 1 << 20),  # funcref table of N entries, left null
+    "elem": (0, 1024, 65536, 1 << 20),  # funcref table of N entries, filled by one active elem segment
+    "globals": (0, 256, 4096, 65536),  # mutable i64 globals with constant initializers
+    "imports": (0, 16, 256, 4096),  # wasi function imports (resolved, never called)
+}
+_INSTANTIATE_SEG = 16
+# (name, params, results): signatures from wasi_snapshot_preview1 that every WASI engine provides.
+_INSTANTIATE_IMPORTS = (
+    ("sched_yield", (), (wb.I32,)),
+    ("proc_exit", (wb.I32,), ()),
+    ("fd_close", (wb.I32,), (wb.I32,)),
+    ("clock_time_get", (wb.I32, wb.I64, wb.I32), (wb.I32,)),
+)
+
+
+def instantiate_module_bytes(dim: str, n: int) -> bytes:
+    """Module with an empty exported _start whose `dim` is n and everything else at the baseline."""
+
+    if dim not in INSTANTIATE_DIMS:
+        raise ValueError(f"unknown instantiate dimension: {dim}")
+    n_imports = n if dim == "imports" else 0
+    if dim == "data_bytes":
+        data_end = n
+    elif dim == "data_segments":
+        data_end = n * _INSTANTIATE_SEG
+    else:
+        data_end = 0
+    pages = n if dim == "pages" else max(1, -(-data_end // 65536))
+
+    types = [wb.functype([], [])] + ([wb.functype(p, r) for _, p, r in _INSTANTIATE_IMPORTS] if n_imports else [])
+    out = bytearray(wb.MAGIC + wb.section(wb.SEC_TYPE, wb.vec(types)))
+    if n_imports:
+        imports = []
+        for i in range(n_imports):
+            k = i % len(_INSTANTIATE_IMPORTS)
+            imports.append(wb.name("wasi_snapshot_preview1") + wb.name(_INSTANTIATE_IMPORTS[k][0]) + b"\x00" + wb.uleb(1 + k))
+        out += wb.section(wb.SEC_IMPORT, wb.vec(imports))
+    f_start = n_imports
+    out += wb.section(wb.SEC_FUNCTION, wb.vec([wb.uleb(0)]))
+    if dim in ("table", "elem"):
+        out += wb.section(wb.SEC_TABLE, wb.vec([bytes([wb.FUNCREF, 0]) + wb.uleb(n)]))
+    out += wb.section(wb.SEC_MEMORY, wb.vec([b"\x00" + wb.uleb(pages)]))
+    if dim == "globals" and n:
+        out += wb.section(
+            wb.SEC_GLOBAL, wb.vec(bytes([wb.I64, 1]) + wb.code(("i64.const", i), "end") for i in range(n))
+        )
+    out += wb.section(wb.SEC_EXPORT, wb.vec([wb.name("memory") + b"\x02\x00", wb.name("_start") + b"\x00" + wb.uleb(f_start)]))
+    if dim == "elem" and n:
+        out += wb.section(wb.SEC_ELEM, wb.vec([b"\x00" + wb.code(("i32.const", 0), "end") + wb.vec([wb.uleb(f_start)] * n)]))
+    out += wb.section(wb.SEC_CODE, wb.vec([wb.func_body(wb.code("end"))]))
+    # Non-zero filler, so an engine cannot treat the segment as already-zeroed memory.
+    fill = bytes(range(1, 256))
+    if dim == "data_bytes" and n:
+        payload = (fill * (n // len(fill) + 1))[:n]
+        out += wb.section(wb.SEC_DATA, wb.vec([b"\x00" + wb.code(("i32.const", 0), "end") + wb.uleb(n) + payload]))
+    elif dim == "data_segments" and n:
+        seg = fill[:_INSTANTIATE_SEG]
+        out += wb.section(
+            wb.SEC_DATA,
+            wb.vec(b"\x00" + wb.code(("i32.const", i * _INSTANTIATE_SEG), "end") + wb.uleb(len(seg)) + seg for i in range(n)),
+        )
+    return bytes(out)
+
+
+def build_instantiate(*, out_root: Path, dims: list[str], params: str) -> int:
+    built = 0
+    for dim in dims:
+        for n in mv.parse_params(params) if params else INSTANTIATE_DIMS[dim]:
+            out = out_root / "instantiate" / f"{dim}_{n}.wasm"
+            out.parent.mkdir(parents=True, exist_ok=True)
+            out.write_bytes(instantiate_module_bytes(dim, n))
+            built += 1
+    return built
+
+
+# memory.grow scaling tier: memory starts at one step (at least 1 page) and grows by `step` pages until it holds
+# `target` pages. Each grow is timed on its own into a log-linear histogram (16 exact buckets, then 8 per power
+# of two, so percentiles are bucket floors within 12.5%); with touch, one store per 4 KiB of each new region
+# follows the grow. Afterwards a read-modify-write sweep over the top 16 MiB measures steady-state access cost.
+# static_<target>p controls start at the target size and only run the sweep.
+GROW_SWEEP: tuple[tuple[int, int, bool], ...] = (
+    *((step, 4096, touch) for step in (1, 16, 256, 1024) for touch in (False, True)),  # to 256 MiB
+    *((step, 65536, False) for step in (256, 4096, 16384)),  # to the 4 GiB limit, 1 GiB steps at most
+)
+GROW_STATIC: tuple[int, ...] = (4096, 65536)
+_GROW_HIST = 8192  # 512 i64 buckets
+_GROW_SLOTS = 12288  # i64: grows, total ns, min ns, max ns, touch ns, failed
+_GROW_WINDOW = 256  # pages swept after growth
+_GROW_ACCESS_OPS = 1 << 25
+
+
+def grow_module_bytes(*, step: int, target: int, touch: bool) -> bytes:
+    """step 0: static control, memory starts at target pages."""
+
+    initial = target if step == 0 else max(1, target - (target - 1) // step * step)
+    grows = 0 if step == 0 else (target - initial) // step
+    window = min(_GROW_WINDOW, target - 1)
+    reps = max(1, _GROW_ACCESS_OPS // (window * 8192))
+    f = wb.FIRST_FUNC
+    f_bench, f_now, f_bucket, f_pct, f_access = f, f + 1, f + 2, f + 3, f + 4
+    t = wb.FIRST_TYPE
+    S = _GROW_SLOTS
+
+    now = wb.code(("i32.const", 1), ("i64.const", 0), ("i32.const", 48), ("call", 1), "drop", ("i32.const", 48), ("i64.load", 0), "end")
+    # (d i64) -> bucket; locals: 1 e (floor log2 d)
+    bucket = wb.code(
+        ("local.get", 0), ("i64.const", 16), "i64.lt_u", ("if", wb.I32),
+        ("local.get", 0), "i32.wrap_i64",
+        "else",
+        ("i32.const", 63), ("local.get", 0), "i64.clz", "i32.wrap_i64", "i32.sub", ("local.set", 1),
+        ("local.get", 0), ("local.get", 1), ("i32.const", 3), "i32.sub", "i64.extend_i32_u", "i64.shr_u", "i32.wrap_i64",
+        ("i32.const", 7), "i32.and",
+        ("local.get", 1), ("i32.const", 4), "i32.sub", ("i32.const", 3), "i32.shl", "i32.add",
+        ("i32.const", 16), "i32.add",
+        "end", "end",
+    )  # fmt: skip
+    # (q i32) -> floor of the bucket holding the q-th percentile grow; locals: 1 b, 2 cum, 3 need
+    pct = wb.code(
+        ("i32.const", 0), ("i64.load", S), "i64.eqz", "if", ("i64.const", 0), "return", "end",
+        ("i32.const", 0), ("i64.load", S), ("local.get", 0), "i64.extend_i32_u", "i64.mul",
+        ("i64.const", 99), "i64.add", ("i64.const", 100), "i64.div_u", ("local.set", 3),
+        "block", "loop",
+        ("local.get", 1), ("i32.const", 512), "i32.ge_u", ("br_if", 1),
+        ("local.get", 2), ("local.get", 1), ("i32.const", 3), "i32.shl", ("i64.load", _GROW_HIST), "i64.add", ("local.tee", 2),
+        ("local.get", 3), "i64.ge_u", "if",
+        ("local.get", 1), ("i32.const", 16), "i32.lt_u", "if", ("local.get", 1), "i64.extend_i32_u", "return", "end",
+        ("local.get", 1), ("i32.const", 16), "i32.sub", ("i32.const", 7), "i32.and", ("i32.const", 8), "i32.add", "i64.extend_i32_u",
+        ("local.get", 1), ("i32.const", 16), "i32.sub", ("i32.const", 3), "i32.shr_u", ("i32.const", 1), "i32.add", "i64.extend_i32_u",
+        "i64.shl", "return",
+        "end",
+        ("local.get", 1), ("i32.const", 1), "i32.add", ("local.set", 1),
+        ("br", 0),
+        "end", "end",
+        ("i64.const", 0), "end",
+    )  # fmt: skip
+    # () -> ps per access; locals: 0 t0, 1 acc (i64); 2 base, 3 i, 4 r, 5 addr (i32)
+    access = wb.code(
+        "memory.size", ("i32.const", window), "i32.sub", ("i32.const", 16), "i32.shl", ("local.set", 2),
+        ("call", f_now), ("local.set", 0),
+        "block", "loop",
+        ("local.get", 4), ("i32.const", reps), "i32.ge_u", ("br_if", 1),
+        ("i32.const", 0), ("local.set", 3),
+        "block", "loop",
+        ("local.get", 3), ("i32.const", window * 8192), "i32.ge_u", ("br_if", 1),
+        ("local.get", 2), ("local.get", 3), ("i32.const", 3), "i32.shl", "i32.add", ("local.tee", 5),
+        ("local.get", 5), ("i64.load", 0), ("i64.const", 1), "i64.add", ("i64.store", 0),
+        ("local.get", 3), ("i32.const", 1), "i32.add", ("local.set", 3),
+        ("br", 0),
+        "end", "end",
+        ("local.get", 4), ("i32.const", 1), "i32.add", ("local.set", 4),
+        ("br", 0),
+        "end", "end",
+        ("call", f_now), ("local.get", 0), "i64.sub", ("i64.const", 1000), "i64.mul",
+        ("i64.const", reps * window * 8192), "i64.div_u",
+        "end",
+    )  # fmt: skip
+    # locals: 0 t0, 1 d (i64); 2 old, 3 g, 4 tmp (i32)
+    touch_code = b""
+    if touch:
+        touch_code = wb.code(
+            ("call", f_now), ("local.set", 0),
+            ("i32.const", 0), ("local.set", 4),
+            "block", "loop",
+            ("local.get", 4), ("i32.const", step * 16), "i32.ge_u", ("br_if", 1),
+            ("local.get", 2), ("i32.const", 16), "i32.shl", ("local.get", 4), ("i32.const", 12), "i32.shl", "i32.add",
+            ("local.get", 4), "i64.extend_i32_u", ("i64.store", 0),
+            ("local.get", 4), ("i32.const", 1), "i32.add", ("local.set", 4),
+            ("br", 0),
+            "end", "end",
+            ("i32.const", 0), ("i32.const", 0), ("i64.load", S + 32), ("call", f_now), ("local.get", 0), "i64.sub", "i64.add",
+            ("i64.store", S + 32),
+        )  # fmt: skip
+    bench = (
+        wb.code(
+            ("i32.const", 0), ("i64.const", -1), ("i64.store", S + 16),
+            "block", "loop",
+            ("local.get", 3), ("i32.const", grows), "i32.ge_u", ("br_if", 1),
+            ("call", f_now), ("local.set", 0),
+            ("i32.const", step), "memory.grow", ("local.tee", 2), ("i32.const", -1), "i32.eq", "if",
+            ("i32.const", 0), ("i64.const", 1), ("i64.store", S + 40), ("br", 2),
+            "end",
+            ("call", f_now), ("local.get", 0), "i64.sub", ("local.set", 1),
+            ("local.get", 1), ("call", f_bucket), ("i32.const", 3), "i32.shl", ("local.tee", 4),
+            ("local.get", 4), ("i64.load", _GROW_HIST), ("i64.const", 1), "i64.add", ("i64.store", _GROW_HIST),
+            ("i32.const", 0), ("i32.const", 0), ("i64.load", S + 8), ("local.get", 1), "i64.add", ("i64.store", S + 8),
+            ("local.get", 1), ("i32.const", 0), ("i64.load", S + 16), "i64.lt_u", "if",
+            ("i32.const", 0), ("local.get", 1), ("i64.store", S + 16),
+            "end",
+            ("local.get", 1), ("i32.const", 0), ("i64.load", S + 24), "i64.gt_u", "if",
+            ("i32.const", 0), ("local.get", 1), ("i64.store", S + 24),
+            "end",
+        )
+        + touch_code
+        + wb.code(
+            ("local.get", 3), ("i32.const", 1), "i32.add", ("local.set", 3),
+            ("br", 0),
+            "end", "end",
+            ("i32.const", 0), ("local.get", 3), "i64.extend_i32_u", ("i64.store", S),
+            "end",
+        )
+    )  # fmt: skip
+
+    def slot(off: int) -> bytes:
+        return wb.code(("i32.const", 0), ("i64.load", S + off))
+
+    metrics: list[tuple[str, int | bytes]] = [("step_pages", step), ("target_pages", target)]
+    if step:
+        metrics += [
+            ("grows", slot(0)),
+            ("grow_failed", slot(40)),
+            ("grow_ns_total", slot(8)),
+            ("grow_ns_min", slot(16) if grows else wb.code(("i64.const", 0))),
+            ("grow_ns_p50", wb.code(("i32.const", 50), ("call", f_pct))),
+            ("grow_ns_p90", wb.code(("i32.const", 90), ("call", f_pct))),
+            ("grow_ns_p99", wb.code(("i32.const", 99), ("call", f_pct))),
+            ("grow_ns_max", slot(24)),
+        ]
+        if touch:
+            metrics.append(("touch_ns_total", slot(32)))
+    metrics += [
+        ("pages", wb.code("memory.size", "i64.extend_i32_u")),
+        ("access_ps_per_op", wb.code(("call", f_access))),
+    ]
+    return wb.wasi_timed_module(
+        types=[wb.functype([], [wb.I64]), wb.functype([wb.I64], [wb.I32]), wb.functype([wb.I32], [wb.I64])],
+        funcs=[
+            (wb.VOID_TYPE, wb.func_body(bench, [(2, wb.I64), (3, wb.I32)])),
+            (t, wb.func_body(now)),
+            (t + 1, wb.func_body(bucket, [(1, wb.I32)])),
+            (t + 2, wb.func_body(pct, [(1, wb.I32), (2, wb.I64)])),
+            (t, wb.func_body(access, [(2, wb.I64), (4, wb.I32)])),
+        ],
+        bench=f_bench,
+        metrics=metrics,
+        memory_pages=initial,
+    )
+
+
+def grow_module_name(*, step: int, target: int, touch: bool) -> str:
+    if step == 0:
+        return f"grow/static_{target}p.wasm"
+    return f"grow/grow_{step}p_to{target}p{'_touch' if touch else ''}.wasm"
+
+
+def build_grow(*, out_root: Path, sweep: list[tuple[int, int, bool]]) -> int:
+    built = 0
+    for step, target, touch in sweep:
+        out = out_root / grow_module_name(step=step, target=target, touch=touch)
+        out.parent.mkdir(parents=True, exist_ok=True)
+        out.write_bytes(grow_module_bytes(step=step, target=target, touch=touch))
+        built += 1
+    return built
+
+
+# Host-call tier: one cheap WASI import per module, called in a tight loop, with one argument shape varied:
+# pointer arguments (sched_yield 0, clock_res_get 1, args_sizes_get 2), fd_write iovec count (all zero-length, to
+# stdout), or fd_pwrite buffer size (one iovec, offset 0 of a scratch file). Metrics give calls and per-call
+# shape, so ns/call can be split into transition, per-iovec / per-byte translation and syscall cost.
+HOSTCALL_PTR = ("sched_yield", "clock_res_get", "args_sizes_get")
+HOSTCALL_IOVECS: tuple[int, ...] = (0, 1, 4, 16, 64, 256, 1024)
+HOSTCALL_BYTES: tuple[int, ...] = (1, 64, 4096, 65536)
+_HOSTCALL_CALLS = 200_000
+_HOSTCALL_IOV = 4096  # iovec array (up to 1024 entries)
+_HOSTCALL_BUF = 16384  # fd_pwrite source buffer
+_HOSTCALL_PATH = 3072
+_HOSTCALL_FILE = "u2bench_hostcall.tmp"
+_WASI_FUNCTYPES = {
+    "sched_yield": wb.functype([], [wb.I32]),
+    "clock_res_get": wb.functype([wb.I32, wb.I32], [wb.I32]),
+    "args_sizes_get": wb.functype([wb.I32, wb.I32], [wb.I32]),
+    "path_open": wb.functype([wb.I32, wb.I32, wb.I32, wb.I32, wb.I32, wb.I64, wb.I64, wb.I32, wb.I32], [wb.I32]),
+    "fd_pwrite": wb.functype([wb.I32, wb.I32, wb.I32, wb.I64, wb.I32], [wb.I32]),
+    "path_unlink_file": wb.functype([wb.I32, wb.I32, wb.I32], [wb.I32]),
+    "fd_close": wb.functype([wb.I32], [wb.I32]),
+}
+# fd_seek | fd_tell | fd_write: what fd_pwrite needs
+_RIGHTS_PWRITE = (1 << 2) | (1 << 5) | (1 << 6)
+
+
+def hostcall_module_bytes(shape: str, n: int = 0) -> bytes:
+    """shape: one of HOSTCALL_PTR (n unused), "iov" (fd_write with n iovecs) or "bytes" (fd_pwrite of n bytes)."""
+
+    if shape in HOSTCALL_PTR:
+        imports = [shape]
+        calls = _HOSTCALL_CALLS
+        ptrs = HOSTCALL_PTR.index(shape)
+        call = {
+            "sched_yield": wb.code(("call", 3)),
+            "clock_res_get": wb.code(("i32.const", 1), ("i32.const", 64), ("call", 3)),
+            "args_sizes_get": wb.code(("i32.const", 64), ("i32.const", 72), ("call", 3)),
+        }[shape]
+        setup = teardown = b""
+        shape_metrics: list[tuple[str, int | bytes]] = [("ptr_args", ptrs)]
+    elif shape == "iov":
+        # Zero-filled memory is already n iovecs of {ptr 0, len 0}.
+        imports = []
+        calls = _HOSTCALL_CALLS * 16 // max(16, n)
+        call = wb.code(("i32.const", 1), ("i32.const", _HOSTCALL_IOV), ("i32.const", n), ("i32.const", 64), ("call", 0))
+        setup = teardown = b""
+        shape_metrics = [("iovecs", n)]
+    elif shape == "bytes":
+        imports = ["path_open", "fd_pwrite", "fd_close", "path_unlink_file"]
+        f_open, f_pwrite, f_close, f_unlink = 3, 4, 5, 6
+        calls = min(_HOSTCALL_CALLS, (1 << 30) // n)
+        path = _HOSTCALL_FILE.encode("ascii")
+        setup = b"".join(wb.code(("i32.const", _HOSTCALL_PATH + i), ("i32.const", c), ("i32.store8", 0)) for i, c in enumerate(path))
+        setup += wb.code(
+            ("i32.const", _HOSTCALL_IOV), ("i32.const", _HOSTCALL_BUF), ("i32.store", 0),
+            ("i32.const", _HOSTCALL_IOV), ("i32.const", n), ("i32.store", 4),
+            # path_open(preopen 3, no symlink follow, path, O_CREAT|O_TRUNC, rights, rights, 0, &fd at 56)
+            ("i32.const", 3), ("i32.const", 0), ("i32.const", _HOSTCALL_PATH), ("i32.const", len(path)),
+            ("i32.const", 9), ("i64.const", _RIGHTS_PWRITE), ("i64.const", _RIGHTS_PWRITE), ("i32.const", 0), ("i32.const", 56),
+            ("call", f_open), "if", "unreachable", "end",
+        )  # fmt: skip
+        call = wb.code(
+            ("i32.const", 56), ("i32.load", 0), ("i32.const", _HOSTCALL_IOV), ("i32.const", 1), ("i64.const", 0),
+            ("i32.const", 64), ("call", f_pwrite),
+        )  # fmt: skip
+        teardown = wb.code(
+            ("i32.const", 56), ("i32.load", 0), ("call", f_close), "drop",
+            ("i32.const", 3), ("i32.const", _HOSTCALL_PATH), ("i32.const", len(path)), ("call", f_unlink), "drop",
+        )  # fmt: skip
+        shape_metrics = [("bytes", n)]
+    else:
+        raise ValueError(f"unknown host-call shape: {shape}")
+
+    # locals: 0 i, 1 failed calls
+    bench = (
+        setup
+        + wb.code(
+            "block", "loop",
+            ("local.get", 0), ("i32.const", calls), "i32.ge_u", ("br_if", 1),
+        )
+        + call
+        + wb.code(
+            "i32.eqz", "i32.eqz", ("local.get", 1), "i32.add", ("local.set", 1),
+            ("local.get", 0), ("i32.const", 1), "i32.add", ("local.set", 0),
+            ("br", 0),
+            "end", "end",
+            ("i32.const", wb.SINK), ("local.get", 1), "i64.extend_i32_u", ("i64.store", 0),
+        )
+        + teardown
+        + wb.code("end")
+    )  # fmt: skip
+    return wb.wasi_timed_module(
+        types=[],
+        funcs=[(wb.VOID_TYPE, wb.func_body(bench, [(2, wb.I32)]))],
+        bench=wb.FIRST_FUNC + len(imports),
+        metrics=[("calls", calls), *shape_metrics, ("errors", wb.code(("i32.const", wb.SINK), ("i64.load", 0)))],
+        memory_pages=2,
+        imports=[(nm, _WASI_FUNCTYPES[nm]) for nm in imports],
+    )
+
+
+def build_hostcall(*, out_root: Path) -> int:
+    mods = [(f"{s}_p{HOSTCALL_PTR.index(s)}", hostcall_module_bytes(s)) for s in HOSTCALL_PTR]
+    mods += [(f"fd_write_iov{n}", hostcall_module_bytes("iov", n)) for n in HOSTCALL_IOVECS]
+    mods += [(f"fd_pwrite_{n}b", hostcall_module_bytes("bytes", n)) for n in HOSTCALL_BYTES]
+    for stem, blob in mods:
+        out = out_root / "hostcall" / f"{stem}.wasm"
+        out.parent.mkdir(parents=True, exist_ok=True)
+        out.write_bytes(blob)
+    return len(mods)
+
+
+def build_minvar(*, out_root: Path, families: list[str], types: list[str], params: str, iters: int) -> int:
+    built = 0
+    for fam in (mv.FAMILIES[f] for f in families):
+        values = mv.parse_params(params) if params else list(fam.params)
+        for ty in types if fam.typed else ["i32"]:
+            for p in values:
+                n = iters or fam.iters
+                out = out_root / "minvar" / mv.module_name(fam, ty, p, n)
+                out.parent.mkdir(parents=True, exist_ok=True)
+                out.write_bytes(mv.module_bytes(fam, ty, p, n))
+                built += 1
+    return built
+
+
 def main(argv: list[str]) -> int:
     ap = argparse.ArgumentParser(description="Build the u2bench wasm corpus (C++ + WAT).")
     ap.add_argument("--sysroot", default="", help="WASI sysroot (default: $WASI_SYSROOT or wasi-libc build-mvp sysroot)")
     ap.add_argument("--clangxx", default="clang++", help="clang++ path (default: clang++)")
-    ap.add_argument("--out", default="wasm/corpus", help="output directory (default: wasm/corpus)")
+    ap.add_argument("--out", default="", help="output directory (default: the profile's tree, e.g. wasm/corpus)")
+    ap.add_argument(
+        "--proposals-out",
+        default="wasm/corpus_proposals",
+        help="output directory for modules that need post-MVP proposals (default: wasm/corpus_proposals)",
+    )
+    ap.add_argument(
+        "--profile",
+        choices=sorted(PROFILES.keys()),
+        default="mvp",
+        help=(
+            "feature profile: mvp (default corpus), mvp-plus (bulk-memory/sign-ext/sat-fptoint, C++ only), "
+            "simd128 (science guests) or relaxed-simd (science guests with explicit relaxed kernels)"
+        ),
+    )
+    ap.add_argument("--wasm-tools", default="wasm-tools", help="wasm-tools path, used for GC WAT sources (default: wasm-tools)")
+    ap.add_argument(
+        "--large",
+        action="store_true",
+        help="only generate the large-module tier (no toolchain needed) into --large-out",
+    )
+    ap.add_argument("--large-out", default="wasm/corpus_large", help="output directory for --large (default: wasm/corpus_large)")
+    ap.add_argument("--large-funcs", default="1000,10000,100000", help="comma-separated function counts (default: 1000,10000,100000)")
+    ap.add_argument("--large-ops", type=int, default=64, help="const+arith pairs per generated function (default: 64, ~0.2 KiB)")
+    ap.add_argument(
+        "--large-shape",
+        default="chain,tree",
+        help=f"comma-separated call-graph shapes from {'/'.join(LARGE_SHAPES)} (default: chain,tree)",
+    )
+    ap.add_argument(
+        "--large-exec-fraction",
+        type=float,
+        default=0.01,
+        help="fraction of generated functions reachable from _start (default: 0.01)",
+    )
+    ap.add_argument(
+        "--minvar",
+        action="store_true",
+        help="only generate the parametric legacy_minvar_microbenches families (no toolchain needed) into --minvar-out",
+    )
+    ap.add_argument("--minvar-out", default="wasm/corpus_minvar", help="output directory for --minvar (default: wasm/corpus_minvar)")
+    ap.add_argument(
+        "--minvar-family",
+        action="append",
+        default=[],
+        help=f"family to generate (repeatable; default: all): {', '.join(mv.FAMILIES)}",
+    )
+    ap.add_argument("--minvar-type", default="i32", help="comma-separated value types for typed families: i32,i64,f64 (default: i32)")
+    ap.add_argument(
+        "--minvar-params",
+        default="",
+        help="override each family's default sweep, e.g. 240:270 or 4,8,16,250:260 or 0:4096:64 (inclusive ranges)",
+    )
+    ap.add_argument("--minvar-iters", type=int, default=0, help="loop iterations (default: per-family, as in the legacy modules)")
+    ap.add_argument(
+        "--instantiate",
+        action="store_true",
+        help="only generate the instantiate-latency tier (no toolchain needed) into --instantiate-out",
+    )
+    ap.add_argument(
+        "--instantiate-out",
+        default="wasm/corpus_instantiate",
+        help="output directory for --instantiate (default: wasm/corpus_instantiate)",
+    )
+    ap.add_argument(
+        "--instantiate-dim",
+        action="append",
+        default=[],
+        help=f"dimension to sweep (repeatable; default: all): {', '.join(INSTANTIATE_DIMS)}",
+    )
+    ap.add_argument(
+        "--instantiate-params",
+        default="",
+        help="override each dimension's default sweep, same syntax as --minvar-params",
+    )
+    ap.add_argument(
+        "--grow",
+        action="store_true",
+        help="only generate the memory.grow scaling tier (no toolchain needed) into --grow-out",
+    )
+    ap.add_argument("--grow-out", default="wasm/corpus_grow", help="output directory for --grow (default: wasm/corpus_grow)")
+    ap.add_argument(
+        "--grow-spec",
+        action="append",
+        default=[],
+        help="STEP:TARGET[:touch] in pages, or 0:TARGET for a static control (repeatable; default: the built-in sweep)",
+    )
+    ap.add_argument(
+        "--hostcall",
+        action="store_true",
+        help="only generate the host-call overhead tier (no toolchain needed) into --hostcall-out",
+    )
+    ap.add_argument(
+        "--hostcall-out", default="wasm/corpus_hostcall", help="output directory for --hostcall (default: wasm/corpus_hostcall)"
+    )
     ap.add_argument("--verbose", action="store_true")
     args = ap.parse_args(argv)
 
+    profile = PROFILES[args.profile]
     repo_root = Path(__file__).resolve().parents[1]
-    out_root = (repo_root / args.out).resolve()
+
+    if args.minvar:
+        families = args.minvar_family or list(mv.FAMILIES)
+        types = [x.strip() for x in args.minvar_type.split(",") if x.strip()]
+        bad = [x for x in families if x not in mv.FAMILIES] + [x for x in types if x not in mv.VALTYPES]
+        if bad:
+            raise SystemExit(f"unknown --minvar-family/--minvar-type: {', '.join(bad)}")
+        minvar_root = (repo_root / args.minvar_out).resolve()
+        built = build_minvar(
+            out_root=minvar_root, families=families, types=types, params=args.minvar_params, iters=args.minvar_iters
+        )
+        print(f"built {built} wasm files under: {minvar_root}")
+        return 0
+
+    if args.hostcall:
+        hostcall_root = (repo_root / args.hostcall_out).resolve()
+        built = build_hostcall(out_root=hostcall_root)
+        print(f"built {built} wasm files under: {hostcall_root}")
+        return 0
+
+    if args.grow:
+        sweep: list[tuple[int, int, bool]] = []
+        for spec in args.grow_spec:
+            step_s, _, rest = spec.partition(":")
+            target_s, _, mode = rest.partition(":")
+            if not (step_s.isdigit() and target_s.isdigit() and mode in ("", "touch")):
+                raise SystemExit(f"bad --grow-spec (STEP:TARGET[:touch]): {spec}")
+            sweep.append((int(step_s), int(target_s), mode == "touch"))
+        if not sweep:
+            sweep = [*GROW_SWEEP, *((0, n, False) for n in GROW_STATIC)]
+        bad = [f"{a}:{b}" for a, b, _ in sweep if not (2 <= b <= 65536 and a <= b)]
+        if bad:
+            raise SystemExit(f"--grow-spec needs 2 <= TARGET <= 65536 and STEP <= TARGET: {', '.join(bad)}")
+        grow_root = (repo_root / args.grow_out).resolve()
+        built = build_grow(out_root=grow_root, sweep=sweep)
+        print(f"built {built} wasm files under: {grow_root}")
+        return 0
+
+    if args.instantiate:
+        dims = args.instantiate_dim or list(INSTANTIATE_DIMS)
+        bad = [x for x in dims if x not in INSTANTIATE_DIMS]
+        if bad:
+            raise SystemExit(f"unknown --instantiate-dim: {', '.join(bad)}")
+        inst_root = (repo_root / args.instantiate_out).resolve()
+        built = build_instantiate(out_root=inst_root, dims=dims, params=args.instantiate_params)
+        print(f"built {built} wasm files under: {inst_root}")
+        return 0
+
+    if args.large:
+        shapes = [x.strip() for x in args.large_shape.split(",") if x.strip()]
+        bad = [x for x in shapes if x not in LARGE_SHAPES]
+        if bad:
+            raise SystemExit(f"unknown --large-shape: {', '.join(bad)}")
+        if not 0.0 < args.large_exec_fraction <= 1.0:
+            raise SystemExit("--large-exec-fraction must be in (0, 1]")
+        large_root = (repo_root / args.large_out).resolve()
+        built = build_large(
+            out_root=large_root,
+            funcs=[int(x) for x in args.large_funcs.split(",") if x.strip()],
+            ops=args.large_ops,
+            shapes=shapes,
+            exec_fraction=args.large_exec_fraction,
+        )
+        print(f"built {built} wasm files under: {large_root}")
+        return 0
+    out_root = (repo_root / (args.out or profile.out)).resolve()
+    prop_root = (repo_root / args.proposals_out).resolve()
 
     sysroot: Path | None
     if args.sysroot:
         sysroot = Path(args.sysroot)
     else:
-        sysroot = _default_sysroot()
+        sysroot = _default_sysroot(profile.sysroot_env)
+        if sysroot is None and profile.sysroot_env != "WASI_SYSROOT":
+            # libc routines (memcpy/memset/memmove) keep their MVP byte loops unless wasi-libc
+            # itself was built with the same features; only compiler-emitted code changes.
+            print(
+                f"warning: ${profile.sysroot_env} not set; falling back to the MVP sysroot "
+                "(libc mem* routines will not use the enabled features)",
+                file=sys.stderr,
+            )
+            sysroot = _default_sysroot()
     if not sysroot or not sysroot.is_dir():
         raise SystemExit(
             "WASI sysroot not found. Pass --sysroot or set $WASI_SYSROOT. "
@@ -138,6 +912,54 @@ def main(argv: list[str]) -> int:
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/wasi_path_filestat_get_dense.cc", out=out_root / "wasi/path_filestat_get_100k.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/wasi_prestat_dir_name_dense.cc", out=out_root / "wasi/prestat_dir_name_200k.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/wasi_poll_oneoff_clock_dense.cc", out=out_root / "wasi/poll_oneoff_clock_200k.wasm"),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_raw_64b_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=0", "-DU2BENCH_STDOUT_CHUNK=64"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_raw_4k_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=0", "-DU2BENCH_STDOUT_CHUNK=4096"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_raw_64k_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=0", "-DU2BENCH_STDOUT_CHUNK=65536"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_raw_1m_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=0", "-DU2BENCH_STDOUT_CHUNK=1048576"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_full_64b_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=1", "-DU2BENCH_STDOUT_CHUNK=64"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_full_4k_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=1", "-DU2BENCH_STDOUT_CHUNK=4096"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_line_64b_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=2", "-DU2BENCH_STDOUT_CHUNK=64"),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/wasi_stdout_write.cc",
+            out=out_root / "wasi/stdout_line_4k_64m.wasm",
+            cflags=("-DU2BENCH_STDOUT_MODE=2", "-DU2BENCH_STDOUT_CHUNK=4096"),
+        ),
 
         # Crypto
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/crypto_sha256.cc", out=out_root / "crypto/sha256.wasm"),
@@ -156,6 +978,73 @@ def main(argv: list[str]) -> int:
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/db_bloom_filter.cc", out=out_root / "db/bloom_filter.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/db_btree_u64.cc", out=out_root / "db/btree_u64_100k.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/db_skiplist_u64.cc", out=out_root / "db/skiplist_u64_50k_ops_400k.wasm"),
+        BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/db_columnar_query.cc", out=out_root / "db/columnar_query_1m_x4.wasm"),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_hashmap_probe.cc",
+            out=out_root / "db/hashmap_linear_128k_1m.wasm",
+            cflags=("-DU2BENCH_HASHMAP_KIND=0",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_hashmap_probe.cc",
+            out=out_root / "db/hashmap_swiss_128k_1m.wasm",
+            cflags=("-DU2BENCH_HASHMAP_KIND=1",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_hashmap_probe.cc",
+            out=out_root / "db/hashmap_robinhood_128k_1m.wasm",
+            cflags=("-DU2BENCH_HASHMAP_KIND=2",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_hashmap_probe.cc",
+            out=out_root / "db/hashmap_cuckoo_128k_1m.wasm",
+            cflags=("-DU2BENCH_HASHMAP_KIND=3",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_bplustree_u64.cc",
+            out=out_root / "db/bplustree_ycsb_t4_200k.wasm",
+            cflags=("-DU2BENCH_BPT_T=4",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_bplustree_u64.cc",
+            out=out_root / "db/bplustree_ycsb_t16_200k.wasm",
+            cflags=("-DU2BENCH_BPT_T=16",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_bplustree_u64.cc",
+            out=out_root / "db/bplustree_ycsb_t64_200k.wasm",
+            cflags=("-DU2BENCH_BPT_T=64",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_bplustree_u64.cc",
+            out=out_root / "db/bplustree_ycsb_t128_200k.wasm",
+            cflags=("-DU2BENCH_BPT_T=128",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_lsm_kv.cc",
+            out=out_root / "db/lsm_kv_w90_ops_200k.wasm",
+            cflags=("-DU2BENCH_LSM_WRITE_PCT=90",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_lsm_kv.cc",
+            out=out_root / "db/lsm_kv_w50_ops_200k.wasm",
+            cflags=("-DU2BENCH_LSM_WRITE_PCT=50",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/db_lsm_kv.cc",
+            out=out_root / "db/lsm_kv_w10_ops_200k.wasm",
+            cflags=("-DU2BENCH_LSM_WRITE_PCT=10",),
+        ),
 
         # VM / interpreter-ish
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/vm_tinybytecode.cc", out=out_root / "vm/mini_lua_like_vm.wasm"),
@@ -175,6 +1064,25 @@ def main(argv: list[str]) -> int:
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/science_fft_f64.cc", out=out_root / "science/fft_f64_2048_x120.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/science_black_scholes_f64.cc", out=out_root / "science/black_scholes_f64_20k_x25.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/science_kmeans_f32.cc", out=out_root / "science/kmeans_f32_50k_k16_x25.wasm"),
+        BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/science_qnn_i8.cc", out=out_root / "science/qnn_i8_mobilenet_64_x40.wasm"),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/science_transformer_f32.cc",
+            out=out_root / "science/transformer_f32_seq64.wasm",
+            cflags=("-DU2BENCH_TF_SEQ=64",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/science_transformer_f32.cc",
+            out=out_root / "science/transformer_f32_seq256.wasm",
+            cflags=("-DU2BENCH_TF_SEQ=256",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/science_transformer_f32.cc",
+            out=out_root / "science/transformer_f32_seq512.wasm",
+            cflags=("-DU2BENCH_TF_SEQ=512",),
+        ),
         BuildUnit(
             kind="cc",
             src=repo_root / "wasm/src/cc/science_extra_suite.cc",
@@ -359,13 +1267,51 @@ def main(argv: list[str]) -> int:
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_div_sqrt_f64.cc", out=out_root / "micro/div_sqrt_f64.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_div_sqrt_f32.cc", out=out_root / "micro/div_sqrt_f32.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_malloc_free_small.cc", out=out_root / "micro/malloc_free_small_1m.wasm"),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/micro_alloc_suite.cc",
+            out=out_root / "micro/alloc_suite_dlmalloc.wasm",
+            cflags=("-DU2BENCH_ALLOCATOR=0",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/micro_alloc_suite.cc",
+            out=out_root / "micro/alloc_suite_arena.wasm",
+            cflags=("-DU2BENCH_ALLOCATOR=1",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/micro_alloc_suite.cc",
+            out=out_root / "micro/alloc_suite_slab.wasm",
+            cflags=("-DU2BENCH_ALLOCATOR=2",),
+        ),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_fnv1a_u64_fixedlen.cc", out=out_root / "micro/fnv1a_u64_fixedlen_80k_x10.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_utf8_validate.cc", out=out_root / "micro/utf8_validate_1m_x80.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_convert_i32_f64.cc", out=out_root / "micro/convert_i32_f64.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_convert_i64_f32.cc", out=out_root / "micro/convert_i64_f32.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_rle_u8.cc", out=out_root / "micro/rle_u8_4m_x10.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_base64_u8.cc", out=out_root / "micro/base64_u8_3m_x12.wasm"),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/micro_compress_codec.cc",
+            out=out_root / "micro/compress_lz4_4m_x3.wasm",
+            cflags=("-DU2BENCH_CODEC=0",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/micro_compress_codec.cc",
+            out=out_root / "micro/compress_huffman_4m_x3.wasm",
+            cflags=("-DU2BENCH_CODEC=1",),
+        ),
+        BuildUnit(
+            kind="cc",
+            src=repo_root / "wasm/src/cc/micro_compress_codec.cc",
+            out=out_root / "micro/compress_fse_4m_x3.wasm",
+            cflags=("-DU2BENCH_CODEC=2",),
+        ),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_json_tokenize.cc", out=out_root / "micro/json_tokenize_2m_x25.wasm"),
+        BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_json_dom.cc", out=out_root / "micro/json_dom_4docs_x5.wasm"),
+        BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_regex_log.cc", out=out_root / "micro/regex_log_9pat_3m_x2.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_varint_decode_u64.cc", out=out_root / "micro/varint_decode_u64_4m_x30.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_memcmp_libc_u8.cc", out=out_root / "micro/mem_cmp_libc_u8_4m_x32.wasm"),
         BuildUnit(kind="cc", src=repo_root / "wasm/src/cc/micro_memset_libc_u8.cc", out=out_root / "micro/mem_set_libc_u8_4m_x32.wasm"),
@@ -475,8 +1421,33 @@ def main(argv: list[str]) -> int:
         BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/science_alpha_expansion_i32.wat", out=out_root / "science/alpha_expansion_i32_96v_x72.wasm"),
         BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/science_riemann_euler1d_f32.wat", out=out_root / "science/riemann_euler1d_f32_192n_x96.wasm"),
         BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/science_hmm_forward_backward_f32.wat", out=out_root / "science/hmm_forward_backward_f32_48state_x1536.wasm"),
+
+        # Post-MVP proposals (WAT), kept out of the compatibility-first corpus
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/multi_value_ret_i32_x2.wat", out=prop_root / "multivalue/ret_i32_x2_5m.wasm", features=("multivalue",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/multi_value_ret_i32_x4.wat", out=prop_root / "multivalue/ret_i32_x4_5m.wasm", features=("multivalue",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/multi_value_ret_i32_x8.wat", out=prop_root / "multivalue/ret_i32_x8_5m.wasm", features=("multivalue",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/multi_value_ret_i32_x16.wat", out=prop_root / "multivalue/ret_i32_x16_5m.wasm", features=("multivalue",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/multi_value_ret_mixed_x4.wat", out=prop_root / "multivalue/ret_mixed_x4_5m.wasm", features=("multivalue",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/multi_value_block_params_i32.wat", out=prop_root / "multivalue/block_params_i32_20m.wasm", features=("multivalue",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/ref_types_table_get_set_i32.wat", out=prop_root / "reftypes/table_get_set_i32_5m.wasm", features=("reference-types",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/ref_types_ref_func_call_indirect_i32.wat", out=prop_root / "reftypes/ref_func_call_indirect_i32_5m.wasm", features=("reference-types",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/gc_struct_array_churn.wat", out=prop_root / "gc/struct_array_churn_20m.wasm", features=("gc",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/gc_linked_list_traverse.wat", out=prop_root / "gc/linked_list_50k_x100.wasm", features=("gc",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/gc_binary_trees.wat", out=prop_root / "gc/binary_trees_d16.wasm", features=("gc",)),
+        BuildUnit(kind="wat", src=repo_root / "wasm/src/wat/gc_ref_cast_dispatch.wat", out=prop_root / "gc/ref_cast_dispatch_20m.wasm", features=("gc",)),
     ]
 
+    if profile.features or not profile.wat:
+        units = [
+            replace(u, features=tuple(dict.fromkeys(u.features + profile.features)))
+            for u in units
+            if profile.wat or u.kind != "wat"
+        ]
+    if profile.src_prefixes:
+        units = [u for u in units if u.src.name.startswith(profile.src_prefixes)]
+    if profile.out_prefixes:
+        units = [u for u in units if u.out.name.startswith(profile.out_prefixes)]
+
     built = 0
     for u in units:
         if not u.src.exists():
@@ -484,10 +1455,35 @@ def main(argv: list[str]) -> int:
         if u.kind == "cc":
             build_cc(clangxx=args.clangxx, sysroot=sysroot, unit=u, verbose=args.verbose)
         elif u.kind == "wat":
-            build_wat(unit=u, verbose=args.verbose)
+            build_wat(unit=u, wasm_tools=args.wasm_tools, verbose=args.verbose)
         else:
             raise SystemExit(f"unknown kind: {u.kind}")
         built += 1
+    if "relaxed-simd" in profile.features:
+        require_relaxed_simd([u.out for u in units if u.kind == "cc"])
+
+    if profile.features:
+        # runbench.py reads this to probe engines for the tree-wide proposals before running it.
+        out_root.mkdir(parents=True, exist_ok=True)
+        (out_root / "u2bench_profile.json").write_text(
+            json.dumps(
+                {"profile": args.profile, "features": list(with_feature_dependencies(profile.features))}, indent=2
+            )
+            + "\n",
+            encoding="utf-8",
+        )
+    prop_dirs: dict[str, list[str]] = {}
+    for u in units:
+        if u.out.is_relative_to(prop_root):
+            feats = prop_dirs.setdefault(u.out.relative_to(prop_root).parts[0], [])
+            feats.extend(f for f in with_feature_dependencies(u.features) if f not in feats)
+    if prop_dirs:
+        # The proposals tree mixes proposals per family directory; runbench tags each module with its
+        # directory's list (dependencies included) so the gated-proposal probe covers all of them.
+        prop_root.mkdir(parents=True, exist_ok=True)
+        (prop_root / "u2bench_profile.json").write_text(
+            json.dumps({"profile": "proposals", "features": [], "dirs": prop_dirs}, indent=2) + "\n", encoding="utf-8"
+        )
 
     print(f"built {built} wasm files under: {out_root}")
     return 0
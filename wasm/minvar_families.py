@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""
+Parametric templates for the `legacy_minvar_microbenches/` families.
+
+Each family recreates one prebuilt legacy shape from a single size parameter (locals, params or
+operand-stack depth), wrapped in the WASI timing scaffold so it prints `Time:` plus
+`Metric: param <n>` / `Metric: iters <n>`. Modules are named `<stem>_<param>_<iters>.wasm`, where the
+stem carries the value type for typed families (e.g. `inloop_deepstack_i32_high_255_1000000.wasm`).
+
+Unlike the legacy modules, the pushed values are folded into a loop-carried value that is stored to wb.SINK
+instead of being dropped. The fold alternates add with xor (sub for f64), so optimizing tiers can neither delete
+the loop nor collapse the chain, and deepstack curves stay meaningful for JIT/AOT engines too. The keepstack
+families are the exception: their loop body is a `nop` or an empty call, so an optimizing tier reduces the loop
+whatever the result depends on. Their curves only measure interpreters.
+"""
+
+from __future__ import annotations
+
+from dataclasses import dataclass
+from typing import Callable
+
+import wasm_binary as wb
+
+VALTYPES = {"i32": wb.I32, "i64": wb.I64, "f64": wb.F64}
+_LCG_MUL = 1664525
+_LCG_ADD = 1013904223
+
+# Dense around the 4-bit / 8-bit / 16-bit operand encodings interpreters like to use (255/256 locals or slots).
+_DEPTHS = [*range(1, 17), 20, 24, 32, 48, 64, 96, 120, *range(124, 131), 192, 240, *range(250, 259), 300]
+_LOCALS = [0, 32, 64, 96, 128, 160, 192, 224, *range(240, 261), 288, 320, 384, 512]
+_OFFSETS = [*range(0, 17), 31, 32, 63, 64, 127, 128, 255, 256, 511, 512, 1023, 1024, 2047, 2048, 4095, 4096]
+
+
+def _const(ty: str, v: int) -> tuple[str, int | float]:
+    return ("f64.const", float(v)) if ty == "f64" else (f"{ty}.const", v)
+
+
+def _add(ty: str) -> str:
+    return f"{ty}.add"
+
+
+def _store(ty: str) -> str:
+    return f"{ty}.store"
+
+
+def _fold_op(ty: str, k: int) -> str:
+    """Op folding the k-th pushed value: add for odd k, else xor (sub for f64), so neighbours never merge."""
+
+    if k % 2:
+        return _add(ty)
+    return "f64.sub" if ty == "f64" else f"{ty}.xor"
+
+
+def _counted_loop(body: bytes, iters: int) -> bytes:
+    """`loop body; ++local0 < iters` with local 0 as the i32 counter (set to 0 first)."""
+
+    return (
+        wb.code(("i32.const", 0), ("local.set", 0), "loop")
+        + body
+        + wb.code(
+            ("local.get", 0), ("i32.const", 1), "i32.add", ("local.tee", 0),
+            ("i32.const", iters), "i32.lt_u", ("br_if", 0),
+            "end",
+        )
+    )  # fmt: skip
+
+
+def _push_fold(ty: str, depth: int, shape: str, acc: bytes) -> bytes:
+    """
+    Fold `depth` values (the running value pushed by `acc`, plus depth - 1 constants) into one, left on the stack.
+
+    `high`: push the constants, then acc, so all depth values are live at once, then fold them top-down;
+    `low`: push acc, then fold one const/op pair at a time (depth stays at most 2).
+    """
+
+    ops = [_fold_op(ty, k) for k in range(1, depth)]
+    if shape == "high":
+        return wb.code(*(_const(ty, k) for k in range(1, depth))) + acc + wb.code(*reversed(ops))
+    return acc + b"".join(wb.code(_const(ty, k), op) for k, op in enumerate(ops, start=1))
+
+
+# A template returns (extra types, [(type index, body)], bench function index), per wb.wasi_timed_module.
+Template = Callable[[str, int, int], tuple[list[bytes], list[tuple[int, bytes]], int]]
+
+
+def _call_locals(touch_last: bool) -> Template:
+    def build(ty: str, n: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+        # callee: (i32, i32) -> i32 with n extra i32 locals; `last` also reads the highest-numbered one.
+        callee = wb.code(("local.get", 0), ("local.get", 1), "i32.xor")
+        if touch_last and n:
+            callee += wb.code(("local.get", n + 1), "i32.xor")
+        # driver locals: 0 i, 1 x (LCG), 2 acc
+        loop = wb.code(
+            ("local.get", 2), ("local.get", 1), ("call", wb.FIRST_FUNC + 1), ("local.set", 2),
+            ("local.get", 1), ("i32.const", _LCG_MUL), "i32.mul", ("i32.const", _LCG_ADD), "i32.add", ("local.set", 1),
+        )  # fmt: skip
+        driver = (
+            wb.code(("i32.const", 1), ("local.set", 1))
+            + _counted_loop(loop, iters)
+            + wb.code(("i32.const", wb.SINK), ("local.get", 2), ("i32.store", 0), "end")
+        )
+        return (
+            [wb.functype([wb.I32, wb.I32], [wb.I32])],
+            [
+                (wb.VOID_TYPE, wb.func_body(driver, [(3, wb.I32)])),
+                (wb.FIRST_TYPE, wb.func_body(callee + wb.code("end"), [(n, wb.I32)] if n else [])),
+            ],
+            wb.FIRST_FUNC,
+        )
+
+    return build
+
+
+def _call_params(ty: str, n: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+    # callee: (i32 x n) -> i32 returning param 0; args are acc, x, then constants.
+    args = [("local.get", 2), ("local.get", 1), *(("i32.const", k) for k in range(2, max(n, 2)))][:n]
+    loop = wb.code(
+        *args, ("call", wb.FIRST_FUNC + 1), ("local.set", 2),
+        ("local.get", 1), ("i32.const", _LCG_MUL), "i32.mul", ("i32.const", _LCG_ADD), "i32.add", ("local.set", 1),
+    )  # fmt: skip
+    driver = (
+        wb.code(("i32.const", 1), ("local.set", 1))
+        + _counted_loop(loop, iters)
+        + wb.code(("i32.const", wb.SINK), ("local.get", 2), ("i32.store", 0), "end")
+    )
+    return (
+        [wb.functype([wb.I32] * n, [wb.I32])],
+        [
+            (wb.VOID_TYPE, wb.func_body(driver, [(3, wb.I32)])),
+            (wb.FIRST_TYPE, wb.func_body(wb.code(("local.get", 0), "end"))),
+        ],
+        wb.FIRST_FUNC,
+    )
+
+
+def _call_deepstack(shape: str) -> Template:
+    def build(ty: str, depth: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+        # callee: (ty) -> ty, folds `depth` values into its argument; driver locals: 0 i, 1 acc (ty)
+        callee = _push_fold(ty, depth, shape, wb.code(("local.get", 0))) + wb.code("end")
+        loop = wb.code(("local.get", 1), ("call", wb.FIRST_FUNC + 1), ("local.set", 1))
+        driver = _counted_loop(loop, iters) + wb.code(
+            ("i32.const", wb.SINK), ("local.get", 1), (_store(ty), 0), "end"
+        )
+        vt = VALTYPES[ty]
+        return (
+            [wb.functype([vt], [vt])],
+            [
+                (wb.VOID_TYPE, wb.func_body(driver, [(1, wb.I32), (1, vt)])),
+                (wb.FIRST_TYPE, wb.func_body(callee)),
+            ],
+            wb.FIRST_FUNC,
+        )
+
+    return build
+
+
+def _inloop_deepstack(shape: str) -> Template:
+    def build(ty: str, depth: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+        # locals: 0 i, 1 acc (ty)
+        loop = _push_fold(ty, depth, shape, wb.code(("local.get", 1))) + wb.code(("local.set", 1))
+        driver = _counted_loop(loop, iters) + wb.code(
+            ("i32.const", wb.SINK), ("local.get", 1), (_store(ty), 0), "end"
+        )
+        return [], [(wb.VOID_TYPE, wb.func_body(driver, [(1, wb.I32), (1, VALTYPES[ty])]))], wb.FIRST_FUNC
+
+    return build
+
+
+def _keepstack(body_op: str) -> Template:
+    def build(ty: str, depth: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+        # `depth` values stay live on the operand stack across the whole loop, then are folded into the
+        # stored result. The body does no work, so only interpreters keep the loop (see the module docstring).
+        # FIRST_FUNC + 1 is an empty `() -> ()` function for the `call` flavour; locals: 0 i, 1 acc (ty).
+        op = wb.code(("call", wb.FIRST_FUNC + 1)) if body_op == "call" else wb.code("nop")
+        driver = (
+            wb.code(("i32.const", wb.SINK), *(_const(ty, k) for k in range(1, depth + 1)))
+            + _counted_loop(op, iters)
+            + wb.code(("local.get", 1), *([_fold_op(ty, 1)] * depth), (_store(ty), 0), "end")
+        )
+        return (
+            [],
+            [
+                (wb.VOID_TYPE, wb.func_body(driver, [(1, wb.I32), (1, VALTYPES[ty])])),
+                (wb.VOID_TYPE, wb.func_body(wb.code("end"))),
+            ],
+            wb.FIRST_FUNC,
+        )
+
+    return build
+
+
+def _stack_reduce(ty: str, n: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+    # locals: 0 i, 1..n values; each iteration folds all n onto local 1 with a right-nested add chain.
+    vt = VALTYPES[ty]
+    init = b"".join(wb.code(_const(ty, k), ("local.set", k)) for k in range(1, n + 1))
+    loop = wb.code(
+        *(("local.get", k) for k in range(1, n + 1)),
+        *([_add(ty)] * (n - 1)),
+        ("local.get", 1), _add(ty), ("local.set", 1),
+    )  # fmt: skip
+    driver = init + _counted_loop(loop, iters) + wb.code(("i32.const", wb.SINK), ("local.get", 1), (_store(ty), 0), "end")
+    return [], [(wb.VOID_TYPE, wb.func_body(driver, [(1, wb.I32), (n, vt)]))], wb.FIRST_FUNC
+
+
+def _local_offset(ty: str, off: int, iters: int) -> tuple[list[bytes], list[tuple[int, bytes]], int]:
+    # locals: 0 i, then `off` unused ones, then the incremented local at index off + 1.
+    k = off + 1
+    loop = wb.code(("local.get", k), ("i32.const", 1), "i32.add", ("local.set", k))
+    driver = (
+        wb.code(("i32.const", 1), ("local.set", k))
+        + _counted_loop(loop, iters)
+        + wb.code(("i32.const", wb.SINK), ("local.get", k), ("i32.store", 0), "end")
+    )
+    return [], [(wb.VOID_TYPE, wb.func_body(driver, [(k + 1, wb.I32)]))], wb.FIRST_FUNC
+
+
+@dataclass(frozen=True)
+class Family:
+    name: str
+    kind: str  # bench_kind for classify_bench()
+    params: tuple[int, ...]  # default sweep
+    iters: int
+    template: Template
+    typed: bool = False  # stem carries the value type; otherwise always i32
+    stem_fmt: str = "{name}"
+
+    def stem(self, ty: str) -> str:
+        return self.stem_fmt.format(name=self.name, ty=ty)
+
+
+FAMILIES: dict[str, Family] = {
+    f.name: f
+    for f in [
+        Family("call_locals_thr", "call_dense", tuple(_LOCALS), 20_000_000, _call_locals(False)),
+        Family("call_locals_last", "call_dense", tuple(_LOCALS), 20_000_000, _call_locals(True)),
+        Family("call_params", "call_dense", (1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 24, 32), 30_000_000, _call_params),
+        Family(
+            "call_deepstack_low", "call_dense", tuple(_DEPTHS), 1_000_000, _call_deepstack("low"),
+            typed=True, stem_fmt="call_deepstack_{ty}_low",
+        ),
+        Family(
+            "call_deepstack_high", "call_dense", tuple(_DEPTHS), 1_000_000, _call_deepstack("high"),
+            typed=True, stem_fmt="call_deepstack_{ty}_high",
+        ),
+        Family(
+            "inloop_deepstack_low", "operand_stack_dense", tuple(_DEPTHS), 1_000_000, _inloop_deepstack("low"),
+            typed=True, stem_fmt="inloop_deepstack_{ty}_low",
+        ),
+        Family(
+            "inloop_deepstack_high", "operand_stack_dense", tuple(_DEPTHS), 1_000_000, _inloop_deepstack("high"),
+            typed=True, stem_fmt="inloop_deepstack_{ty}_high",
+        ),
+        Family(
+            "keepstack_nop", "operand_stack_dense", (*range(0, 11), 16, 32, 64, 128, 255, 256), 100_000_000,
+            _keepstack("nop"), typed=True, stem_fmt="keepstack_{ty}_nop",
+        ),
+        Family(
+            "keepstack_call", "call_dense", (*range(0, 11), 16, 32, 64, 128, 255, 256), 100_000_000,
+            _keepstack("call"), typed=True, stem_fmt="keepstack_{ty}_call",
+        ),
+        Family(
+            "stack_reduce", "operand_stack_dense", (*range(2, 17), 20, 24, 32, 48, 64), 20_000_000, _stack_reduce,
+            typed=True, stem_fmt="stack_reduce_{ty}",
+        ),
+        Family("local_offset", "local_dense", tuple(_OFFSETS), 20_000_000, _local_offset, stem_fmt="local_offset_i32"),
+    ]
+}  # fmt: skip
+
+
+def module_name(fam: Family, ty: str, param: int, iters: int) -> str:
+    return f"{fam.stem(ty)}_{param}_{iters}.wasm"
+
+
+def module_bytes(fam: Family, ty: str, param: int, iters: int) -> bytes:
+    types, funcs, bench = fam.template(ty, param, iters)
+    return wb.wasi_timed_module(
+        types=types, funcs=funcs, bench=bench, metrics=[("param", param), ("iters", iters)]
+    )
+
+
+def parse_params(spec: str) -> list[int]:
+    """`4,8,250:260,256:4096:256` -> explicit values and inclusive lo:hi[:step] ranges."""
+
+    out: list[int] = []
+    for part in (p.strip() for p in spec.split(",")):
+        if not part:
+            continue
+        if ":" in part:
+            lo, hi, *step = (int(x) for x in part.split(":"))
+            out.extend(range(lo, hi + 1, step[0] if step else 1))
+        else:
+            out.append(int(part))
+    return sorted(set(out))
@@ -21,6 +21,12 @@ static inline void u2bench_print_time_ms(double ms) {
     printf("Time: %.3f ms\n", ms);
 }
 
+// Extra guest-reported value, picked up by runbench.py as guest_metrics[name].
+// Float guests report their checksum as "result" so builds can be checked for drift.
+static inline void u2bench_print_metric(const char* name, double v) {
+    printf("Metric: %s %.17g\n", name, v);
+}
+
 static inline void u2bench_sink_u64(uint64_t v) {
     static volatile uint64_t sink = 0;
     sink ^= v + 0x9e3779b97f4a7c15ull;
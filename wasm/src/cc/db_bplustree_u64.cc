@@ -0,0 +1,590 @@
+#include "bench_common.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// B+tree (u64 -> u64) with linked leaves, range scans and deletes with borrow/merge rebalancing, driven by
+// YCSB-style phases over 200k records:
+//   load   insert all records
+//   A      50% read / 50% update (zipfian)
+//   B      95% read / 5% update (zipfian)
+//   C      100% read (zipfian)
+//   E      95% range scan of 1..100 rows / 5% insert (zipfian start key)
+//   churn  delete a random record if present, else re-insert it (drives leaf/inner underflow fixes)
+// U2BENCH_BPT_T is the minimum degree: nodes hold kT-1 .. 2*kT keys, so kT sweeps node size across cache lines.
+// Reads and scans are checked against a shadow value table; the final tree is checked structurally.
+#ifndef U2BENCH_BPT_T
+#define U2BENCH_BPT_T 16
+#endif
+
+namespace {
+
+constexpr int kT = U2BENCH_BPT_T;
+constexpr int kMax = 2 * kT;
+constexpr int kMin = kT - 1;
+static_assert(kT >= 2, "U2BENCH_BPT_T must be >= 2");
+
+constexpr uint32_t kRecords = 200000;
+constexpr uint32_t kOps = 200000;
+constexpr uint32_t kScanOps = kOps / 10;
+constexpr uint32_t kMaxScan = 100;
+constexpr uint32_t kMaxRecords = kRecords + kScanOps + kOps;
+constexpr uint32_t kNil = 0xffffffffu;
+
+struct Leaf {
+    uint32_t n;
+    uint32_t prev;
+    uint32_t next;
+    uint64_t keys[kMax];
+    uint64_t vals[kMax];
+};
+
+struct Inner {
+    uint32_t n;
+    uint64_t keys[kMax];  // child[i] < keys[i] <= child[i + 1]
+    uint32_t child[kMax + 1];
+};
+
+template <class N>
+struct Pool {
+    N* nodes = nullptr;
+    uint32_t* free_ids = nullptr;
+    uint32_t cap = 0;
+    uint32_t fresh = 0;
+    uint32_t free_n = 0;
+
+    bool init(uint32_t c) {
+        cap = c;
+        nodes = (N*)malloc((size_t)c * sizeof(N));
+        free_ids = (uint32_t*)calloc((size_t)c, sizeof(uint32_t));
+        return nodes && free_ids;
+    }
+    uint32_t alloc() {
+        const uint32_t id = free_n ? free_ids[--free_n] : fresh++;
+        if (id >= cap) {
+            printf("node pool exhausted\n");
+            exit(1);
+        }
+        return id;
+    }
+    void release(uint32_t id) { free_ids[free_n++] = id; }
+    N& operator[](uint32_t id) { return nodes[id]; }
+};
+
+struct Stats {
+    uint64_t splits = 0;
+    uint64_t borrows = 0;
+    uint64_t merges = 0;
+};
+
+inline int lower_bound(const uint64_t* keys, int n, uint64_t k) {
+    int lo = 0;
+    int hi = n;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (keys[mid] < k) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+inline int upper_bound(const uint64_t* keys, int n, uint64_t k) {
+    int lo = 0;
+    int hi = n;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (keys[mid] <= k) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+struct Split {
+    bool split;
+    uint64_t sep;
+    uint32_t right;
+};
+
+struct BPlusTree {
+    Pool<Leaf> leaves;
+    Pool<Inner> inners;
+    uint32_t root = kNil;
+    int height = 0;  // 0: root is a leaf
+    uint32_t size = 0;
+    Stats stats;
+
+    bool init() {
+        const uint32_t cap = kMaxRecords / (uint32_t)kMin + 64;
+        if (!leaves.init(cap) || !inners.init(cap)) return false;
+        root = leaves.alloc();
+        leaves[root].n = 0;
+        leaves[root].prev = kNil;
+        leaves[root].next = kNil;
+        return true;
+    }
+
+    void destroy() {
+        free(leaves.nodes);
+        free(leaves.free_ids);
+        free(inners.nodes);
+        free(inners.free_ids);
+    }
+
+    uint32_t find_leaf(uint64_t k) {
+        uint32_t id = root;
+        for (int level = height; level > 0; --level) {
+            const Inner& x = inners[id];
+            id = x.child[upper_bound(x.keys, (int)x.n, k)];
+        }
+        return id;
+    }
+
+    bool get(uint64_t k, uint64_t* out) {
+        const Leaf& l = leaves[find_leaf(k)];
+        const int i = lower_bound(l.keys, (int)l.n, k);
+        if (i < (int)l.n && l.keys[i] == k) {
+            *out = l.vals[i];
+            return true;
+        }
+        return false;
+    }
+
+    // Visits up to `count` rows with key >= k in key order; returns the number visited.
+    template <class F>
+    uint32_t scan(uint64_t k, uint32_t count, F&& visit) {
+        uint32_t id = find_leaf(k);
+        int i = lower_bound(leaves[id].keys, (int)leaves[id].n, k);
+        uint32_t done = 0;
+        while (done < count && id != kNil) {
+            const Leaf& l = leaves[id];
+            for (; i < (int)l.n && done < count; ++i, ++done) visit(l.keys[i], l.vals[i]);
+            id = l.next;
+            i = 0;
+        }
+        return done;
+    }
+
+    Split leaf_insert(uint32_t id, uint64_t k, uint64_t v, bool* added) {
+        Leaf* l = &leaves[id];
+        int i = lower_bound(l->keys, (int)l->n, k);
+        if (i < (int)l->n && l->keys[i] == k) {
+            l->vals[i] = v;
+            *added = false;
+            return Split{false, 0, kNil};
+        }
+        *added = true;
+        Split s{false, 0, kNil};
+        if ((int)l->n == kMax) {
+            const uint32_t rid = leaves.alloc();
+            Leaf* r = &leaves[rid];
+            r->n = (uint32_t)(kMax - kT);
+            memcpy(r->keys, l->keys + kT, (size_t)(kMax - kT) * sizeof(uint64_t));
+            memcpy(r->vals, l->vals + kT, (size_t)(kMax - kT) * sizeof(uint64_t));
+            l->n = (uint32_t)kT;
+            r->prev = id;
+            r->next = l->next;
+            if (l->next != kNil) leaves[l->next].prev = rid;
+            l->next = rid;
+            ++stats.splits;
+            s = Split{true, r->keys[0], rid};
+            if (i > kT) {
+                l = r;
+                i -= kT;
+            }
+        }
+        memmove(l->keys + i + 1, l->keys + i, (size_t)(l->n - (uint32_t)i) * sizeof(uint64_t));
+        memmove(l->vals + i + 1, l->vals + i, (size_t)(l->n - (uint32_t)i) * sizeof(uint64_t));
+        l->keys[i] = k;
+        l->vals[i] = v;
+        ++l->n;
+        if (s.split) s.sep = leaves[s.right].keys[0];
+        return s;
+    }
+
+    Split insert_rec(uint32_t id, int level, uint64_t k, uint64_t v, bool* added) {
+        if (level == 0) return leaf_insert(id, k, v, added);
+        const int i = upper_bound(inners[id].keys, (int)inners[id].n, k);
+        const Split s = insert_rec(inners[id].child[i], level - 1, k, v, added);
+        if (!s.split) return s;
+        Inner* x = &inners[id];
+        if ((int)x->n < kMax) {
+            memmove(x->keys + i + 1, x->keys + i, (size_t)(x->n - (uint32_t)i) * sizeof(uint64_t));
+            memmove(x->child + i + 2, x->child + i + 1, (size_t)(x->n - (uint32_t)i) * sizeof(uint32_t));
+            x->keys[i] = s.sep;
+            x->child[i + 1] = s.right;
+            ++x->n;
+            return Split{false, 0, kNil};
+        }
+        // Full: lay out kMax + 1 keys, keep kT on the left, promote one, move kT to a new right node.
+        uint64_t tk[kMax + 1];
+        uint32_t tc[kMax + 2];
+        memcpy(tk, x->keys, (size_t)i * sizeof(uint64_t));
+        tk[i] = s.sep;
+        memcpy(tk + i + 1, x->keys + i, (size_t)(kMax - i) * sizeof(uint64_t));
+        memcpy(tc, x->child, (size_t)(i + 1) * sizeof(uint32_t));
+        tc[i + 1] = s.right;
+        memcpy(tc + i + 2, x->child + i + 1, (size_t)(kMax - i) * sizeof(uint32_t));
+        const uint32_t rid = inners.alloc();
+        x = &inners[id];
+        Inner* r = &inners[rid];
+        x->n = (uint32_t)kT;
+        memcpy(x->keys, tk, (size_t)kT * sizeof(uint64_t));
+        memcpy(x->child, tc, (size_t)(kT + 1) * sizeof(uint32_t));
+        r->n = (uint32_t)(kMax - kT);
+        memcpy(r->keys, tk + kT + 1, (size_t)(kMax - kT) * sizeof(uint64_t));
+        memcpy(r->child, tc + kT + 1, (size_t)(kMax - kT + 1) * sizeof(uint32_t));
+        ++stats.splits;
+        return Split{true, tk[kT], rid};
+    }
+
+    void put(uint64_t k, uint64_t v) {
+        bool added = false;
+        const Split s = insert_rec(root, height, k, v, &added);
+        if (s.split) {
+            const uint32_t nid = inners.alloc();
+            Inner& x = inners[nid];
+            x.n = 1;
+            x.keys[0] = s.sep;
+            x.child[0] = root;
+            x.child[1] = s.right;
+            root = nid;
+            ++height;
+        }
+        size += added ? 1u : 0u;
+    }
+
+    uint32_t node_n(uint32_t id, int level) { return level == 0 ? leaves[id].n : inners[id].n; }
+
+    void remove_from_parent(Inner* p, int key_idx) {
+        memmove(p->keys + key_idx, p->keys + key_idx + 1, (size_t)(p->n - (uint32_t)key_idx - 1) * sizeof(uint64_t));
+        memmove(p->child + key_idx + 1, p->child + key_idx + 2,
+                (size_t)(p->n - (uint32_t)key_idx - 1) * sizeof(uint32_t));
+        --p->n;
+    }
+
+    // Merges p->child[li + 1] into p->child[li] (level of the children: clevel).
+    void merge(Inner* p, int li, int clevel) {
+        const uint32_t lid = p->child[li];
+        const uint32_t rid = p->child[li + 1];
+        if (clevel == 0) {
+            Leaf& l = leaves[lid];
+            Leaf& r = leaves[rid];
+            memcpy(l.keys + l.n, r.keys, (size_t)r.n * sizeof(uint64_t));
+            memcpy(l.vals + l.n, r.vals, (size_t)r.n * sizeof(uint64_t));
+            l.n += r.n;
+            l.next = r.next;
+            if (r.next != kNil) leaves[r.next].prev = lid;
+            leaves.release(rid);
+        } else {
+            Inner& l = inners[lid];
+            Inner& r = inners[rid];
+            l.keys[l.n] = p->keys[li];
+            memcpy(l.keys + l.n + 1, r.keys, (size_t)r.n * sizeof(uint64_t));
+            memcpy(l.child + l.n + 1, r.child, (size_t)(r.n + 1) * sizeof(uint32_t));
+            l.n += 1 + r.n;
+            inners.release(rid);
+        }
+        remove_from_parent(p, li);
+        ++stats.merges;
+    }
+
+    // Moves one entry from p->child[from] into its underflowed neighbour p->child[to] (|from - to| == 1).
+    void borrow(Inner* p, int to, int from, int clevel) {
+        const int sep = to < from ? to : from;
+        if (clevel == 0) {
+            Leaf& c = leaves[p->child[to]];
+            Leaf& s = leaves[p->child[from]];
+            if (from < to) {
+                memmove(c.keys + 1, c.keys, (size_t)c.n * sizeof(uint64_t));
+                memmove(c.vals + 1, c.vals, (size_t)c.n * sizeof(uint64_t));
+                c.keys[0] = s.keys[s.n - 1];
+                c.vals[0] = s.vals[s.n - 1];
+                p->keys[sep] = c.keys[0];
+            } else {
+                c.keys[c.n] = s.keys[0];
+                c.vals[c.n] = s.vals[0];
+                memmove(s.keys, s.keys + 1, (size_t)(s.n - 1) * sizeof(uint64_t));
+                memmove(s.vals, s.vals + 1, (size_t)(s.n - 1) * sizeof(uint64_t));
+                p->keys[sep] = s.keys[0];
+            }
+            ++c.n;
+            --s.n;
+        } else {
+            Inner& c = inners[p->child[to]];
+            Inner& s = inners[p->child[from]];
+            if (from < to) {
+                memmove(c.keys + 1, c.keys, (size_t)c.n * sizeof(uint64_t));
+                memmove(c.child + 1, c.child, (size_t)(c.n + 1) * sizeof(uint32_t));
+                c.keys[0] = p->keys[sep];
+                c.child[0] = s.child[s.n];
+                p->keys[sep] = s.keys[s.n - 1];
+            } else {
+                c.keys[c.n] = p->keys[sep];
+                c.child[c.n + 1] = s.child[0];
+                p->keys[sep] = s.keys[0];
+                memmove(s.keys, s.keys + 1, (size_t)(s.n - 1) * sizeof(uint64_t));
+                memmove(s.child, s.child + 1, (size_t)s.n * sizeof(uint32_t));
+            }
+            ++c.n;
+            --s.n;
+        }
+        ++stats.borrows;
+    }
+
+    void fix_underflow(uint32_t pid, int i, int clevel) {
+        Inner* p = &inners[pid];
+        if (i > 0) {
+            if ((int)node_n(p->child[i - 1], clevel) > kMin) {
+                borrow(p, i, i - 1, clevel);
+            } else {
+                merge(p, i - 1, clevel);
+            }
+        } else {
+            if ((int)node_n(p->child[1], clevel) > kMin) {
+                borrow(p, 0, 1, clevel);
+            } else {
+                merge(p, 0, clevel);
+            }
+        }
+    }
+
+    bool erase_rec(uint32_t id, int level, uint64_t k) {
+        if (level == 0) {
+            Leaf& l = leaves[id];
+            const int i = lower_bound(l.keys, (int)l.n, k);
+            if (i >= (int)l.n || l.keys[i] != k) return false;
+            memmove(l.keys + i, l.keys + i + 1, (size_t)(l.n - (uint32_t)i - 1) * sizeof(uint64_t));
+            memmove(l.vals + i, l.vals + i + 1, (size_t)(l.n - (uint32_t)i - 1) * sizeof(uint64_t));
+            --l.n;
+            return true;
+        }
+        const int i = upper_bound(inners[id].keys, (int)inners[id].n, k);
+        if (!erase_rec(inners[id].child[i], level - 1, k)) return false;
+        if ((int)node_n(inners[id].child[i], level - 1) < kMin) fix_underflow(id, i, level - 1);
+        return true;
+    }
+
+    bool erase(uint64_t k) {
+        if (!erase_rec(root, height, k)) return false;
+        if (height > 0 && inners[root].n == 0) {
+            const uint32_t old = root;
+            root = inners[old].child[0];
+            inners.release(old);
+            --height;
+        }
+        --size;
+        return true;
+    }
+
+    // Checks key order, fill bounds, uniform depth and the leaf chain; returns false on any violation.
+    bool check_rec(uint32_t id, int level, bool is_root, uint64_t lo, uint64_t hi, bool has_lo, bool has_hi,
+                   uint32_t* rows) {
+        const uint64_t* keys = level == 0 ? leaves[id].keys : inners[id].keys;
+        const int n = (int)node_n(id, level);
+        if (n > kMax || (!is_root && n < kMin)) return false;
+        for (int i = 0; i < n; ++i) {
+            if (i > 0 && keys[i - 1] >= keys[i]) return false;
+            if ((has_lo && keys[i] < lo) || (has_hi && keys[i] >= hi)) return false;
+        }
+        if (level == 0) {
+            *rows += (uint32_t)n;
+            return true;
+        }
+        for (int i = 0; i <= n; ++i) {
+            const bool clo = i > 0 || has_lo;
+            const bool chi = i < n || has_hi;
+            if (!check_rec(inners[id].child[i], level - 1, false, i > 0 ? keys[i - 1] : lo, i < n ? keys[i] : hi, clo,
+                           chi, rows)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool check() {
+        uint32_t rows = 0;
+        if (!check_rec(root, height, true, 0, 0, false, false, &rows) || rows != size) return false;
+        uint32_t id = find_leaf(0);
+        uint32_t chained = 0;
+        uint32_t prev = kNil;
+        bool have_last = false;
+        uint64_t last = 0;
+        for (; id != kNil; prev = id, id = leaves[id].next) {
+            if (leaves[id].prev != prev) return false;
+            for (uint32_t i = 0; i < leaves[id].n; ++i) {
+                if (have_last && leaves[id].keys[i] <= last) return false;
+                last = leaves[id].keys[i];
+                have_last = true;
+            }
+            chained += leaves[id].n;
+        }
+        return chained == size;
+    }
+};
+
+// YCSB scrambled zipfian (theta 0.99) over [0, n).
+struct Zipfian {
+    uint64_t n = 0;
+    double theta = 0.99;
+    double alpha = 0.0;
+    double zetan = 0.0;
+    double eta = 0.0;
+    uint64_t state = 0x5eedull;
+
+    void init(uint64_t items) {
+        n = items;
+        double zeta2 = 0.0;
+        for (uint64_t i = 1; i <= n; ++i) {
+            const double t = 1.0 / pow((double)i, theta);
+            zetan += t;
+            if (i <= 2) zeta2 += t;
+        }
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    uint64_t next() {
+        state = u2bench_splitmix64(state);
+        const double u = (double)(state >> 11) * (1.0 / 9007199254740992.0);
+        const double uz = u * zetan;
+        uint64_t rank;
+        if (uz < 1.0) {
+            rank = 0;
+        } else if (uz < 1.0 + pow(0.5, theta)) {
+            rank = 1;
+        } else {
+            rank = (uint64_t)((double)n * pow(eta * u - eta + 1.0, alpha));
+            if (rank >= n) rank = n - 1;
+        }
+        return u2bench_splitmix64(rank ^ 0xc0ffeeull) % n;
+    }
+};
+
+inline uint64_t key_of(uint32_t rec) {
+    return u2bench_splitmix64((uint64_t)rec * 0x2545f4914f6cdd1dull) | 1ull;
+}
+
+}  // namespace
+
+int main() {
+    static BPlusTree t;
+    uint64_t* shadow = (uint64_t*)calloc(kMaxRecords, sizeof(uint64_t));  // value per record, 0 = absent
+    if (!t.init() || !shadow) {
+        printf("alloc failed\n");
+        return 1;
+    }
+    Zipfian zipf;
+    zipf.init(kRecords);
+
+    uint64_t errors = 0;
+    uint64_t sum = 0;
+    uint64_t rows_scanned = 0;
+    uint32_t rng = 0x9e3779b9u;
+    uint64_t version = 0;
+    uint32_t records = 0;
+    auto write = [&](uint32_t rec) {
+        const uint64_t v = u2bench_splitmix64(++version) | 1ull;
+        shadow[rec] = v;
+        t.put(key_of(rec), v);
+    };
+    auto read = [&](uint32_t rec) {
+        uint64_t v = 0;
+        const bool hit = t.get(key_of(rec), &v);
+        errors += hit ? (v != shadow[rec]) : (shadow[rec] != 0);
+        sum += v;
+    };
+    // Read/update mix; returns elapsed ns.
+    auto mix = [&](uint32_t read_pct) {
+        const uint64_t t0 = u2bench_now_ns();
+        for (uint32_t i = 0; i < kOps; ++i) {
+            const uint32_t rec = (uint32_t)zipf.next();
+            if (u2bench_xorshift32(&rng) % 100u < read_pct) {
+                read(rec);
+            } else {
+                write(rec);
+            }
+        }
+        return u2bench_now_ns() - t0;
+    };
+
+    uint64_t phase_ns[6];
+    uint64_t t0 = u2bench_now_ns();
+    for (; records < kRecords; ++records) write(records);
+    phase_ns[0] = u2bench_now_ns() - t0;
+
+    phase_ns[1] = mix(50);
+    phase_ns[2] = mix(95);
+    phase_ns[3] = mix(100);
+
+    t0 = u2bench_now_ns();
+    for (uint32_t i = 0; i < kScanOps; ++i) {
+        if (u2bench_xorshift32(&rng) % 100u < 95u) {
+            const uint32_t len = 1 + u2bench_xorshift32(&rng) % kMaxScan;
+            bool have_last = false;
+            uint64_t last = 0;
+            rows_scanned += t.scan(key_of((uint32_t)zipf.next()), len, [&](uint64_t k, uint64_t v) {
+                errors += have_last && k <= last;
+                have_last = true;
+                last = k;
+                sum += v;
+            });
+        } else {
+            write(records++);
+        }
+    }
+    phase_ns[4] = u2bench_now_ns() - t0;
+
+    t0 = u2bench_now_ns();
+    for (uint32_t i = 0; i < kOps; ++i) {
+        const uint32_t rec = u2bench_xorshift32(&rng) % records;
+        if (shadow[rec] != 0) {
+            errors += !t.erase(key_of(rec));
+            shadow[rec] = 0;
+        } else {
+            write(rec);
+        }
+    }
+    phase_ns[5] = u2bench_now_ns() - t0;
+
+    uint32_t live = 0;
+    for (uint32_t r = 0; r < records; ++r) {
+        live += shadow[r] != 0;
+        if (shadow[r] != 0) read(r);
+    }
+    const bool ok = errors == 0 && live == t.size && t.check();
+
+    uint64_t total_ns = 0;
+    for (uint64_t ns : phase_ns) total_ns += ns;
+    u2bench_sink_u64(sum);
+    u2bench_print_time_ns(total_ns);
+    static const char* const kPhaseMetric[6] = {"load_kops", "a_kops", "b_kops", "c_kops", "e_kops", "churn_kops"};
+    static const uint32_t kPhaseOps[6] = {kRecords, kOps, kOps, kOps, kScanOps, kOps};
+    for (int p = 0; p < 6; ++p) {
+        u2bench_print_metric(kPhaseMetric[p], (double)kPhaseOps[p] / ((double)phase_ns[p] / 1e6));
+    }
+    u2bench_print_metric("fanout", (double)kMax);
+    u2bench_print_metric("leaf_bytes", (double)sizeof(Leaf));
+    u2bench_print_metric("inner_bytes", (double)sizeof(Inner));
+    u2bench_print_metric("height", (double)t.height + 1);
+    u2bench_print_metric("rows_scanned", (double)rows_scanned);
+    u2bench_print_metric("splits", (double)t.stats.splits);
+    u2bench_print_metric("borrows", (double)t.stats.borrows);
+    u2bench_print_metric("merges", (double)t.stats.merges);
+    u2bench_print_metric("check_ok", ok ? 1.0 : 0.0);
+
+    t.destroy();
+    free(shadow);
+    if (!ok) {
+        printf("bplustree check failed (errors %llu, live %u, size %u)\n", (unsigned long long)errors, live, t.size);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,322 @@
+#include "bench_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Columnar query kernels over generated TPC-H-like lineitem/orders columns (struct-of-arrays):
+//   scan    Q6-style range filters into selection vectors (data-dependent branches) + revenue sum,
+//           and the Q3 lineitem filter (l_shipdate > date)
+//   join    open-addressing hash join (build: filtered orders, probe: lineitem selection vector)
+//   groupby hash aggregation of join output by l_orderkey (sum of discounted revenue)
+//   topk    top-10 groups by revenue desc, o_orderdate asc via a bounded heap, then sorted
+// Each stage is timed separately (Metric: <stage>_ms, summed over kRounds rounds with shifted predicates);
+// Time is the sum of the four.
+
+namespace {
+
+constexpr uint32_t kOrders = 1u << 18;
+constexpr uint32_t kLineitemCap = kOrders * 4;
+constexpr uint32_t kRounds = 4;
+constexpr uint32_t kTopK = 10;
+constexpr int32_t kDays = 2406;  // 1992-01-01 .. 1998-08-02
+
+struct Lineitem {
+    uint32_t n = 0;
+    uint32_t* orderkey = nullptr;
+    int32_t* shipdate = nullptr;
+    uint8_t* quantity = nullptr;
+    uint8_t* discount = nullptr;  // percent, 0..10
+    int64_t* extendedprice = nullptr;  // cents
+};
+
+struct Orders {
+    uint32_t* orderkey = nullptr;
+    int32_t* orderdate = nullptr;
+    uint8_t* segment = nullptr;
+    uint8_t* shippriority = nullptr;
+};
+
+inline uint32_t hash32(uint64_t x) {
+    return (uint32_t)u2bench_splitmix64(x);
+}
+
+// Open-addressing u32 -> u32 map (key 0 is empty), as in db_kv_hash.cc.
+struct HashMap {
+    uint32_t mask = 0;
+    uint32_t* keys = nullptr;
+    uint32_t* vals = nullptr;
+
+    void init(uint32_t cap_pow2) {
+        mask = cap_pow2 - 1;
+        keys = (uint32_t*)malloc((size_t)cap_pow2 * sizeof(uint32_t));
+        vals = (uint32_t*)malloc((size_t)cap_pow2 * sizeof(uint32_t));
+    }
+
+    void clear() { memset(keys, 0, (size_t)(mask + 1) * sizeof(uint32_t)); }
+
+    // Returns the slot for key, inserting it with val when absent; *found tells which.
+    uint32_t find_or_insert(uint32_t key, uint32_t val, bool* found) {
+        uint32_t i = hash32(key) & mask;
+        for (;;) {
+            const uint32_t k = keys[i];
+            if (k == key) {
+                *found = true;
+                return i;
+            }
+            if (k == 0) {
+                keys[i] = key;
+                vals[i] = val;
+                *found = false;
+                return i;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    bool get(uint32_t key, uint32_t* val) const {
+        uint32_t i = hash32(key) & mask;
+        for (;;) {
+            const uint32_t k = keys[i];
+            if (k == key) {
+                *val = vals[i];
+                return true;
+            }
+            if (k == 0) return false;
+            i = (i + 1) & mask;
+        }
+    }
+
+    void destroy() {
+        free(keys);
+        free(vals);
+    }
+};
+
+struct Group {
+    uint32_t orderkey;
+    int32_t orderdate;
+    uint32_t shippriority;
+    int64_t revenue;
+};
+
+// Ranking for the Q3 result: revenue desc, then orderdate asc, then orderkey asc (total order).
+inline bool ranks_before(const Group& a, const Group& b) {
+    if (a.revenue != b.revenue) return a.revenue > b.revenue;
+    if (a.orderdate != b.orderdate) return a.orderdate < b.orderdate;
+    return a.orderkey < b.orderkey;
+}
+
+// Min-heap on rank: the root is the worst of the current top-k.
+void heap_sift_down(Group* h, uint32_t n, uint32_t i) {
+    for (;;) {
+        const uint32_t l = 2 * i + 1;
+        const uint32_t r = l + 1;
+        uint32_t worst = i;
+        if (l < n && ranks_before(h[worst], h[l])) worst = l;
+        if (r < n && ranks_before(h[worst], h[r])) worst = r;
+        if (worst == i) return;
+        const Group t = h[i];
+        h[i] = h[worst];
+        h[worst] = t;
+        i = worst;
+    }
+}
+
+void heap_sift_up(Group* h, uint32_t i) {
+    while (i > 0) {
+        const uint32_t p = (i - 1) / 2;
+        if (!ranks_before(h[p], h[i])) return;
+        const Group t = h[i];
+        h[i] = h[p];
+        h[p] = t;
+        i = p;
+    }
+}
+
+void generate(Lineitem* li, Orders* o) {
+    li->orderkey = (uint32_t*)malloc((size_t)kLineitemCap * sizeof(uint32_t));
+    li->shipdate = (int32_t*)malloc((size_t)kLineitemCap * sizeof(int32_t));
+    li->quantity = (uint8_t*)malloc(kLineitemCap);
+    li->discount = (uint8_t*)malloc(kLineitemCap);
+    li->extendedprice = (int64_t*)malloc((size_t)kLineitemCap * sizeof(int64_t));
+    o->orderkey = (uint32_t*)malloc((size_t)kOrders * sizeof(uint32_t));
+    o->orderdate = (int32_t*)malloc((size_t)kOrders * sizeof(int32_t));
+    o->segment = (uint8_t*)malloc(kOrders);
+    o->shippriority = (uint8_t*)malloc(kOrders);
+
+    uint32_t rng = 0x1234567u;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < kOrders; ++i) {
+        // Sparse keys like dbgen: 8 used out of every 32.
+        const uint32_t key = (i / 8) * 32 + (i % 8) + 1;
+        const int32_t odate = (int32_t)(u2bench_xorshift32(&rng) % (uint32_t)(kDays - 151));
+        o->orderkey[i] = key;
+        o->orderdate[i] = odate;
+        o->segment[i] = (uint8_t)(u2bench_xorshift32(&rng) % 5u);
+        o->shippriority[i] = (uint8_t)(u2bench_xorshift32(&rng) % 2u);
+        const uint32_t lines = 1 + u2bench_xorshift32(&rng) % 7u;
+        for (uint32_t j = 0; j < lines && n < kLineitemCap; ++j, ++n) {
+            const uint32_t qty = 1 + u2bench_xorshift32(&rng) % 50u;
+            const int64_t part_price = 90000 + (int64_t)(u2bench_xorshift32(&rng) % 110000u);
+            li->orderkey[n] = key;
+            li->shipdate[n] = odate + 1 + (int32_t)(u2bench_xorshift32(&rng) % 121u);
+            li->quantity[n] = (uint8_t)qty;
+            li->discount[n] = (uint8_t)(u2bench_xorshift32(&rng) % 11u);
+            li->extendedprice[n] = (int64_t)qty * part_price;
+        }
+    }
+    li->n = n;
+}
+
+}  // namespace
+
+int main() {
+    static Lineitem li;
+    static Orders o;
+    generate(&li, &o);
+
+    uint32_t* sel6 = (uint32_t*)malloc((size_t)li.n * sizeof(uint32_t));
+    uint32_t* sel3 = (uint32_t*)malloc((size_t)li.n * sizeof(uint32_t));
+    uint32_t* pair_li = (uint32_t*)malloc((size_t)li.n * sizeof(uint32_t));
+    uint32_t* pair_o = (uint32_t*)malloc((size_t)li.n * sizeof(uint32_t));
+    Group* groups = (Group*)malloc((size_t)kOrders * sizeof(Group));
+    HashMap build;
+    build.init(kOrders * 2);
+    HashMap agg;
+    agg.init(kOrders * 2);
+
+    uint64_t stage_ns[4] = {0, 0, 0, 0};
+    uint64_t checksum = 0;
+    uint64_t sel6_rows = 0;
+    uint64_t sel3_rows = 0;
+    uint64_t join_rows = 0;
+    uint64_t group_rows = 0;
+
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        const int32_t q6_lo = 365 * (int32_t)(1 + round);
+        const int32_t q6_hi = q6_lo + 365;
+        const uint8_t q6_disc = (uint8_t)(5 + round % 3);
+        const uint8_t q6_qty = (uint8_t)(24 + round);
+        const int32_t q3_date = 1165 + 30 * (int32_t)round;
+        const uint8_t q3_segment = (uint8_t)(round % 5);
+
+        // ---- scan / filter ----
+        uint64_t t0 = u2bench_now_ns();
+        uint32_t n6 = 0;
+        int64_t q6_revenue = 0;
+        for (uint32_t i = 0; i < li.n; ++i) {
+            const int32_t d = li.shipdate[i];
+            if (d >= q6_lo && d < q6_hi) {
+                const uint8_t disc = li.discount[i];
+                if (disc + 1 >= q6_disc && disc <= q6_disc + 1 && li.quantity[i] < q6_qty) {
+                    sel6[n6++] = i;
+                }
+            }
+        }
+        for (uint32_t k = 0; k < n6; ++k) {
+            const uint32_t i = sel6[k];
+            q6_revenue += li.extendedprice[i] * li.discount[i];
+        }
+        uint32_t n3 = 0;
+        for (uint32_t i = 0; i < li.n; ++i) {
+            if (li.shipdate[i] > q3_date) sel3[n3++] = i;
+        }
+        uint64_t t1 = u2bench_now_ns();
+        stage_ns[0] += t1 - t0;
+
+        // ---- hash join ----
+        t0 = t1;
+        build.clear();
+        for (uint32_t i = 0; i < kOrders; ++i) {
+            if (o.segment[i] == q3_segment && o.orderdate[i] < q3_date) {
+                bool found;
+                build.find_or_insert(o.orderkey[i], i, &found);
+            }
+        }
+        uint32_t np = 0;
+        for (uint32_t k = 0; k < n3; ++k) {
+            const uint32_t i = sel3[k];
+            uint32_t orow;
+            if (build.get(li.orderkey[i], &orow)) {
+                pair_li[np] = i;
+                pair_o[np] = orow;
+                ++np;
+            }
+        }
+        t1 = u2bench_now_ns();
+        stage_ns[1] += t1 - t0;
+
+        // ---- group-by ----
+        t0 = t1;
+        agg.clear();
+        uint32_t ng = 0;
+        for (uint32_t k = 0; k < np; ++k) {
+            const uint32_t i = pair_li[k];
+            const uint32_t orow = pair_o[k];
+            const int64_t rev = li.extendedprice[i] * (100 - li.discount[i]);
+            bool found;
+            const uint32_t slot = agg.find_or_insert(li.orderkey[i], ng, &found);
+            if (found) {
+                groups[agg.vals[slot]].revenue += rev;
+            } else {
+                groups[ng++] = Group{li.orderkey[i], o.orderdate[orow], o.shippriority[orow], rev};
+            }
+        }
+        t1 = u2bench_now_ns();
+        stage_ns[2] += t1 - t0;
+
+        // ---- top-k ----
+        t0 = t1;
+        Group top[kTopK];
+        uint32_t nt = 0;
+        for (uint32_t g = 0; g < ng; ++g) {
+            if (nt < kTopK) {
+                top[nt] = groups[g];
+                heap_sift_up(top, nt++);
+            } else if (ranks_before(groups[g], top[0])) {
+                top[0] = groups[g];
+                heap_sift_down(top, nt, 0);
+            }
+        }
+        for (uint32_t end = nt; end > 1; --end) {  // heap sort: best ends up first
+            const Group t = top[0];
+            top[0] = top[end - 1];
+            top[end - 1] = t;
+            heap_sift_down(top, end - 1, 0);
+        }
+        t1 = u2bench_now_ns();
+        stage_ns[3] += t1 - t0;
+
+        checksum = u2bench_splitmix64(checksum ^ (uint64_t)q6_revenue);
+        for (uint32_t k = 0; k < nt; ++k) {
+            checksum = u2bench_splitmix64(checksum ^ ((uint64_t)top[k].orderkey << 32) ^ (uint64_t)top[k].revenue);
+        }
+        sel6_rows += n6;
+        sel3_rows += n3;
+        join_rows += np;
+        group_rows += ng;
+    }
+
+    const uint64_t total_ns = stage_ns[0] + stage_ns[1] + stage_ns[2] + stage_ns[3];
+    u2bench_sink_u64(checksum);
+    u2bench_print_time_ns(total_ns);
+    u2bench_print_metric("scan_ms", (double)stage_ns[0] / 1e6);
+    u2bench_print_metric("join_ms", (double)stage_ns[1] / 1e6);
+    u2bench_print_metric("groupby_ms", (double)stage_ns[2] / 1e6);
+    u2bench_print_metric("topk_ms", (double)stage_ns[3] / 1e6);
+    u2bench_print_metric("lineitem_rows", (double)li.n);
+    u2bench_print_metric("q6_selected", (double)sel6_rows);
+    u2bench_print_metric("q3_selected", (double)sel3_rows);
+    u2bench_print_metric("join_rows", (double)join_rows);
+    u2bench_print_metric("groups", (double)group_rows);
+    u2bench_print_metric("checksum", (double)(checksum >> 11));
+
+    agg.destroy();
+    build.destroy();
+    free(groups);
+    free(pair_o);
+    free(pair_li);
+    free(sel3);
+    free(sel6);
+    return 0;
+}
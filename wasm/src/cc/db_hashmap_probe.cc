@@ -0,0 +1,476 @@
+#include "bench_common.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+// Hash-map probing strategies under one workload (u64 -> u64, 2^17 slots, no deletes):
+//   U2BENCH_HASHMAP_KIND 0: linear probing, split keys/vals (as db_kv_hash.cc)
+//   U2BENCH_HASHMAP_KIND 1: SwissTable-style groups: 7-bit tag per slot in a control-byte array, matched a group
+//                           at a time (SWAR over 8 bytes; i8x16 over 16 bytes when built with simd128)
+//   U2BENCH_HASHMAP_KIND 2: Robin Hood linear probing (probe distance per slot, early-exit misses)
+//   U2BENCH_HASHMAP_KIND 3: bucketized cuckoo (2 hashes x 4-slot buckets, random-walk eviction)
+// For load factors 50/75/87.5% the table is filled, then 1M lookups run per key distribution: uniform hits,
+// zipfian hits (theta 0.99), misses, and a 50/50 hit/miss mix. Metric: lf<NN>_<dist>_ns is ns per lookup.
+#ifndef U2BENCH_HASHMAP_KIND
+#define U2BENCH_HASHMAP_KIND 1
+#endif
+
+namespace {
+
+constexpr uint32_t kSlotsLog2 = 17;
+constexpr uint32_t kSlots = 1u << kSlotsLog2;
+constexpr uint32_t kLookups = 1u << 20;
+
+inline uint64_t hash64(uint64_t key) {
+    return u2bench_splitmix64(key);
+}
+
+// ---- linear probing ------------------------------------------------------------------------------------------
+
+struct LinearMap {
+    static constexpr const char* kName = "linear";
+    uint32_t mask = kSlots - 1;
+    uint64_t* keys = nullptr;  // 0 = empty
+    uint64_t* vals = nullptr;
+
+    bool init() {
+        keys = (uint64_t*)calloc(kSlots, sizeof(uint64_t));
+        vals = (uint64_t*)calloc(kSlots, sizeof(uint64_t));
+        return keys && vals;
+    }
+    void clear() { memset(keys, 0, kSlots * sizeof(uint64_t)); }
+    void destroy() {
+        free(keys);
+        free(vals);
+    }
+
+    bool insert(uint64_t key, uint64_t val) {
+        uint32_t i = (uint32_t)hash64(key) & mask;
+        for (;;) {
+            const uint64_t k = keys[i];
+            if (k == 0 || k == key) {
+                keys[i] = key;
+                vals[i] = val;
+                return true;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    bool find(uint64_t key, uint64_t* out) const {
+        uint32_t i = (uint32_t)hash64(key) & mask;
+        for (;;) {
+            const uint64_t k = keys[i];
+            if (k == key) {
+                *out = vals[i];
+                return true;
+            }
+            if (k == 0) return false;
+            i = (i + 1) & mask;
+        }
+    }
+};
+
+// ---- SwissTable-style group probing --------------------------------------------------------------------------
+
+struct SwissMap {
+#if defined(__wasm_simd128__)
+    static constexpr const char* kName = "swiss_i8x16";
+    static constexpr uint32_t kGroup = 16;
+#else
+    static constexpr const char* kName = "swiss_swar";
+    static constexpr uint32_t kGroup = 8;
+#endif
+    static constexpr uint8_t kEmpty = 0x80;
+    uint32_t mask = kSlots - 1;
+    uint8_t* ctrl = nullptr;  // kSlots + kGroup bytes: the first group is mirrored past the end for unaligned loads
+    uint64_t* keys = nullptr;
+    uint64_t* vals = nullptr;
+
+    bool init() {
+        ctrl = (uint8_t*)malloc(kSlots + kGroup);
+        keys = (uint64_t*)malloc(kSlots * sizeof(uint64_t));
+        vals = (uint64_t*)malloc(kSlots * sizeof(uint64_t));
+        if (!ctrl || !keys || !vals) return false;
+        clear();
+        return true;
+    }
+    void clear() { memset(ctrl, kEmpty, kSlots + kGroup); }
+    void destroy() {
+        free(ctrl);
+        free(keys);
+        free(vals);
+    }
+
+#if defined(__wasm_simd128__)
+    // Bit i set: slot pos + i carries `tag` (or, for match_empty, is empty).
+    static uint32_t match(const uint8_t* g, uint8_t tag) {
+        return wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(g), wasm_i8x16_splat((int8_t)tag)));
+    }
+    static uint32_t match_empty(const uint8_t* g) { return wasm_i8x16_bitmask(wasm_v128_load(g)); }
+    static uint32_t first(uint32_t bits) { return (uint32_t)__builtin_ctz(bits); }
+    static uint32_t drop_first(uint32_t bits) { return bits & (bits - 1); }
+    using Bits = uint32_t;
+#else
+    // Byte i has its high bit set: slot pos + i carries `tag` (may rarely flag a false positive above a true
+    // match; the key compare filters it) or, for match_empty, is empty.
+    static constexpr uint64_t kLsbs = 0x0101010101010101ull;
+    static constexpr uint64_t kMsbs = 0x8080808080808080ull;
+    static uint64_t load(const uint8_t* g) {
+        uint64_t v;
+        memcpy(&v, g, sizeof(v));
+        return v;
+    }
+    static uint64_t match(const uint8_t* g, uint8_t tag) {
+        const uint64_t x = load(g) ^ (kLsbs * tag);
+        return (x - kLsbs) & ~x & kMsbs;
+    }
+    static uint64_t match_empty(const uint8_t* g) { return load(g) & kMsbs; }
+    static uint32_t first(uint64_t bits) { return (uint32_t)__builtin_ctzll(bits) >> 3; }
+    static uint64_t drop_first(uint64_t bits) { return bits & (bits - 1); }
+    using Bits = uint64_t;
+#endif
+
+    void set_ctrl(uint32_t i, uint8_t c) {
+        ctrl[i] = c;
+        if (i < kGroup) ctrl[kSlots + i] = c;
+    }
+
+    bool find(uint64_t key, uint64_t* out) const {
+        const uint64_t h = hash64(key);
+        const uint8_t tag = (uint8_t)(h & 0x7f);
+        uint32_t pos = (uint32_t)(h >> 7) & mask;
+        for (uint32_t step = kGroup;; step += kGroup) {
+            const uint8_t* g = ctrl + pos;
+            for (Bits m = match(g, tag); m != 0; m = drop_first(m)) {
+                const uint32_t i = (pos + first(m)) & mask;
+                if (keys[i] == key) {
+                    *out = vals[i];
+                    return true;
+                }
+            }
+            if (match_empty(g) != 0) return false;
+            pos = (pos + step) & mask;  // triangular probing over groups
+        }
+    }
+
+    bool insert(uint64_t key, uint64_t val) {
+        const uint64_t h = hash64(key);
+        const uint8_t tag = (uint8_t)(h & 0x7f);
+        uint32_t pos = (uint32_t)(h >> 7) & mask;
+        for (uint32_t step = kGroup;; step += kGroup) {
+            const uint8_t* g = ctrl + pos;
+            for (Bits m = match(g, tag); m != 0; m = drop_first(m)) {
+                const uint32_t i = (pos + first(m)) & mask;
+                if (keys[i] == key) {
+                    vals[i] = val;
+                    return true;
+                }
+            }
+            const Bits e = match_empty(g);
+            if (e != 0) {
+                const uint32_t i = (pos + first(e)) & mask;
+                set_ctrl(i, tag);
+                keys[i] = key;
+                vals[i] = val;
+                return true;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+};
+
+// ---- Robin Hood ----------------------------------------------------------------------------------------------
+
+struct RobinHoodMap {
+    static constexpr const char* kName = "robinhood";
+    uint32_t mask = kSlots - 1;
+    uint64_t* keys = nullptr;
+    uint64_t* vals = nullptr;
+    uint16_t* dist = nullptr;  // probe distance + 1; 0 = empty
+
+    bool init() {
+        keys = (uint64_t*)malloc(kSlots * sizeof(uint64_t));
+        vals = (uint64_t*)malloc(kSlots * sizeof(uint64_t));
+        dist = (uint16_t*)calloc(kSlots, sizeof(uint16_t));
+        return keys && vals && dist;
+    }
+    void clear() { memset(dist, 0, kSlots * sizeof(uint16_t)); }
+    void destroy() {
+        free(keys);
+        free(vals);
+        free(dist);
+    }
+
+    bool find(uint64_t key, uint64_t* out) const {
+        uint32_t i = (uint32_t)hash64(key) & mask;
+        for (uint16_t d = 1;; ++d) {
+            // A resident closer to its home than we are to ours means the key would have displaced it.
+            if (dist[i] < d) return false;
+            if (keys[i] == key) {
+                *out = vals[i];
+                return true;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+
+    bool insert(uint64_t key, uint64_t val) {
+        uint64_t found;
+        if (find(key, &found)) {
+            uint32_t i = (uint32_t)hash64(key) & mask;
+            while (keys[i] != key || dist[i] == 0) i = (i + 1) & mask;
+            vals[i] = val;
+            return true;
+        }
+        uint32_t i = (uint32_t)hash64(key) & mask;
+        uint16_t d = 1;
+        for (;;) {
+            if (dist[i] == 0) {
+                keys[i] = key;
+                vals[i] = val;
+                dist[i] = d;
+                return true;
+            }
+            if (dist[i] < d) {
+                const uint64_t k = keys[i];
+                const uint64_t v = vals[i];
+                const uint16_t dd = dist[i];
+                keys[i] = key;
+                vals[i] = val;
+                dist[i] = d;
+                key = k;
+                val = v;
+                d = dd;
+            }
+            i = (i + 1) & mask;
+            ++d;
+        }
+    }
+};
+
+// ---- bucketized cuckoo ---------------------------------------------------------------------------------------
+
+struct CuckooMap {
+    static constexpr const char* kName = "cuckoo";
+    static constexpr uint32_t kWays = 4;
+    static constexpr uint32_t kBuckets = kSlots / kWays;
+    static constexpr uint32_t kMaxKicks = 500;
+    uint64_t* keys = nullptr;  // kBuckets x kWays, 0 = empty
+    uint64_t* vals = nullptr;
+    uint32_t rng = 0x2468aceu;
+
+    bool init() {
+        keys = (uint64_t*)calloc(kSlots, sizeof(uint64_t));
+        vals = (uint64_t*)calloc(kSlots, sizeof(uint64_t));
+        return keys && vals;
+    }
+    void clear() { memset(keys, 0, kSlots * sizeof(uint64_t)); }
+    void destroy() {
+        free(keys);
+        free(vals);
+    }
+
+    static uint32_t bucket1(uint64_t h) { return (uint32_t)h & (kBuckets - 1); }
+    static uint32_t bucket2(uint64_t h) { return (uint32_t)(h >> 32) & (kBuckets - 1); }
+
+    bool find(uint64_t key, uint64_t* out) const {
+        const uint64_t h = hash64(key);
+        const uint32_t b1 = bucket1(h) * kWays;
+        const uint32_t b2 = bucket2(h) * kWays;
+        for (uint32_t w = 0; w < kWays; ++w) {
+            if (keys[b1 + w] == key) {
+                *out = vals[b1 + w];
+                return true;
+            }
+        }
+        for (uint32_t w = 0; w < kWays; ++w) {
+            if (keys[b2 + w] == key) {
+                *out = vals[b2 + w];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool place(uint32_t b, uint64_t key, uint64_t val) {
+        for (uint32_t w = 0; w < kWays; ++w) {
+            if (keys[b + w] == 0 || keys[b + w] == key) {
+                keys[b + w] = key;
+                vals[b + w] = val;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool insert(uint64_t key, uint64_t val) {
+        const uint64_t h = hash64(key);
+        uint32_t b1 = bucket1(h) * kWays;
+        const uint32_t b2 = bucket2(h) * kWays;
+        for (uint32_t w = 0; w < kWays; ++w) {
+            if (keys[b2 + w] == key) {
+                vals[b2 + w] = val;
+                return true;
+            }
+        }
+        if (place(b1, key, val) || place(b2, key, val)) return true;
+        uint32_t b = (u2bench_xorshift32(&rng) & 1u) ? b1 : b2;
+        for (uint32_t kick = 0; kick < kMaxKicks; ++kick) {
+            const uint32_t w = u2bench_xorshift32(&rng) % kWays;
+            const uint64_t k = keys[b + w];
+            const uint64_t v = vals[b + w];
+            keys[b + w] = key;
+            vals[b + w] = val;
+            key = k;
+            val = v;
+            const uint64_t hk = hash64(key);
+            b1 = bucket1(hk) * kWays;
+            b = (b == b1) ? bucket2(hk) * kWays : b1;
+            if (place(b, key, val)) return true;
+        }
+        return false;  // the evicted key is dropped; counted as an insert failure
+    }
+};
+
+#if U2BENCH_HASHMAP_KIND == 0
+using Map = LinearMap;
+#elif U2BENCH_HASHMAP_KIND == 1
+using Map = SwissMap;
+#elif U2BENCH_HASHMAP_KIND == 2
+using Map = RobinHoodMap;
+#elif U2BENCH_HASHMAP_KIND == 3
+using Map = CuckooMap;
+#else
+#error "U2BENCH_HASHMAP_KIND must be 0..3"
+#endif
+
+// YCSB scrambled zipfian (theta 0.99) over [0, n).
+struct Zipfian {
+    uint64_t n = 0;
+    double theta = 0.99;
+    double alpha = 0.0;
+    double zetan = 0.0;
+    double eta = 0.0;
+    uint64_t state = 0x5eedull;
+
+    void init(uint64_t items) {
+        n = items;
+        zetan = 0.0;
+        double zeta2 = 0.0;
+        for (uint64_t i = 1; i <= n; ++i) {
+            const double t = 1.0 / pow((double)i, theta);
+            zetan += t;
+            if (i <= 2) zeta2 += t;
+        }
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    uint64_t next() {
+        state = u2bench_splitmix64(state);
+        const double u = (double)(state >> 11) * (1.0 / 9007199254740992.0);
+        const double uz = u * zetan;
+        uint64_t rank;
+        if (uz < 1.0) {
+            rank = 0;
+        } else if (uz < 1.0 + pow(0.5, theta)) {
+            rank = 1;
+        } else {
+            rank = (uint64_t)((double)n * pow(eta * u - eta + 1.0, alpha));
+            if (rank >= n) rank = n - 1;
+        }
+        return u2bench_splitmix64(rank ^ 0xc0ffeeull) % n;
+    }
+};
+
+inline uint64_t present_key(uint32_t i) {
+    return u2bench_splitmix64((uint64_t)i * 2 + 1) | 1ull;
+}
+
+inline uint64_t absent_key(uint32_t i) {
+    return u2bench_splitmix64(~((uint64_t)i * 2 + 1)) | 1ull;
+}
+
+inline uint64_t value_of(uint64_t key) {
+    return key * 0x9e3779b97f4a7c15ull;
+}
+
+}  // namespace
+
+int main() {
+    static Map map;
+    uint64_t* queries = (uint64_t*)malloc((size_t)kLookups * sizeof(uint64_t));
+    if (!map.init() || !queries) {
+        printf("alloc failed\n");
+        return 1;
+    }
+
+    static const uint32_t kLoadPermille[3] = {500, 750, 875};
+    static const char* const kDist[4] = {"uniform_hit", "zipf_hit", "miss", "mixed"};
+    uint64_t total_ns = 0;
+    uint64_t errors = 0;
+    uint64_t insert_failures = 0;
+    uint64_t sum = 0;
+    uint32_t rng = 0x13579bdu;
+    char name[48];
+
+    for (uint32_t lf : kLoadPermille) {
+        const uint32_t n = (uint32_t)((uint64_t)kSlots * lf / 1000u);
+        map.clear();
+        uint64_t t0 = u2bench_now_ns();
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint64_t k = present_key(i);
+            insert_failures += !map.insert(k, value_of(k));
+        }
+        uint64_t ns = u2bench_now_ns() - t0;
+        total_ns += ns;
+        snprintf(name, sizeof(name), "lf%u_insert_ns", lf / 10);
+        u2bench_print_metric(name, (double)ns / (double)n);
+
+        Zipfian zipf;
+        zipf.init(n);
+        for (uint32_t d = 0; d < 4; ++d) {
+            uint32_t expect_hits = 0;
+            for (uint32_t q = 0; q < kLookups; ++q) {
+                const uint32_t r = u2bench_xorshift32(&rng);
+                bool hit = d == 0 || d == 1 || (d == 3 && (r & 1u));
+                const uint32_t idx = d == 1 ? (uint32_t)zipf.next() : (r >> 1) % n;
+                queries[q] = hit ? present_key(idx) : absent_key(idx);
+                expect_hits += hit;
+            }
+            uint32_t hits = 0;
+            t0 = u2bench_now_ns();
+            for (uint32_t q = 0; q < kLookups; ++q) {
+                uint64_t v = 0;
+                if (map.find(queries[q], &v)) {
+                    ++hits;
+                    sum += v;
+                    errors += v != value_of(queries[q]);
+                }
+            }
+            ns = u2bench_now_ns() - t0;
+            total_ns += ns;
+            // Cuckoo insert failures drop keys, so only exact (no-failure) runs are checked for hit counts.
+            errors += insert_failures == 0 && hits != expect_hits;
+            snprintf(name, sizeof(name), "lf%u_%s_ns", lf / 10, kDist[d]);
+            u2bench_print_metric(name, (double)ns / (double)kLookups);
+        }
+    }
+
+    u2bench_sink_u64(sum);
+    u2bench_print_time_ns(total_ns);
+    u2bench_print_metric("insert_failures", (double)insert_failures);
+    u2bench_print_metric("errors", (double)errors);
+    printf("map: %s\n", Map::kName);
+
+    map.destroy();
+    free(queries);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,462 @@
+#include "bench_common.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// LSM-tree key-value store over WASI files: skiplist memtable, flushes to sorted SSTable files (4 KiB blocks via
+// pwrite, bloom filter + block fences kept in memory), point reads through the bloom filters with pread, and
+// L0 -> L1 merge compaction. A preload phase fills half the key space; the timed phase is a random mix of puts
+// and gets (U2BENCH_LSM_WRITE_PCT percent puts). Every get is checked against a shadow version table.
+#ifndef U2BENCH_LSM_WRITE_PCT
+#define U2BENCH_LSM_WRITE_PCT 50
+#endif
+
+namespace {
+
+struct Record {
+    uint64_t key;
+    uint64_t version;
+    uint64_t val[2];
+};
+
+constexpr uint32_t kKeySpace = 1u << 18;
+constexpr uint32_t kPreload = kKeySpace / 2;
+constexpr uint32_t kOps = 200000;
+constexpr uint32_t kMemtableCap = 8192;
+constexpr int kMaxLevel = 12;
+constexpr uint32_t kBlockBytes = 4096;
+constexpr uint32_t kRecsPerBlock = kBlockBytes / sizeof(Record);
+constexpr int kL0Max = 4;
+constexpr uint32_t kBloomBitsPerKey = 10;
+constexpr uint32_t kBloomProbes = 7;
+
+struct Stats {
+    uint64_t flushes = 0;
+    uint64_t compactions = 0;
+    uint64_t block_reads = 0;
+    uint64_t bloom_skips = 0;
+    uint64_t file_bytes = 0;
+};
+Stats g_stats;
+uint32_t g_file_id = 0;
+
+uint64_t value_of(uint64_t key, uint64_t version) {
+    return u2bench_splitmix64(key * 0x9e3779b97f4a7c15ull ^ version);
+}
+
+Record make_record(uint64_t key, uint64_t version) {
+    const uint64_t v = value_of(key, version);
+    return Record{key, version, {v, ~v}};
+}
+
+bool pwrite_full(int fd, const void* buf, size_t len, off_t off) {
+    const uint8_t* p = (const uint8_t*)buf;
+    size_t done = 0;
+    while (done < len) {
+        const ssize_t rc = pwrite(fd, p + done, len - done, off + (off_t)done);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (rc == 0) return false;
+        done += (size_t)rc;
+    }
+    return true;
+}
+
+bool pread_full(int fd, void* buf, size_t len, off_t off) {
+    uint8_t* p = (uint8_t*)buf;
+    size_t done = 0;
+    while (done < len) {
+        const ssize_t rc = pread(fd, p + done, len - done, off + (off_t)done);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (rc == 0) return false;
+        done += (size_t)rc;
+    }
+    return true;
+}
+
+// ---- SSTable -------------------------------------------------------------------------------------------------
+
+struct Table {
+    int fd = -1;
+    char path[32] = {};
+    uint32_t count = 0;
+    uint32_t blocks = 0;
+    uint64_t* fences = nullptr;  // first key of each block
+    uint64_t* bloom = nullptr;
+    uint32_t bloom_bits = 0;
+};
+
+void bloom_probe(uint64_t key, uint32_t bits, uint32_t* out) {
+    const uint64_t h = u2bench_splitmix64(key);
+    const uint32_t h1 = (uint32_t)h;
+    const uint32_t h2 = (uint32_t)(h >> 32) | 1u;
+    for (uint32_t i = 0; i < kBloomProbes; ++i) {
+        out[i] = (h1 + i * h2) % bits;
+    }
+}
+
+bool bloom_may_contain(const Table& t, uint64_t key) {
+    uint32_t bits[kBloomProbes];
+    bloom_probe(key, t.bloom_bits, bits);
+    for (uint32_t i = 0; i < kBloomProbes; ++i) {
+        if ((t.bloom[bits[i] >> 6] & (1ull << (bits[i] & 63))) == 0) return false;
+    }
+    return true;
+}
+
+void table_destroy(Table* t) {
+    if (t->fd >= 0) {
+        close(t->fd);
+        unlink(t->path);
+    }
+    free(t->fences);
+    free(t->bloom);
+    *t = Table();
+}
+
+// Streams sorted records into a new table file, one 4 KiB block per pwrite.
+struct TableWriter {
+    Table t;
+    Record block[kRecsPerBlock];
+    uint32_t in_block = 0;
+    bool ok = true;
+
+    bool open(uint32_t max_count) {
+        snprintf(t.path, sizeof(t.path), "u2bench_lsm_%u.sst", g_file_id++);
+        t.fd = ::open(t.path, O_CREAT | O_TRUNC | O_RDWR, 0644);
+        const uint32_t max_blocks = (max_count + kRecsPerBlock - 1) / kRecsPerBlock;
+        t.bloom_bits = ((max_count * kBloomBitsPerKey + 63u) & ~63u) | 64u;
+        t.fences = (uint64_t*)malloc((size_t)(max_blocks + 1) * sizeof(uint64_t));
+        t.bloom = (uint64_t*)calloc(t.bloom_bits / 64u, sizeof(uint64_t));
+        return t.fd >= 0 && t.fences && t.bloom;
+    }
+
+    void flush_block() {
+        if (in_block == 0) return;
+        memset(block + in_block, 0, (kRecsPerBlock - in_block) * sizeof(Record));
+        t.fences[t.blocks] = block[0].key;
+        ok = ok && pwrite_full(t.fd, block, kBlockBytes, (off_t)t.blocks * kBlockBytes);
+        g_stats.file_bytes += kBlockBytes;
+        ++t.blocks;
+        in_block = 0;
+    }
+
+    void add(const Record& r) {
+        block[in_block++] = r;
+        uint32_t bits[kBloomProbes];
+        bloom_probe(r.key, t.bloom_bits, bits);
+        for (uint32_t i = 0; i < kBloomProbes; ++i) {
+            t.bloom[bits[i] >> 6] |= 1ull << (bits[i] & 63);
+        }
+        ++t.count;
+        if (in_block == kRecsPerBlock) flush_block();
+    }
+
+    Table finish() {
+        flush_block();
+        return t;
+    }
+};
+
+bool table_get(const Table& t, uint64_t key, Record* out, Record* scratch) {
+    if (!bloom_may_contain(t, key)) {
+        ++g_stats.bloom_skips;
+        return false;
+    }
+    if (t.blocks == 0 || key < t.fences[0]) return false;
+    uint32_t lo = 0;
+    uint32_t hi = t.blocks;  // last block whose fence <= key
+    while (hi - lo > 1) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (t.fences[mid] <= key) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    if (!pread_full(t.fd, scratch, kBlockBytes, (off_t)lo * kBlockBytes)) return false;
+    ++g_stats.block_reads;
+    const uint32_t n = (lo + 1 == t.blocks) ? t.count - lo * kRecsPerBlock : kRecsPerBlock;
+    uint32_t a = 0;
+    uint32_t b = n;
+    while (a < b) {
+        const uint32_t mid = (a + b) / 2;
+        if (scratch[mid].key < key) {
+            a = mid + 1;
+        } else {
+            b = mid;
+        }
+    }
+    if (a < n && scratch[a].key == key) {
+        *out = scratch[a];
+        return true;
+    }
+    return false;
+}
+
+struct TableIter {
+    const Table* t = nullptr;
+    uint32_t pos = 0;  // record index in the table
+    Record block[kRecsPerBlock];
+
+    bool valid() const { return pos < t->count; }
+    const Record& cur() const { return block[pos % kRecsPerBlock]; }
+
+    bool load() {
+        if (!valid()) return true;
+        ++g_stats.block_reads;
+        return pread_full(t->fd, block, kBlockBytes, (off_t)(pos / kRecsPerBlock) * kBlockBytes);
+    }
+
+    bool next() {
+        ++pos;
+        return pos % kRecsPerBlock != 0 || load();
+    }
+};
+
+// ---- Memtable (skiplist) -------------------------------------------------------------------------------------
+
+struct Memtable {
+    Record* recs = nullptr;  // [0] is the head
+    uint32_t* next = nullptr;
+    uint32_t count = 0;
+    int level = 1;
+    uint32_t rng = 0x2545f491u;
+
+    uint32_t& NEXT(int l, uint32_t idx) { return next[(size_t)l * (kMemtableCap + 1) + idx]; }
+
+    bool init() {
+        recs = (Record*)malloc((size_t)(kMemtableCap + 1) * sizeof(Record));
+        next = (uint32_t*)calloc((size_t)kMaxLevel * (kMemtableCap + 1), sizeof(uint32_t));
+        return recs && next;
+    }
+
+    void clear() {
+        for (int l = 0; l < kMaxLevel; ++l) NEXT(l, 0) = 0;
+        count = 0;
+        level = 1;
+    }
+
+    int random_level() {
+        uint32_t x = u2bench_xorshift32(&rng);
+        int lvl = 1;
+        while ((x & 3u) == 0u && lvl < kMaxLevel) {
+            ++lvl;
+            x >>= 2;
+        }
+        return lvl;
+    }
+
+    // Returns false when a new node was needed but the memtable is full.
+    bool put(const Record& r) {
+        uint32_t update[kMaxLevel];
+        uint32_t x = 0;
+        for (int l = level - 1; l >= 0; --l) {
+            uint32_t y = NEXT(l, x);
+            while (y != 0 && recs[y].key < r.key) {
+                x = y;
+                y = NEXT(l, x);
+            }
+            update[l] = x;
+        }
+        const uint32_t y = NEXT(0, x);
+        if (y != 0 && recs[y].key == r.key) {
+            recs[y] = r;
+            return true;
+        }
+        if (count == kMemtableCap) return false;
+        const uint32_t node = ++count;
+        recs[node] = r;
+        const int lvl = random_level();
+        for (int l = level; l < lvl; ++l) update[l] = 0;
+        if (lvl > level) level = lvl;
+        for (int l = 0; l < lvl; ++l) {
+            NEXT(l, node) = NEXT(l, update[l]);
+            NEXT(l, update[l]) = node;
+        }
+        return true;
+    }
+
+    const Record* get(uint64_t key) {
+        uint32_t x = 0;
+        for (int l = level - 1; l >= 0; --l) {
+            uint32_t y = NEXT(l, x);
+            while (y != 0 && recs[y].key < key) {
+                x = y;
+                y = NEXT(l, x);
+            }
+        }
+        const uint32_t y = NEXT(0, x);
+        return (y != 0 && recs[y].key == key) ? &recs[y] : nullptr;
+    }
+};
+
+// ---- Tree ----------------------------------------------------------------------------------------------------
+
+struct Lsm {
+    Memtable mem;
+    Table l0[kL0Max];  // oldest first
+    int l0_count = 0;
+    Table l1;
+    Record scratch[kRecsPerBlock];
+    TableIter iters[kL0Max + 1];
+    bool ok = true;
+
+    void compact() {
+        // Merge every L0 table and L1 into a new L1; on equal keys the highest version wins.
+        uint32_t max_count = l1.count;
+        int n = 0;
+        for (int i = 0; i < l0_count; ++i) {
+            iters[n].t = &l0[i];
+            max_count += l0[i].count;
+            ++n;
+        }
+        if (l1.fd >= 0) {
+            iters[n].t = &l1;
+            ++n;
+        }
+        for (int i = 0; i < n; ++i) {
+            iters[i].pos = 0;
+            ok = ok && iters[i].load();
+        }
+        TableWriter w;
+        ok = ok && w.open(max_count);
+        for (;;) {
+            int best = -1;
+            for (int i = 0; i < n; ++i) {
+                if (!iters[i].valid()) continue;
+                if (best < 0 || iters[i].cur().key < iters[best].cur().key ||
+                    (iters[i].cur().key == iters[best].cur().key && iters[i].cur().version > iters[best].cur().version)) {
+                    best = i;
+                }
+            }
+            if (best < 0) break;
+            const Record r = iters[best].cur();
+            w.add(r);
+            for (int i = 0; i < n; ++i) {
+                while (iters[i].valid() && iters[i].cur().key == r.key) ok = ok && iters[i].next();
+            }
+        }
+        const Table merged = w.finish();
+        ok = ok && w.ok;
+        for (int i = 0; i < l0_count; ++i) table_destroy(&l0[i]);
+        l0_count = 0;
+        table_destroy(&l1);
+        l1 = merged;
+        ++g_stats.compactions;
+    }
+
+    void flush() {
+        if (l0_count == kL0Max) compact();
+        TableWriter w;
+        ok = ok && w.open(mem.count);
+        for (uint32_t x = mem.NEXT(0, 0); x != 0; x = mem.NEXT(0, x)) w.add(mem.recs[x]);
+        l0[l0_count++] = w.finish();
+        ok = ok && w.ok;
+        mem.clear();
+        ++g_stats.flushes;
+    }
+
+    void put(const Record& r) {
+        if (!mem.put(r)) {
+            flush();
+            mem.put(r);
+        }
+    }
+
+    bool get(uint64_t key, Record* out) {
+        if (const Record* r = mem.get(key)) {
+            *out = *r;
+            return true;
+        }
+        for (int i = l0_count - 1; i >= 0; --i) {
+            if (table_get(l0[i], key, out, scratch)) return true;
+        }
+        return l1.fd >= 0 && table_get(l1, key, out, scratch);
+    }
+
+    void destroy() {
+        for (int i = 0; i < l0_count; ++i) table_destroy(&l0[i]);
+        table_destroy(&l1);
+        free(mem.recs);
+        free(mem.next);
+    }
+};
+
+}  // namespace
+
+int main() {
+    static Lsm db;
+    uint32_t* latest = (uint32_t*)calloc(kKeySpace, sizeof(uint32_t));  // shadow: version per key, 0 = absent
+    if (!db.mem.init() || !latest) {
+        printf("alloc failed\n");
+        return 1;
+    }
+
+    uint64_t seq = 0;
+    uint32_t rng = 0x9e3779b9u;
+    for (uint32_t i = 0; i < kPreload; ++i) {
+        const uint64_t key = u2bench_xorshift32(&rng) % kKeySpace;
+        latest[key] = (uint32_t)++seq;
+        db.put(make_record(key, seq));
+    }
+    g_stats = Stats();
+
+    uint64_t reads = 0;
+    uint64_t hits = 0;
+    uint64_t mismatches = 0;
+    uint64_t sum = 0;
+    const uint64_t t0 = u2bench_now_ns();
+    for (uint32_t i = 0; i < kOps; ++i) {
+        const uint32_t dice = u2bench_xorshift32(&rng) % 100u;
+        const uint64_t key = u2bench_xorshift32(&rng) % kKeySpace;
+        if (dice < (uint32_t)U2BENCH_LSM_WRITE_PCT) {
+            latest[key] = (uint32_t)++seq;
+            db.put(make_record(key, seq));
+            continue;
+        }
+        ++reads;
+        Record r;
+        if (db.get(key, &r)) {
+            ++hits;
+            sum += r.val[0];
+            mismatches += (r.version != latest[key] || r.val[0] != value_of(key, r.version) || r.val[1] != ~r.val[0]);
+        } else {
+            mismatches += latest[key] != 0;
+        }
+    }
+    const uint64_t t1 = u2bench_now_ns();
+
+    const uint64_t writes = kOps - reads;
+    u2bench_sink_u64(sum);
+    u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("ops", (double)kOps);
+    u2bench_print_metric("kops_per_s", (double)kOps / ((double)(t1 - t0) / 1e6));
+    u2bench_print_metric("writes", (double)writes);
+    u2bench_print_metric("reads", (double)reads);
+    u2bench_print_metric("read_hits", (double)hits);
+    u2bench_print_metric("flushes", (double)g_stats.flushes);
+    u2bench_print_metric("compactions", (double)g_stats.compactions);
+    u2bench_print_metric("block_reads", (double)g_stats.block_reads);
+    u2bench_print_metric("bloom_skips", (double)g_stats.bloom_skips);
+    u2bench_print_metric("write_amp", writes ? (double)g_stats.file_bytes / (double)(writes * sizeof(Record)) : 0.0);
+    u2bench_print_metric("mismatches", (double)mismatches);
+
+    const bool ok = db.ok && mismatches == 0;
+    db.destroy();
+    free(latest);
+    if (!ok) {
+        printf("lsm check failed (io ok %d, mismatches %llu)\n", (int)db.ok, (unsigned long long)mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,401 @@
+#include "bench_common.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Allocation traces replayed against one allocator (U2BENCH_ALLOCATOR):
+//   0: wasi-libc malloc/free/realloc (dlmalloc)
+//   1: bump arena: 1 MiB chunks from malloc, free only counts, the arena rewinds when nothing is live
+//   2: size-class slab: 16..4096 B classes with intrusive free lists carved from 64 KiB slabs, larger sizes via malloc
+// Traces (same RNG stream for every allocator; every object is written on alloc and read back on free):
+//   producer_consumer  4096-deep FIFO of 32..543 B messages
+//   fragmentation      small/large interleave, free the larges, refill with mediums that never fit exactly
+//   realloc_growth     64 buffers grown round-robin by 1.5x from 16 B to 256 KiB
+//   tiny_objects       1M 16..46 B list nodes, freed list by list
+//   arena_reset        request scopes: ~200 objects of 16..527 B, all freed at scope end
+// Metrics: <trace>_ms, allocs (all traces; runbench derives alloc_mops), memory_grows / linear_peak_bytes (linear
+// memory growth observed with memory.size after each allocation; 0 outside wasm), peak_live_bytes (requested).
+#ifndef U2BENCH_ALLOCATOR
+#define U2BENCH_ALLOCATOR 0
+#endif
+
+namespace {
+
+constexpr size_t align16(size_t n) {
+    return (n + 15u) & ~(size_t)15u;
+}
+
+struct MallocAllocator {
+    static constexpr const char* kName = "dlmalloc";
+    void* alloc(size_t n) { return malloc(n); }
+    void release(void* p, size_t) { free(p); }
+    void* resize(void* p, size_t, size_t n) { return realloc(p, n); }
+};
+
+struct ArenaAllocator {
+    static constexpr const char* kName = "arena";
+    static constexpr size_t kChunk = 1u << 20;
+    struct Chunk {
+        Chunk* next;
+        size_t cap;  // usable bytes after the header
+    };
+    static constexpr size_t kHeader = align16(sizeof(Chunk));
+    Chunk* first = nullptr;
+    Chunk* cur = nullptr;
+    uint8_t* cursor = nullptr;
+    uint8_t* end = nullptr;
+    size_t live = 0;
+
+    static uint8_t* data(Chunk* c) { return (uint8_t*)c + kHeader; }
+
+    void use(Chunk* c) {
+        cur = c;
+        cursor = data(c);
+        end = cursor + c->cap;
+    }
+
+    bool next_chunk(size_t need) {
+        // After a rewind the retained chunks are reused in order; a chunk that is too small for `need` is skipped
+        // by linking a fresh one in front of it.
+        if (cur && cur->next && cur->next->cap >= need) {
+            use(cur->next);
+            return true;
+        }
+        const size_t cap = need > kChunk ? need : kChunk;
+        Chunk* c = (Chunk*)malloc(kHeader + cap);
+        if (!c) return false;
+        c->cap = cap;
+        if (cur) {
+            c->next = cur->next;
+            cur->next = c;
+        } else {
+            c->next = first;
+            first = c;
+        }
+        use(c);
+        return true;
+    }
+
+    void* alloc(size_t n) {
+        n = align16(n);
+        if ((size_t)(end - cursor) < n && !next_chunk(n)) return nullptr;
+        void* p = cursor;
+        cursor += n;
+        ++live;
+        return p;
+    }
+
+    void release(void*, size_t) {
+        if (--live == 0 && first) use(first);
+    }
+
+    void* resize(void* p, size_t old, size_t n) {
+        uint8_t* q = (uint8_t*)p;
+        if (q + align16(old) == cursor && (size_t)(end - q) >= align16(n)) {
+            cursor = q + align16(n);
+            return p;
+        }
+        void* r = alloc(n);
+        if (!r) return nullptr;
+        memcpy(r, p, old < n ? old : n);
+        --live;
+        return r;
+    }
+};
+
+struct SlabAllocator {
+    static constexpr const char* kName = "slab";
+    static constexpr size_t kSlab = 64u * 1024u;
+    static constexpr size_t kMaxSmall = 4096;
+    static constexpr uint32_t kClasses = 16;
+    static constexpr uint16_t kClassSize[kClasses] = {16,  32,  48,  64,   96,   128,  192,  256,
+                                                      384, 512, 768, 1024, 1536, 2048, 3072, 4096};
+    struct FreeNode {
+        FreeNode* next;
+    };
+    uint8_t class_of[kMaxSmall / 16 + 1];  // (n + 15) / 16 -> class
+    FreeNode* free_list[kClasses] = {};
+    uint8_t* cursor[kClasses] = {};
+    uint8_t* end[kClasses] = {};
+
+    SlabAllocator() {
+        uint32_t c = 0;
+        for (size_t i = 0; i <= kMaxSmall / 16; ++i) {
+            while (kClassSize[c] < i * 16) ++c;
+            class_of[i] = (uint8_t)c;
+        }
+    }
+
+    void* alloc(size_t n) {
+        if (n > kMaxSmall) return malloc(n);
+        const uint32_t c = class_of[(n + 15) / 16];
+        if (FreeNode* f = free_list[c]) {
+            free_list[c] = f->next;
+            return f;
+        }
+        if ((size_t)(end[c] - cursor[c]) < kClassSize[c]) {
+            uint8_t* slab = (uint8_t*)malloc(kSlab);
+            if (!slab) return nullptr;
+            cursor[c] = slab;
+            end[c] = slab + kSlab - kSlab % kClassSize[c];
+        }
+        void* p = cursor[c];
+        cursor[c] += kClassSize[c];
+        return p;
+    }
+
+    void release(void* p, size_t n) {
+        if (n > kMaxSmall) {
+            free(p);
+            return;
+        }
+        const uint32_t c = class_of[(n + 15) / 16];
+        FreeNode* f = (FreeNode*)p;
+        f->next = free_list[c];
+        free_list[c] = f;
+    }
+
+    void* resize(void* p, size_t old, size_t n) {
+        if (old <= kMaxSmall && n <= kMaxSmall && class_of[(old + 15) / 16] == class_of[(n + 15) / 16]) return p;
+        if (old > kMaxSmall && n > kMaxSmall) return realloc(p, n);
+        void* r = alloc(n);
+        if (!r) return nullptr;
+        memcpy(r, p, old < n ? old : n);
+        release(p, old);
+        return r;
+    }
+};
+constexpr uint16_t SlabAllocator::kClassSize[SlabAllocator::kClasses];
+
+#if U2BENCH_ALLOCATOR == 0
+using Allocator = MallocAllocator;
+#elif U2BENCH_ALLOCATOR == 1
+using Allocator = ArenaAllocator;
+#elif U2BENCH_ALLOCATOR == 2
+using Allocator = SlabAllocator;
+#else
+#error "U2BENCH_ALLOCATOR must be 0..2"
+#endif
+
+// Wraps the allocator with the bookkeeping every trace shares: object stamping/checking, alloc counts, live bytes
+// and observed linear-memory growth.
+struct Heap {
+    Allocator a;
+    uint64_t allocs = 0;
+    uint64_t live_bytes = 0;
+    uint64_t peak_live_bytes = 0;
+    uint64_t errors = 0;
+    uint64_t acc = 0;
+    uint32_t pages = 0;
+    uint32_t grows = 0;
+
+    void sample_memory() {
+#if defined(__wasm__)
+        const uint32_t now = (uint32_t)__builtin_wasm_memory_size(0);
+        if (now > pages) {
+            pages = now;
+            ++grows;
+        }
+#endif
+    }
+
+    static uint8_t stamp(size_t n) { return (uint8_t)(n * 31u + 7u); }
+
+    uint8_t* alloc(size_t n) {
+        uint8_t* p = (uint8_t*)a.alloc(n);
+        if (!p) {
+            printf("alloc of %zu bytes failed\n", n);
+            exit(1);
+        }
+        p[0] = stamp(n);
+        p[n - 1] = stamp(n);
+        ++allocs;
+        live_bytes += n;
+        if (live_bytes > peak_live_bytes) peak_live_bytes = live_bytes;
+        sample_memory();
+        return p;
+    }
+
+    void release(uint8_t* p, size_t n) {
+        errors += p[0] != stamp(n) || p[n - 1] != stamp(n);
+        acc += p[n - 1];
+        live_bytes -= n;
+        a.release(p, n);
+    }
+
+    uint8_t* resize(uint8_t* p, size_t old, size_t n) {
+        errors += p[0] != stamp(old);
+        uint8_t* q = (uint8_t*)a.resize(p, old, n);
+        if (!q) {
+            printf("resize to %zu bytes failed\n", n);
+            exit(1);
+        }
+        q[0] = stamp(n);
+        q[n - 1] = stamp(n);
+        ++allocs;
+        live_bytes += n - old;
+        if (live_bytes > peak_live_bytes) peak_live_bytes = live_bytes;
+        sample_memory();
+        return q;
+    }
+};
+
+struct Obj {
+    uint8_t* p;
+    uint32_t n;
+};
+
+void trace_producer_consumer(Heap& h, uint32_t* rng) {
+    constexpr uint32_t kDepth = 4096;
+    constexpr uint32_t kMessages = 400000;
+    static Obj q[kDepth];
+    for (uint32_t i = 0; i < kMessages; ++i) {
+        Obj& slot = q[i % kDepth];
+        if (i >= kDepth) h.release(slot.p, slot.n);
+        const uint32_t r = u2bench_xorshift32(rng);
+        // Mostly small messages with an occasional large one.
+        slot.n = (r & 0xf000u) ? 32u + (r & 127u) : 32u + (r & 511u);
+        slot.p = h.alloc(slot.n);
+    }
+    for (uint32_t i = 0; i < kDepth; ++i) h.release(q[i].p, q[i].n);
+}
+
+void trace_fragmentation(Heap& h, uint32_t* rng) {
+    constexpr uint32_t kObjs = 32768;
+    constexpr uint32_t kRounds = 8;
+    static Obj objs[kObjs];
+    for (uint32_t i = 0; i < kObjs; ++i) {
+        const uint32_t r = u2bench_xorshift32(rng);
+        objs[i].n = (i & 1u) ? 256u + (r & 767u) : 16u + (r & 47u);
+        objs[i].p = h.alloc(objs[i].n);
+    }
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        // Punch holes between the pinned small objects, then refill them with sizes that rarely fit exactly.
+        for (uint32_t i = 1; i < kObjs; i += 2) h.release(objs[i].p, objs[i].n);
+        for (uint32_t i = 1; i < kObjs; i += 2) {
+            const uint32_t r = u2bench_xorshift32(rng);
+            objs[i].n = (round & 1u) ? 256u + (r & 767u) : 80u + (r % 321u);
+            objs[i].p = h.alloc(objs[i].n);
+        }
+    }
+    for (uint32_t i = 0; i < kObjs; ++i) h.release(objs[i].p, objs[i].n);
+}
+
+void trace_realloc_growth(Heap& h, uint32_t* rng) {
+    constexpr uint32_t kBufs = 64;
+    constexpr uint32_t kMax = 256u * 1024u;
+    constexpr uint32_t kRepeat = 4;
+    static Obj bufs[kBufs];
+    for (uint32_t rep = 0; rep < kRepeat; ++rep) {
+        for (uint32_t b = 0; b < kBufs; ++b) {
+            bufs[b].n = 16;
+            bufs[b].p = h.alloc(16);
+        }
+        for (bool grew = true; grew;) {
+            grew = false;
+            for (uint32_t b = 0; b < kBufs; ++b) {
+                if (bufs[b].n >= kMax) continue;
+                uint32_t n = bufs[b].n + bufs[b].n / 2;
+                if (n > kMax) n = kMax;
+                bufs[b].p = h.resize(bufs[b].p, bufs[b].n, n);
+                // Append like a growing vector: fill the new tail.
+                memset(bufs[b].p + bufs[b].n, (int)(u2bench_xorshift32(rng) & 0x7fu), n - bufs[b].n - 1);
+                bufs[b].n = n;
+                grew = true;
+            }
+        }
+        for (uint32_t b = 0; b < kBufs; ++b) h.release(bufs[b].p, bufs[b].n);
+    }
+}
+
+void trace_tiny_objects(Heap& h, uint32_t* rng) {
+    constexpr uint32_t kLists = 1024;
+    constexpr uint32_t kNodes = 1u << 20;
+    constexpr uint32_t kRepeat = 2;
+    struct Node {
+        Node* next;
+        uint32_t n;
+    };
+    static Node* heads[kLists];
+    for (uint32_t rep = 0; rep < kRepeat; ++rep) {
+        for (uint32_t l = 0; l < kLists; ++l) heads[l] = nullptr;
+        for (uint32_t i = 0; i < kNodes; ++i) {
+            const uint32_t r = u2bench_xorshift32(rng);
+            const uint32_t n = 16u + (r & 15u) + (r >> 28);  // 16..46 >= sizeof(Node)
+            Node* node = (Node*)h.alloc(n);
+            const uint32_t l = (r >> 8) % kLists;
+            node->n = n;
+            node->next = heads[l];
+            heads[l] = node;
+        }
+        for (uint32_t l = 0; l < kLists; ++l) {
+            for (Node* node = heads[l]; node;) {
+                Node* next = node->next;
+                const uint32_t n = node->n;
+                // release() checks the stamp in the last byte; the first byte is the (overwritten) link field.
+                ((uint8_t*)node)[0] = Heap::stamp(n);
+                h.release((uint8_t*)node, n);
+                node = next;
+            }
+        }
+    }
+}
+
+void trace_arena_reset(Heap& h, uint32_t* rng) {
+    constexpr uint32_t kRequests = 5000;
+    constexpr uint32_t kMaxObjs = 256;
+    static Obj objs[kMaxObjs];
+    for (uint32_t req = 0; req < kRequests; ++req) {
+        const uint32_t count = 144u + (u2bench_xorshift32(rng) % 113u);
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t r = u2bench_xorshift32(rng);
+            objs[i].n = 16u + (r & 511u);
+            objs[i].p = h.alloc(objs[i].n);
+        }
+        for (uint32_t i = 0; i < count; ++i) h.release(objs[i].p, objs[i].n);
+    }
+}
+
+}  // namespace
+
+int main() {
+    static Heap h;
+    h.sample_memory();
+    h.grows = 0;
+
+    struct Trace {
+        const char* metric;
+        void (*run)(Heap&, uint32_t*);
+    };
+    static const Trace kTraces[] = {
+        {"producer_consumer_ms", trace_producer_consumer},
+        {"fragmentation_ms", trace_fragmentation},
+        {"realloc_growth_ms", trace_realloc_growth},
+        {"tiny_objects_ms", trace_tiny_objects},
+        {"arena_reset_ms", trace_arena_reset},
+    };
+    double trace_ms[sizeof(kTraces) / sizeof(kTraces[0])];
+    uint32_t rng = 0x2545f491u;
+    uint64_t total_ns = 0;
+    for (size_t t = 0; t < sizeof(kTraces) / sizeof(kTraces[0]); ++t) {
+        const uint64_t t0 = u2bench_now_ns();
+        kTraces[t].run(h, &rng);
+        const uint64_t ns = u2bench_now_ns() - t0;
+        total_ns += ns;
+        trace_ms[t] = (double)ns / 1e6;
+    }
+
+    u2bench_sink_u64(h.acc);
+    u2bench_print_time_ns(total_ns);
+    for (size_t t = 0; t < sizeof(kTraces) / sizeof(kTraces[0]); ++t) {
+        u2bench_print_metric(kTraces[t].metric, trace_ms[t]);
+    }
+    u2bench_print_metric("allocs", (double)h.allocs);
+    u2bench_print_metric("memory_grows", (double)h.grows);
+    u2bench_print_metric("linear_peak_bytes", (double)h.pages * 65536.0);
+    u2bench_print_metric("peak_live_bytes", (double)h.peak_live_bytes);
+    u2bench_print_metric("errors", (double)h.errors);
+    printf("allocator: %s\n", Allocator::kName);
+    return h.errors == 0 && h.live_bytes == 0 ? 0 : 1;
+}
@@ -0,0 +1,696 @@
+#include "bench_common.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Block compressors with round-trip verification (U2BENCH_CODEC):
+//   0: LZ4-style LZ77: 4-byte hash matches, 64 KiB window, LZ4 block token format, skip-accelerated miss path
+//   1: deflate-style Huffman: per-block histogram, code lengths limited to 12 bits, canonical LSB-first codes,
+//      12-bit single-level decode table
+//   2: zstd-style FSE (tANS): counts normalized to a 2^11 state table, zstd symbol spread, backward bitstream
+// Input is cut into 64 KiB blocks; each block is stored raw when coding would not shrink it (RLE for FSE/Huffman
+// single-symbol blocks). Two 4 MiB inputs: generated text (word-level Zipf over a small vocabulary) and random
+// bytes. Every round decompresses and compares against the input (FNV-1a checksum + memcmp).
+// Metrics: <input>_compress_mb_s, <input>_decompress_mb_s, <input>_ratio (input bytes / compressed bytes).
+#ifndef U2BENCH_CODEC
+#define U2BENCH_CODEC 0
+#endif
+
+namespace {
+
+constexpr size_t kInput = 4u << 20;
+constexpr size_t kBlock = 64u * 1024u;
+constexpr uint32_t kRounds = 3;
+constexpr size_t kSlack = 16;  // readers may load a few bytes past a payload
+
+enum BlockMode : uint8_t { kRaw = 0, kCoded = 1, kRle = 2 };
+
+inline void put_u32(uint8_t* p, uint32_t v) {
+    memcpy(p, &v, 4);
+}
+
+inline uint32_t get_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t get_u64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint32_t highbit(uint32_t v) {
+    return 31u - (uint32_t)__builtin_clz(v);
+}
+
+#if U2BENCH_CODEC == 0
+constexpr const char* kCodec = "lz4";
+#elif U2BENCH_CODEC == 1
+constexpr const char* kCodec = "huffman";
+#elif U2BENCH_CODEC == 2
+constexpr const char* kCodec = "fse";
+#else
+#error "U2BENCH_CODEC must be 0..2"
+#endif
+
+#if U2BENCH_CODEC == 0
+// ---- LZ4-style ------------------------------------------------------------------------------------------------
+
+namespace lz4 {
+
+constexpr uint32_t kMinMatch = 4;
+constexpr uint32_t kHashLog = 12;
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMatchSafety = 12;  // no match may start in the last 12 bytes (LZ4 block rule)
+
+inline uint32_t hash4(const uint8_t* p) {
+    return (get_u32(p) * 2654435761u) >> (32 - kHashLog);
+}
+
+inline void put_len(uint8_t** op, size_t len) {
+    for (; len >= 255; len -= 255) *(*op)++ = 255;
+    *(*op)++ = (uint8_t)len;
+}
+
+size_t compress(const uint8_t* src, size_t n, uint8_t* dst) {
+    static uint32_t table[1u << kHashLog];
+    memset(table, 0, sizeof(table));
+    uint8_t* op = dst;
+    const uint8_t* anchor = src;
+    if (n > kMatchSafety) {
+        const uint8_t* ip = src + 1;
+        const uint8_t* const limit = src + n - kMatchSafety;
+        while (ip < limit) {
+            // Find a match, stepping faster the longer nothing is found.
+            const uint8_t* ref;
+            uint32_t attempts = 1u << 6;
+            for (;;) {
+                const uint32_t h = hash4(ip);
+                ref = src + table[h];
+                table[h] = (uint32_t)(ip - src);
+                if (ref < ip && ip - ref <= 65535 && get_u32(ref) == get_u32(ip)) break;
+                ip += attempts++ >> 6;
+                if (ip >= limit) goto last_literals;
+            }
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                --ip;
+                --ref;
+            }
+            const size_t lit = (size_t)(ip - anchor);
+            const uint8_t* mp = ip + kMinMatch;
+            const uint8_t* const mlimit = src + n - kLastLiterals;
+            const uint8_t* r = ref + kMinMatch;
+            while (mp < mlimit && *mp == *r) {
+                ++mp;
+                ++r;
+            }
+            const size_t mlen = (size_t)(mp - ip) - kMinMatch;
+            uint8_t* token = op++;
+            *token = (uint8_t)(((lit < 15 ? lit : 15) << 4) | (mlen < 15 ? mlen : 15));
+            if (lit >= 15) put_len(&op, lit - 15);
+            memcpy(op, anchor, lit);
+            op += lit;
+            const uint16_t off = (uint16_t)(ip - ref);
+            *op++ = (uint8_t)off;
+            *op++ = (uint8_t)(off >> 8);
+            if (mlen >= 15) put_len(&op, mlen - 15);
+            ip = mp;
+            anchor = ip;
+            if (ip < limit) table[hash4(ip - 2)] = (uint32_t)(ip - 2 - src);
+        }
+    }
+last_literals:
+    const size_t lit = (size_t)(src + n - anchor);
+    *op++ = (uint8_t)((lit < 15 ? lit : 15) << 4);
+    if (lit >= 15) put_len(&op, lit - 15);
+    memcpy(op, anchor, lit);
+    op += lit;
+    return (size_t)(op - dst);
+}
+
+bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t out_n) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + n;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + out_n;
+    for (;;) {
+        if (ip >= iend) return false;
+        const uint8_t token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return false;
+                b = *ip++;
+                lit += b;
+            } while (b == 255);
+        }
+        if ((size_t)(iend - ip) < lit || (size_t)(oend - op) < lit) return false;
+        memcpy(op, ip, lit);
+        op += lit;
+        ip += lit;
+        if (ip == iend) return op == oend;
+        if (iend - ip < 2) return false;
+        const size_t off = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t mlen = token & 15u;
+        if (mlen == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return false;
+                b = *ip++;
+                mlen += b;
+            } while (b == 255);
+        }
+        mlen += kMinMatch;
+        if (off == 0 || off > (size_t)(op - dst) || (size_t)(oend - op) < mlen) return false;
+        const uint8_t* m = op - off;
+        if (off >= 8) {
+            // Non-overlapping in 8-byte steps; the tail is byte-wise.
+            size_t i = 0;
+            for (; i + 8 <= mlen; i += 8) memcpy(op + i, m + i, 8);
+            for (; i < mlen; ++i) op[i] = m[i];
+        } else {
+            for (size_t i = 0; i < mlen; ++i) op[i] = m[i];
+        }
+        op += mlen;
+    }
+}
+
+}  // namespace lz4
+#else
+// ---- shared entropy-coding pieces ----------------------------------------------------------------------------
+
+struct BitWriter {
+    uint8_t* out;
+    uint64_t acc = 0;
+    uint32_t bits = 0;
+    size_t n = 0;
+
+    void put(uint32_t v, uint32_t nb) {
+        acc |= (uint64_t)v << bits;
+        bits += nb;
+        while (bits >= 8) {
+            out[n++] = (uint8_t)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+    // Returns the total number of bits written.
+    uint64_t finish() {
+        const uint64_t total = (uint64_t)n * 8 + bits;
+        if (bits) out[n++] = (uint8_t)acc;
+        acc = 0;
+        bits = 0;
+        return total;
+    }
+};
+
+void histogram(const uint8_t* src, size_t n, uint32_t* count) {
+    memset(count, 0, 256 * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) ++count[src[i]];
+}
+
+#endif
+
+#if U2BENCH_CODEC == 1
+// ---- deflate-style Huffman -----------------------------------------------------------------------------------
+
+namespace huff {
+
+constexpr uint32_t kMaxLen = 12;
+
+// Huffman code lengths (two-queue construction over sorted leaves), then clamped to kMaxLen with a Kraft fix-up.
+void build_lengths(const uint32_t* count, uint8_t* len) {
+    struct Item {
+        uint64_t w;
+        int32_t parent;
+    };
+    static Item nodes[512];
+    uint32_t syms[256];
+    uint32_t n = 0;
+    for (uint32_t s = 0; s < 256; ++s) {
+        len[s] = 0;
+        if (count[s]) syms[n++] = s;
+    }
+    // Insertion sort by weight (<= 256 symbols).
+    for (uint32_t i = 1; i < n; ++i) {
+        const uint32_t v = syms[i];
+        uint32_t j = i;
+        for (; j > 0 && count[syms[j - 1]] > count[v]; --j) syms[j] = syms[j - 1];
+        syms[j] = v;
+    }
+    for (uint32_t i = 0; i < n; ++i) nodes[i] = Item{count[syms[i]], -1};
+    uint32_t leaf = 0;
+    uint32_t inner = n;
+    uint32_t next = n;
+    auto take = [&]() -> uint32_t {
+        if (leaf < n && (inner >= next || nodes[leaf].w <= nodes[inner].w)) return leaf++;
+        return inner++;
+    };
+    while (next < 2 * n - 1) {
+        const uint32_t a = take();
+        const uint32_t b = take();
+        nodes[next] = Item{nodes[a].w + nodes[b].w, -1};
+        nodes[a].parent = (int32_t)next;
+        nodes[b].parent = (int32_t)next;
+        ++next;
+    }
+    static uint32_t depth[512];
+    depth[2 * n - 2] = 0;
+    for (int32_t i = (int32_t)(2 * n) - 3; i >= 0; --i) depth[i] = depth[nodes[i].parent] + 1;
+    uint32_t kraft = 0;  // in units of 2^-kMaxLen
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint32_t d = depth[i] > kMaxLen ? kMaxLen : depth[i];
+        len[syms[i]] = (uint8_t)d;
+        kraft += 1u << (kMaxLen - d);
+    }
+    // Over-subscribed after clamping: lengthen the longest codes below the limit (cheapest in bits).
+    while (kraft > (1u << kMaxLen)) {
+        for (uint32_t i = 0; i < n && kraft > (1u << kMaxLen); ++i) {
+            const uint32_t s = syms[i];  // rarest first
+            if (len[s] < kMaxLen) {
+                kraft -= 1u << (kMaxLen - len[s] - 1);
+                ++len[s];
+            }
+        }
+    }
+}
+
+// Canonical codes, bit-reversed for LSB-first output.
+void build_codes(const uint8_t* len, uint16_t* code) {
+    uint32_t bl_count[kMaxLen + 1] = {};
+    for (uint32_t s = 0; s < 256; ++s) ++bl_count[len[s]];
+    bl_count[0] = 0;
+    uint32_t next_code[kMaxLen + 2] = {};
+    uint32_t c = 0;
+    for (uint32_t b = 1; b <= kMaxLen; ++b) {
+        c = (c + bl_count[b - 1]) << 1;
+        next_code[b] = c;
+    }
+    for (uint32_t s = 0; s < 256; ++s) {
+        if (!len[s]) continue;
+        uint32_t v = next_code[len[s]]++;
+        uint32_t r = 0;
+        for (uint32_t i = 0; i < len[s]; ++i, v >>= 1) r = (r << 1) | (v & 1u);
+        code[s] = (uint16_t)r;
+    }
+}
+
+// Payload: 128 bytes of 4-bit lengths, then the bitstream.
+size_t encode(const uint8_t* src, size_t n, const uint32_t* count, uint8_t* dst) {
+    uint8_t len[256];
+    uint16_t code[256];
+    build_lengths(count, len);
+    build_codes(len, code);
+    for (uint32_t s = 0; s < 256; s += 2) dst[s / 2] = (uint8_t)(len[s] | (len[s + 1] << 4));
+    BitWriter bw{dst + 128};
+    for (size_t i = 0; i < n; ++i) bw.put(code[src[i]], len[src[i]]);
+    bw.finish();
+    return 128 + bw.n;
+}
+
+bool decode(const uint8_t* src, size_t n, uint8_t* dst, size_t out_n) {
+    if (n < 128) return false;
+    uint8_t len[256];
+    uint16_t code[256];
+    for (uint32_t s = 0; s < 256; s += 2) {
+        len[s] = src[s / 2] & 15u;
+        len[s + 1] = src[s / 2] >> 4;
+    }
+    build_codes(len, code);
+    static uint16_t table[1u << kMaxLen];  // (symbol << 4) | length; 0 = invalid
+    memset(table, 0, sizeof(table));
+    for (uint32_t s = 0; s < 256; ++s) {
+        if (!len[s]) continue;
+        if (len[s] > kMaxLen) return false;
+        for (uint32_t k = code[s]; k < (1u << kMaxLen); k += 1u << len[s]) table[k] = (uint16_t)((s << 4) | len[s]);
+    }
+    const uint8_t* ip = src + 128;
+    const uint8_t* const iend = src + n;
+    uint64_t acc = 0;
+    uint32_t bits = 0;
+    for (size_t i = 0; i < out_n; ++i) {
+        while (bits <= 56) {
+            acc |= (uint64_t)(ip < iend ? *ip : 0) << bits;
+            ++ip;
+            bits += 8;
+        }
+        const uint16_t e = table[acc & ((1u << kMaxLen) - 1)];
+        if (!e) return false;
+        dst[i] = (uint8_t)(e >> 4);
+        acc >>= e & 15u;
+        bits -= e & 15u;
+    }
+    return ip - 8 <= iend;
+}
+
+}  // namespace huff
+#endif
+
+#if U2BENCH_CODEC == 2
+// ---- zstd-style FSE ------------------------------------------------------------------------------------------
+
+namespace fse {
+
+constexpr uint32_t kTableLog = 11;
+constexpr uint32_t kTableSize = 1u << kTableLog;
+
+void normalize(const uint32_t* count, size_t total, uint16_t* norm) {
+    uint32_t sum = 0;
+    uint32_t largest = 0;
+    for (uint32_t s = 0; s < 256; ++s) {
+        if (!count[s]) {
+            norm[s] = 0;
+            continue;
+        }
+        uint32_t v = (uint32_t)(((uint64_t)count[s] * kTableSize + total / 2) / total);
+        norm[s] = (uint16_t)(v ? v : 1);
+        sum += norm[s];
+        if (count[s] > count[largest]) largest = s;
+    }
+    // Give the rounding error to the most frequent symbol; if it cannot absorb it, trim others above 1.
+    if (sum < kTableSize) {
+        norm[largest] = (uint16_t)(norm[largest] + kTableSize - sum);
+        return;
+    }
+    uint32_t excess = sum - kTableSize;
+    const uint32_t take = excess < norm[largest] - 1u ? excess : norm[largest] - 1u;
+    norm[largest] = (uint16_t)(norm[largest] - take);
+    excess -= take;
+    for (uint32_t s = 0; excess > 0; s = (s + 1) & 255u) {
+        if (norm[s] > 1) {
+            --norm[s];
+            --excess;
+        }
+    }
+}
+
+void spread(const uint16_t* norm, uint8_t* table_symbol) {
+    const uint32_t step = (kTableSize >> 1) + (kTableSize >> 3) + 3;
+    uint32_t pos = 0;
+    for (uint32_t s = 0; s < 256; ++s) {
+        for (uint32_t i = 0; i < norm[s]; ++i) {
+            table_symbol[pos] = (uint8_t)s;
+            pos = (pos + step) & (kTableSize - 1);
+        }
+    }
+}
+
+struct SymbolTransform {
+    int32_t delta_find_state;
+    uint32_t delta_nb_bits;
+};
+
+// Payload: u32 bit count, norms (1 byte each, 255 escapes to a following u16), then the bitstream.
+size_t encode(const uint8_t* src, size_t n, const uint32_t* count, uint8_t* dst) {
+    uint16_t norm[256];
+    normalize(count, n, norm);
+    static uint8_t table_symbol[kTableSize];
+    spread(norm, table_symbol);
+
+    static uint16_t state_table[kTableSize];
+    uint32_t cumul[257];
+    cumul[0] = 0;
+    for (uint32_t s = 0; s < 256; ++s) cumul[s + 1] = cumul[s] + norm[s];
+    for (uint32_t u = 0; u < kTableSize; ++u) state_table[cumul[table_symbol[u]]++] = (uint16_t)(kTableSize + u);
+    SymbolTransform tt[256];
+    uint32_t total = 0;
+    for (uint32_t s = 0; s < 256; ++s) {
+        if (norm[s] == 0) continue;
+        if (norm[s] == 1) {
+            tt[s].delta_nb_bits = (kTableLog << 16) - kTableSize;
+            tt[s].delta_find_state = (int32_t)total - 1;
+            ++total;
+        } else {
+            const uint32_t max_bits_out = kTableLog - highbit(norm[s] - 1u);
+            const uint32_t min_state_plus = (uint32_t)norm[s] << max_bits_out;
+            tt[s].delta_nb_bits = (max_bits_out << 16) - min_state_plus;
+            tt[s].delta_find_state = (int32_t)total - (int32_t)norm[s];
+            total += norm[s];
+        }
+    }
+
+    size_t hp = 4;
+    for (uint32_t s = 0; s < 256; ++s) {
+        if (norm[s] < 255) {
+            dst[hp++] = (uint8_t)norm[s];
+        } else {
+            dst[hp++] = 255;
+            dst[hp++] = (uint8_t)norm[s];
+            dst[hp++] = (uint8_t)(norm[s] >> 8);
+        }
+    }
+    BitWriter bw{dst + hp};
+    uint32_t state = kTableSize;
+    for (size_t i = n; i-- > 0;) {
+        const SymbolTransform& t = tt[src[i]];
+        const uint32_t nb = (state + t.delta_nb_bits) >> 16;
+        bw.put(state & ((1u << nb) - 1u), nb);
+        state = state_table[(int32_t)(state >> nb) + t.delta_find_state];
+    }
+    bw.put(state - kTableSize, kTableLog);
+    put_u32(dst, (uint32_t)bw.finish());
+    return hp + bw.n;
+}
+
+bool decode(const uint8_t* src, size_t n, uint8_t* dst, size_t out_n) {
+    if (n < 4 + 256) return false;
+    const uint64_t total_bits = get_u32(src);
+    uint16_t norm[256];
+    size_t hp = 4;
+    uint32_t sum = 0;
+    for (uint32_t s = 0; s < 256; ++s) {
+        if (hp + 3 > n) return false;
+        norm[s] = src[hp++];
+        if (norm[s] == 255) {
+            norm[s] = (uint16_t)(src[hp] | (src[hp + 1] << 8));
+            hp += 2;
+        }
+        sum += norm[s];
+    }
+    if (sum != kTableSize || (total_bits + 7) / 8 != n - hp) return false;
+    static uint8_t table_symbol[kTableSize];
+    spread(norm, table_symbol);
+    struct DEntry {
+        uint16_t new_state;
+        uint8_t symbol;
+        uint8_t nb_bits;
+    };
+    static DEntry dt[kTableSize];
+    uint32_t next[256];
+    for (uint32_t s = 0; s < 256; ++s) next[s] = norm[s];
+    for (uint32_t u = 0; u < kTableSize; ++u) {
+        const uint8_t s = table_symbol[u];
+        const uint32_t ns = next[s]++;
+        const uint32_t nb = kTableLog - highbit(ns);
+        dt[u] = DEntry{(uint16_t)((ns << nb) - kTableSize), s, (uint8_t)nb};
+    }
+    // Read the stream backwards: the last thing written (the final state) comes first.
+    const uint8_t* bits = src + hp;
+    uint64_t pos = total_bits;
+    auto read = [&](uint32_t nb) -> uint32_t {
+        pos -= nb;
+        const uint64_t v = get_u64(bits + (pos >> 3)) >> (pos & 7);
+        return (uint32_t)(v & ((1u << nb) - 1u));
+    };
+    if (total_bits < kTableLog) return false;
+    uint32_t state = read(kTableLog);
+    for (size_t i = 0; i < out_n; ++i) {
+        const DEntry& e = dt[state];
+        dst[i] = e.symbol;
+        if (pos < e.nb_bits) return false;
+        state = e.new_state + read(e.nb_bits);
+    }
+    return pos == 0;
+}
+
+}  // namespace fse
+#endif
+
+// ---- block container -----------------------------------------------------------------------------------------
+
+// Block: u8 mode, u32 payload size, payload. The raw size is implied by the block index.
+size_t compress(const uint8_t* src, size_t n, uint8_t* dst) {
+    size_t op = 0;
+    for (size_t off = 0; off < n; off += kBlock) {
+        const size_t bn = n - off < kBlock ? n - off : kBlock;
+        const uint8_t* b = src + off;
+        uint8_t* hdr = dst + op;
+        uint8_t* payload = hdr + 5;
+        size_t pn;
+        BlockMode mode = kCoded;
+#if U2BENCH_CODEC == 0
+        pn = lz4::compress(b, bn, payload);
+#else
+        uint32_t count[256];
+        histogram(b, bn, count);
+        uint32_t distinct = 0;
+        for (uint32_t s = 0; s < 256; ++s) distinct += count[s] != 0;
+        if (distinct == 1) {
+            mode = kRle;
+            payload[0] = b[0];
+            pn = 1;
+        } else {
+#if U2BENCH_CODEC == 1
+            pn = huff::encode(b, bn, count, payload);
+#else
+            pn = fse::encode(b, bn, count, payload);
+#endif
+        }
+#endif
+        if (pn >= bn) {
+            mode = kRaw;
+            memcpy(payload, b, bn);
+            pn = bn;
+        }
+        hdr[0] = (uint8_t)mode;
+        put_u32(hdr + 1, (uint32_t)pn);
+        op += 5 + pn;
+    }
+    return op;
+}
+
+bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t out_n) {
+    size_t ip = 0;
+    for (size_t off = 0; off < out_n; off += kBlock) {
+        const size_t bn = out_n - off < kBlock ? out_n - off : kBlock;
+        if (ip + 5 > n) return false;
+        const uint8_t mode = src[ip];
+        const size_t pn = get_u32(src + ip + 1);
+        const uint8_t* payload = src + ip + 5;
+        if (ip + 5 + pn > n) return false;
+        bool ok;
+        if (mode == kRaw) {
+            ok = pn == bn;
+            if (ok) memcpy(dst + off, payload, bn);
+        } else if (mode == kRle) {
+            ok = pn == 1;
+            memset(dst + off, payload[0], bn);
+        } else {
+#if U2BENCH_CODEC == 0
+            ok = lz4::decompress(payload, pn, dst + off, bn);
+#elif U2BENCH_CODEC == 1
+            ok = huff::decode(payload, pn, dst + off, bn);
+#else
+            ok = fse::decode(payload, pn, dst + off, bn);
+#endif
+        }
+        if (!ok) return false;
+        ip += 5 + pn;
+    }
+    return ip == n;
+}
+
+// Worst case: every block raw, plus headers and reader slack.
+constexpr size_t kBound = kInput + (kInput / kBlock + 1) * (5 + 512) + kSlack;
+
+// ---- inputs --------------------------------------------------------------------------------------------------
+
+void gen_text(uint8_t* out, size_t n) {
+    static const char* const kWords[] = {
+        "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be", "by", "on",
+        "not", "he", "this", "are", "or", "his", "from", "at", "which", "but", "have", "an", "had", "they",
+        "you", "were", "their", "one", "all", "we", "can", "her", "has", "there", "been", "if", "more", "when",
+        "will", "would", "who", "so", "no", "engine", "memory", "module", "function", "instance", "compile",
+        "runtime", "benchmark", "interpreter", "request", "response", "latency", "throughput", "allocation",
+        "table", "stack", "frame", "branch", "loop", "value", "result", "error", "buffer", "stream", "block",
+    };
+    constexpr uint32_t kNumWords = sizeof(kWords) / sizeof(kWords[0]);
+    uint32_t rng = 0xfeedfaceu;
+    size_t i = 0;
+    uint32_t words_in_line = 0;
+    while (i < n) {
+        const uint32_t r = u2bench_xorshift32(&rng);
+        // Zipf-ish: favour low indices.
+        const uint32_t w = (r % kNumWords) % (1u + (r >> 24) % kNumWords);
+        const char* word = kWords[w];
+        for (size_t k = 0; word[k] && i < n; ++k) out[i++] = (uint8_t)word[k];
+        if (i < n) {
+            if (++words_in_line >= 8u + (r >> 8) % 8u) {
+                out[i++] = (r & 0x100u) ? '.' : '\n';
+                words_in_line = 0;
+            } else {
+                out[i++] = (r & 0x3e00u) ? ' ' : ',';
+            }
+        }
+    }
+}
+
+void gen_random(uint8_t* out, size_t n) {
+    uint64_t x = 0x123456789abcdefull;
+    for (size_t i = 0; i < n; i += 8) {
+        x = u2bench_splitmix64(x);
+        memcpy(out + i, &x, n - i < 8 ? n - i : 8);
+    }
+}
+
+uint64_t fnv1a(const uint8_t* p, size_t n) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 1099511628211ull;
+    return h;
+}
+
+}  // namespace
+
+int main() {
+    uint8_t* input = (uint8_t*)malloc(kInput);
+    uint8_t* packed = (uint8_t*)calloc(kBound, 1);
+    uint8_t* output = (uint8_t*)malloc(kInput);
+    if (!input || !packed || !output) {
+        printf("alloc failed\n");
+        return 1;
+    }
+    static const char* const kInputs[2] = {"text", "random"};
+    void (*const gens[2])(uint8_t*, size_t) = {gen_text, gen_random};
+    uint64_t total_ns = 0;
+    uint32_t errors = 0;
+    double compress_mb_s[2];
+    double decompress_mb_s[2];
+    double ratio[2];
+
+    for (uint32_t in = 0; in < 2; ++in) {
+        gens[in](input, kInput);
+        const uint64_t want = fnv1a(input, kInput);
+        uint64_t c_ns = 0;
+        uint64_t d_ns = 0;
+        size_t packed_n = 0;
+        for (uint32_t round = 0; round < kRounds; ++round) {
+            uint64_t t0 = u2bench_now_ns();
+            packed_n = compress(input, kInput, packed);
+            uint64_t t1 = u2bench_now_ns();
+            c_ns += t1 - t0;
+            memset(output, 0, kInput);
+            t0 = u2bench_now_ns();
+            const bool ok = decompress(packed, packed_n, output, kInput);
+            t1 = u2bench_now_ns();
+            d_ns += t1 - t0;
+            errors += !ok || fnv1a(output, kInput) != want || memcmp(output, input, kInput) != 0;
+        }
+        total_ns += c_ns + d_ns;
+        const double mb = (double)kInput * kRounds / 1e6;
+        compress_mb_s[in] = mb / ((double)c_ns / 1e9);
+        decompress_mb_s[in] = mb / ((double)d_ns / 1e9);
+        ratio[in] = (double)kInput / (double)packed_n;
+    }
+
+    u2bench_print_time_ns(total_ns);
+    char name[48];
+    for (uint32_t in = 0; in < 2; ++in) {
+        snprintf(name, sizeof(name), "%s_compress_mb_s", kInputs[in]);
+        u2bench_print_metric(name, compress_mb_s[in]);
+        snprintf(name, sizeof(name), "%s_decompress_mb_s", kInputs[in]);
+        u2bench_print_metric(name, decompress_mb_s[in]);
+        snprintf(name, sizeof(name), "%s_ratio", kInputs[in]);
+        u2bench_print_metric(name, ratio[in]);
+    }
+    u2bench_print_metric("roundtrip_errors", (double)errors);
+    printf("codec: %s\n", kCodec);
+    free(input);
+    free(packed);
+    free(output);
+    return errors == 0 ? 0 : 1;
+}
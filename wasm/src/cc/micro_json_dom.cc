@@ -0,0 +1,773 @@
+#include "bench_common.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// JSON DOM round trip over four generated documents (~1.5-2 MB each):
+//   nested   500 chains of objects nested 48 deep
+//   records  array of 12k flat-ish objects (ints, doubles, bools, short strings, a tag array, a geo object)
+//   numbers  4k rows of 16 numbers (ints and doubles needing 15-17 significant digits)
+//   strings  20k strings heavy in \" \\ \n \t \u00XX and surrogate-pair escapes, plus raw UTF-8
+// Per document and round: parse into an arena-backed DOM (recursive descent, Clinger fast path for doubles with
+// strtod fallback, unescaping into the arena), query paths, serialize (%.15g, widened to %.17g when that does not
+// round-trip, as cJSON does). The output is re-parsed and compared with the DOM once, untimed.
+// Metrics: parse_mb_s / serialize_mb_s (overall and per document), query_ns_per_path, dom_bytes.
+
+namespace {
+
+constexpr uint32_t kRounds = 5;
+constexpr uint32_t kMaxDepth = 512;
+
+// ---- buffers and arena ---------------------------------------------------------------------------------------
+
+struct Buf {
+    char* p = nullptr;
+    size_t n = 0;
+    size_t cap = 0;
+
+    void reserve(size_t extra) {
+        if (n + extra <= cap) return;
+        size_t c = cap ? cap : 4096;
+        while (c < n + extra) c *= 2;
+        p = (char*)realloc(p, c);
+        if (!p) {
+            printf("realloc failed\n");
+            exit(1);
+        }
+        cap = c;
+    }
+    void put(char c) {
+        reserve(1);
+        p[n++] = c;
+    }
+    void put(const char* s, size_t len) {
+        reserve(len);
+        memcpy(p + n, s, len);
+        n += len;
+    }
+    void put(const char* s) { put(s, strlen(s)); }
+    void terminate() {
+        reserve(1);
+        p[n] = '\0';
+    }
+};
+
+struct Arena {
+    static constexpr size_t kChunk = 1u << 20;
+    struct Chunk {
+        Chunk* next;
+    };
+    Chunk* first = nullptr;
+    Chunk* cur = nullptr;
+    char* cursor = nullptr;
+    char* end = nullptr;
+    size_t used = 0;
+
+    void use(Chunk* c) {
+        cur = c;
+        cursor = (char*)c + 16;
+        end = (char*)c + kChunk;
+    }
+
+    void* alloc(size_t n) {
+        n = (n + 7u) & ~(size_t)7u;
+        if ((size_t)(end - cursor) < n) {
+            if (n > kChunk - 16) return nullptr;
+            if (cur && cur->next) {
+                use(cur->next);
+            } else {
+                Chunk* c = (Chunk*)malloc(kChunk);
+                if (!c) return nullptr;
+                c->next = nullptr;
+                if (cur) {
+                    cur->next = c;
+                } else {
+                    first = c;
+                }
+                use(c);
+            }
+        }
+        void* p = cursor;
+        cursor += n;
+        used += n;
+        return p;
+    }
+
+    void reset() {
+        if (first) use(first);
+        used = 0;
+    }
+
+    void destroy() {
+        while (first) {
+            Chunk* next = first->next;
+            free(first);
+            first = next;
+        }
+    }
+};
+
+// ---- DOM -----------------------------------------------------------------------------------------------------
+
+enum Type : uint8_t { kNull, kFalse, kTrue, kInt, kDouble, kString, kArray, kObject };
+
+struct Value {
+    Type type;
+    uint32_t len;  // string bytes / child count
+    uint32_t key_len;
+    const char* key;  // set on object members
+    Value* next;      // next sibling
+    union {
+        int64_t i;
+        double d;
+        const char* s;
+        Value* first;
+    };
+};
+
+const Value* member(const Value* obj, const char* key) {
+    if (!obj || obj->type != kObject) return nullptr;
+    const size_t n = strlen(key);
+    for (const Value* m = obj->first; m; m = m->next) {
+        if (m->key_len == n && memcmp(m->key, key, n) == 0) return m;
+    }
+    return nullptr;
+}
+
+const Value* element(const Value* arr, uint32_t idx) {
+    if (!arr || arr->type != kArray) return nullptr;
+    const Value* e = arr->first;
+    while (e && idx--) e = e->next;
+    return e;
+}
+
+bool dom_equal(const Value* a, const Value* b) {
+    if (a->type != b->type || a->len != b->len) return false;
+    switch (a->type) {
+        case kInt:
+            return a->i == b->i;
+        case kDouble:
+            return a->d == b->d;
+        case kString:
+            return memcmp(a->s, b->s, a->len) == 0;
+        case kArray:
+        case kObject:
+            for (const Value *x = a->first, *y = b->first; x; x = x->next, y = y->next) {
+                if (a->type == kObject && (x->key_len != y->key_len || memcmp(x->key, y->key, x->key_len) != 0)) {
+                    return false;
+                }
+                if (!dom_equal(x, y)) return false;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+// ---- parser --------------------------------------------------------------------------------------------------
+
+constexpr double kPow10[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+struct Parser {
+    const char* p;
+    const char* end;
+    Arena* arena;
+    bool ok = true;
+
+    void ws() {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    }
+
+    Value* node(Type t) {
+        Value* v = (Value*)arena->alloc(sizeof(Value));
+        if (!v) {
+            ok = false;
+            return nullptr;
+        }
+        v->type = t;
+        v->len = 0;
+        v->key_len = 0;
+        v->key = nullptr;
+        v->next = nullptr;
+        v->first = nullptr;
+        return v;
+    }
+
+    static int hex(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool hex4(uint32_t* out) {
+        if (end - p < 4) return false;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int h = hex(p[i]);
+            if (h < 0) return false;
+            v = v * 16u + (uint32_t)h;
+        }
+        p += 4;
+        *out = v;
+        return true;
+    }
+
+    // Unescapes the string at p (just past the opening quote) into the arena.
+    bool string(const char** out, uint32_t* out_len) {
+        // The unescaped form is never longer than the source, so size the copy by the closing quote.
+        const char* q = p;
+        while (q < end && *q != '"') q += (*q == '\\') ? 2 : 1;
+        if (q >= end) return false;
+        char* dst = (char*)arena->alloc((size_t)(q - p) + 1);
+        if (!dst) return false;
+        char* w = dst;
+        for (;;) {
+            const char* run = p;
+            while (*p != '"' && *p != '\\') ++p;
+            memcpy(w, run, (size_t)(p - run));
+            w += p - run;
+            if (*p == '"') break;
+            ++p;
+            const char e = *p++;
+            switch (e) {
+                case '"': *w++ = '"'; break;
+                case '\\': *w++ = '\\'; break;
+                case '/': *w++ = '/'; break;
+                case 'b': *w++ = '\b'; break;
+                case 'f': *w++ = '\f'; break;
+                case 'n': *w++ = '\n'; break;
+                case 'r': *w++ = '\r'; break;
+                case 't': *w++ = '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!hex4(&cp)) return false;
+                    if (cp >= 0xd800 && cp < 0xdc00) {
+                        uint32_t lo;
+                        if (end - p < 2 || p[0] != '\\' || p[1] != 'u') return false;
+                        p += 2;
+                        if (!hex4(&lo) || lo < 0xdc00 || lo >= 0xe000) return false;
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                    }
+                    if (cp < 0x80) {
+                        *w++ = (char)cp;
+                    } else if (cp < 0x800) {
+                        *w++ = (char)(0xc0 | (cp >> 6));
+                        *w++ = (char)(0x80 | (cp & 0x3f));
+                    } else if (cp < 0x10000) {
+                        *w++ = (char)(0xe0 | (cp >> 12));
+                        *w++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+                        *w++ = (char)(0x80 | (cp & 0x3f));
+                    } else {
+                        *w++ = (char)(0xf0 | (cp >> 18));
+                        *w++ = (char)(0x80 | ((cp >> 12) & 0x3f));
+                        *w++ = (char)(0x80 | ((cp >> 6) & 0x3f));
+                        *w++ = (char)(0x80 | (cp & 0x3f));
+                    }
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        ++p;
+        *out = dst;
+        *out_len = (uint32_t)(w - dst);
+        return true;
+    }
+
+    Value* number() {
+        const char* start = p;
+        bool neg = false;
+        if (*p == '-') {
+            neg = true;
+            ++p;
+        }
+        uint64_t mant = 0;
+        int digits = 0;
+        int exp10 = 0;
+        if (*p < '0' || *p > '9') {
+            ok = false;
+            return nullptr;
+        }
+        for (; *p >= '0' && *p <= '9'; ++p) {
+            if (digits < 19) {
+                mant = mant * 10u + (uint64_t)(*p - '0');
+                if (mant) ++digits;
+            } else {
+                ++exp10;
+            }
+        }
+        bool integral = true;
+        if (*p == '.') {
+            integral = false;
+            for (++p; *p >= '0' && *p <= '9'; ++p) {
+                if (digits < 19) {
+                    mant = mant * 10u + (uint64_t)(*p - '0');
+                    if (mant) ++digits;
+                    --exp10;
+                }
+            }
+        }
+        if (*p == 'e' || *p == 'E') {
+            integral = false;
+            ++p;
+            bool eneg = false;
+            if (*p == '+' || *p == '-') eneg = *p++ == '-';
+            int e = 0;
+            for (; *p >= '0' && *p <= '9'; ++p) e = e < 10000 ? e * 10 + (*p - '0') : e;
+            exp10 += eneg ? -e : e;
+        }
+        if (integral && exp10 == 0 && mant <= (uint64_t)INT64_MAX) {
+            Value* v = node(kInt);
+            if (v) v->i = neg ? -(int64_t)mant : (int64_t)mant;
+            return v;
+        }
+        Value* v = node(kDouble);
+        if (!v) return nullptr;
+        if (mant < (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+            // Clinger's fast path: both operands exact, one correctly rounded operation.
+            double d = (double)mant;
+            d = exp10 < 0 ? d / kPow10[-exp10] : d * kPow10[exp10];
+            v->d = neg ? -d : d;
+        } else {
+            v->d = strtod(start, nullptr);
+        }
+        return v;
+    }
+
+    Value* value(uint32_t depth) {
+        ws();
+        if (p >= end || depth > kMaxDepth) {
+            ok = false;
+            return nullptr;
+        }
+        switch (*p) {
+            case '{': {
+                ++p;
+                Value* obj = node(kObject);
+                if (!obj) return nullptr;
+                Value** tail = &obj->first;
+                ws();
+                if (*p == '}') {
+                    ++p;
+                    return obj;
+                }
+                for (;;) {
+                    ws();
+                    const char* key;
+                    uint32_t key_len;
+                    if (*p != '"') break;
+                    ++p;
+                    if (!string(&key, &key_len)) break;
+                    ws();
+                    if (*p != ':') break;
+                    ++p;
+                    Value* v = value(depth + 1);
+                    if (!v) return nullptr;
+                    v->key = key;
+                    v->key_len = key_len;
+                    *tail = v;
+                    tail = &v->next;
+                    ++obj->len;
+                    ws();
+                    if (*p == ',') {
+                        ++p;
+                        continue;
+                    }
+                    if (*p == '}') {
+                        ++p;
+                        return obj;
+                    }
+                    break;
+                }
+                ok = false;
+                return nullptr;
+            }
+            case '[': {
+                ++p;
+                Value* arr = node(kArray);
+                if (!arr) return nullptr;
+                Value** tail = &arr->first;
+                ws();
+                if (*p == ']') {
+                    ++p;
+                    return arr;
+                }
+                for (;;) {
+                    Value* v = value(depth + 1);
+                    if (!v) return nullptr;
+                    *tail = v;
+                    tail = &v->next;
+                    ++arr->len;
+                    ws();
+                    if (*p == ',') {
+                        ++p;
+                        continue;
+                    }
+                    if (*p == ']') {
+                        ++p;
+                        return arr;
+                    }
+                    ok = false;
+                    return nullptr;
+                }
+            }
+            case '"': {
+                ++p;
+                Value* v = node(kString);
+                if (!v) return nullptr;
+                if (!string(&v->s, &v->len)) {
+                    ok = false;
+                    return nullptr;
+                }
+                return v;
+            }
+            case 't':
+                if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+                    p += 4;
+                    return node(kTrue);
+                }
+                break;
+            case 'f':
+                if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+                    p += 5;
+                    return node(kFalse);
+                }
+                break;
+            case 'n':
+                if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+                    p += 4;
+                    return node(kNull);
+                }
+                break;
+            default:
+                return number();
+        }
+        ok = false;
+        return nullptr;
+    }
+};
+
+// `text` must be NUL-terminated (the number and string scanners rely on a non-JSON sentinel).
+Value* parse(const char* text, size_t n, Arena* arena) {
+    Parser ps{text, text + n, arena};
+    Value* root = ps.value(0);
+    ps.ws();
+    return ps.ok && root && ps.p == ps.end ? root : nullptr;
+}
+
+// ---- serializer ----------------------------------------------------------------------------------------------
+
+void put_string(Buf* out, const char* s, uint32_t n) {
+    static const char kHex[] = "0123456789abcdef";
+    out->reserve((size_t)n * 6 + 2);
+    char* w = out->p + out->n;
+    *w++ = '"';
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint8_t c = (uint8_t)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            *w++ = (char)c;
+            continue;
+        }
+        *w++ = '\\';
+        switch (c) {
+            case '"': *w++ = '"'; break;
+            case '\\': *w++ = '\\'; break;
+            case '\n': *w++ = 'n'; break;
+            case '\r': *w++ = 'r'; break;
+            case '\t': *w++ = 't'; break;
+            case '\b': *w++ = 'b'; break;
+            case '\f': *w++ = 'f'; break;
+            default:
+                *w++ = 'u';
+                *w++ = '0';
+                *w++ = '0';
+                *w++ = kHex[c >> 4];
+                *w++ = kHex[c & 15];
+        }
+    }
+    *w++ = '"';
+    out->n = (size_t)(w - out->p);
+}
+
+void put_int(Buf* out, int64_t v) {
+    char tmp[24];
+    char* w = tmp + sizeof(tmp);
+    uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+    do {
+        *--w = (char)('0' + u % 10u);
+        u /= 10u;
+    } while (u);
+    if (v < 0) *--w = '-';
+    out->put(w, (size_t)(tmp + sizeof(tmp) - w));
+}
+
+void put_double(Buf* out, double d) {
+    char tmp[32];
+    int n = snprintf(tmp, sizeof(tmp), "%1.15g", d);
+    if (strtod(tmp, nullptr) != d) n = snprintf(tmp, sizeof(tmp), "%1.17g", d);
+    out->put(tmp, (size_t)n);
+    // Keep doubles doubles on re-parse.
+    if (!strpbrk(tmp, ".eEn")) out->put(".0", 2);
+}
+
+void serialize(const Value* v, Buf* out) {
+    switch (v->type) {
+        case kNull: out->put("null", 4); break;
+        case kFalse: out->put("false", 5); break;
+        case kTrue: out->put("true", 4); break;
+        case kInt: put_int(out, v->i); break;
+        case kDouble: put_double(out, v->d); break;
+        case kString: put_string(out, v->s, v->len); break;
+        case kArray:
+            out->put('[');
+            for (const Value* e = v->first; e; e = e->next) {
+                if (e != v->first) out->put(',');
+                serialize(e, out);
+            }
+            out->put(']');
+            break;
+        case kObject:
+            out->put('{');
+            for (const Value* m = v->first; m; m = m->next) {
+                if (m != v->first) out->put(',');
+                put_string(out, m->key, m->key_len);
+                out->put(':');
+                serialize(m, out);
+            }
+            out->put('}');
+            break;
+    }
+}
+
+// ---- generators (untimed) ------------------------------------------------------------------------------------
+
+void gen_double(Buf* b, uint32_t* rng) {
+    char tmp[32];
+    const uint32_t r = u2bench_xorshift32(rng);
+    const double mag = (double)(u2bench_xorshift32(rng) % 2000000u) / 1000.0 - 1000.0;
+    const double d = (r & 3u) == 0 ? mag / 3.0 : (r & 3u) == 1 ? mag * 1e-7 : (r & 3u) == 2 ? mag * 1e12 : mag;
+    const int n = snprintf(tmp, sizeof(tmp), (r & 8u) ? "%.17g" : "%.6g", d);
+    b->put(tmp, (size_t)n);
+    if (!strpbrk(tmp, ".eEn")) b->put(".0", 2);
+}
+
+void gen_word(Buf* b, uint32_t* rng, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) b->put((char)('a' + u2bench_xorshift32(rng) % 26u));
+}
+
+void gen_nested(Buf* b, uint32_t* rng) {
+    constexpr uint32_t kChains = 500;
+    constexpr uint32_t kDepth = 48;
+    char tmp[32];
+    b->put('[');
+    for (uint32_t c = 0; c < kChains; ++c) {
+        if (c) b->put(',');
+        for (uint32_t d = 0; d < kDepth; ++d) {
+            b->put("{\"level\":");
+            b->put(tmp, (size_t)snprintf(tmp, sizeof(tmp), "%u", d));
+            b->put(",\"name\":\"");
+            gen_word(b, rng, 3 + d % 5);
+            b->put("\",\"items\":[");
+            b->put(tmp, (size_t)snprintf(tmp, sizeof(tmp), "%u,%u,%u", c, d, c ^ d));
+            b->put("],\"child\":");
+        }
+        b->put("null");
+        for (uint32_t d = 0; d < kDepth; ++d) b->put('}');
+    }
+    b->put(']');
+}
+
+void gen_records(Buf* b, uint32_t* rng) {
+    constexpr uint32_t kRecords = 12000;
+    char tmp[64];
+    b->put('[');
+    for (uint32_t i = 0; i < kRecords; ++i) {
+        if (i) b->put(',');
+        b->put(tmp, (size_t)snprintf(tmp, sizeof(tmp), "{\"id\":%u,\"name\":\"", i * 7u + 1000u));
+        gen_word(b, rng, 4 + u2bench_xorshift32(rng) % 12u);
+        b->put((u2bench_xorshift32(rng) & 1u) ? "\",\"active\":true,\"score\":" : "\",\"active\":false,\"score\":");
+        gen_double(b, rng);
+        b->put(",\"tags\":[\"");
+        gen_word(b, rng, 3);
+        b->put("\",\"");
+        gen_word(b, rng, 5);
+        b->put("\"],\"geo\":{\"lat\":");
+        gen_double(b, rng);
+        b->put(",\"lon\":");
+        gen_double(b, rng);
+        b->put("},\"parent\":null}");
+    }
+    b->put(']');
+}
+
+void gen_numbers(Buf* b, uint32_t* rng) {
+    constexpr uint32_t kRows = 4000;
+    constexpr uint32_t kCols = 16;
+    char tmp[32];
+    b->put('[');
+    for (uint32_t r = 0; r < kRows; ++r) {
+        b->put(r ? ",[" : "[");
+        for (uint32_t c = 0; c < kCols; ++c) {
+            if (c) b->put(',');
+            if (c & 1u) {
+                gen_double(b, rng);
+            } else {
+                const int32_t v = (int32_t)u2bench_xorshift32(rng) >> (c % 24u);
+                b->put(tmp, (size_t)snprintf(tmp, sizeof(tmp), "%d", v));
+            }
+        }
+        b->put(']');
+    }
+    b->put(']');
+}
+
+void gen_strings(Buf* b, uint32_t* rng) {
+    constexpr uint32_t kStrings = 20000;
+    static const char* const kPieces[] = {
+        "plain text ", "\\\"quoted\\\" ", "back\\\\slash ", "line\\nbreak ", "tab\\tstop ", "caf\\u00e9 ",
+        "\\u0001ctl ", "emoji \\ud83d\\ude00 ", "raw \xc3\xa9\xe2\x82\xac ", "path\\/to ", "\\u4e2d\\u6587 ",
+    };
+    constexpr uint32_t kNumPieces = sizeof(kPieces) / sizeof(kPieces[0]);
+    b->put('[');
+    for (uint32_t i = 0; i < kStrings; ++i) {
+        b->put(i ? ",\"" : "\"");
+        const uint32_t n = 3 + u2bench_xorshift32(rng) % 8u;
+        for (uint32_t k = 0; k < n; ++k) b->put(kPieces[u2bench_xorshift32(rng) % kNumPieces]);
+        b->put('"');
+    }
+    b->put(']');
+}
+
+// ---- queries -------------------------------------------------------------------------------------------------
+
+struct QueryResult {
+    uint64_t paths = 0;
+    double sum = 0.0;
+    uint64_t misses = 0;
+};
+
+void query(uint32_t doc, const Value* root, QueryResult* q) {
+    for (const Value* e = root->first; e; e = e->next) {
+        switch (doc) {
+            case 0: {  // nested: follow child links to the leaf, then read level and items[2]
+                const Value* v = e;
+                for (const Value* c = member(v, "child"); c && c->type == kObject; c = member(v, "child")) v = c;
+                const Value* level = member(v, "level");
+                const Value* item = element(member(v, "items"), 2);
+                q->sum += (level ? (double)level->i : 0.0) + (item ? (double)item->i : 0.0);
+                q->misses += !level || !item;
+                q->paths += 2;
+                break;
+            }
+            case 1: {  // records: geo.lat + score + len(tags[1]) for active records
+                const Value* active = member(e, "active");
+                if (active && active->type == kTrue) {
+                    const Value* lat = member(member(e, "geo"), "lat");
+                    const Value* score = member(e, "score");
+                    const Value* tag = element(member(e, "tags"), 1);
+                    q->sum += (lat ? lat->d : 0.0) + (score ? score->d : 0.0) + (tag ? tag->len : 0);
+                    q->misses += !lat || !score || !tag;
+                    q->paths += 3;
+                }
+                q->paths += 1;
+                break;
+            }
+            case 2: {  // numbers: row[3] + row[14]
+                const Value* a = element(e, 3);
+                const Value* b = element(e, 14);
+                q->sum += (a ? a->d : 0.0) + (b ? (double)b->i : 0.0);
+                q->misses += !a || !b;
+                q->paths += 2;
+                break;
+            }
+            default:  // strings: unescaped length and first byte
+                q->sum += (double)e->len + (e->len ? (uint8_t)e->s[0] : 0);
+                q->paths += 1;
+                break;
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    static const char* const kDocs[4] = {"nested", "records", "numbers", "strings"};
+    void (*const gens[4])(Buf*, uint32_t*) = {gen_nested, gen_records, gen_numbers, gen_strings};
+
+    uint64_t parse_ns = 0;
+    uint64_t query_ns = 0;
+    uint64_t ser_ns = 0;
+    uint64_t in_bytes = 0;
+    uint64_t out_bytes = 0;
+    uint64_t dom_bytes = 0;
+    uint64_t errors = 0;
+    QueryResult q;
+    uint32_t rng = 0x1badf00du;
+    Arena arena;
+    Arena check_arena;
+    Buf out;
+    char name[48];
+
+    for (uint32_t doc = 0; doc < 4; ++doc) {
+        Buf text;
+        gens[doc](&text, &rng);
+        text.terminate();
+        uint64_t doc_parse_ns = 0;
+        uint64_t doc_ser_ns = 0;
+        const Value* root = nullptr;
+        for (uint32_t round = 0; round < kRounds; ++round) {
+            arena.reset();
+            uint64_t t0 = u2bench_now_ns();
+            root = parse(text.p, text.n, &arena);
+            uint64_t t1 = u2bench_now_ns();
+            doc_parse_ns += t1 - t0;
+            if (!root) {
+                printf("parse failed: %s\n", kDocs[doc]);
+                return 1;
+            }
+
+            t0 = t1;
+            query(doc, root, &q);
+            t1 = u2bench_now_ns();
+            query_ns += t1 - t0;
+
+            out.n = 0;
+            t0 = t1;
+            serialize(root, &out);
+            t1 = u2bench_now_ns();
+            doc_ser_ns += t1 - t0;
+            out_bytes += out.n;
+        }
+        dom_bytes += arena.used;
+        in_bytes += (uint64_t)text.n * kRounds;
+
+        out.terminate();
+        check_arena.reset();
+        const Value* again = parse(out.p, out.n, &check_arena);
+        errors += !again || !dom_equal(root, again);
+
+        parse_ns += doc_parse_ns;
+        ser_ns += doc_ser_ns;
+        snprintf(name, sizeof(name), "%s_parse_mb_s", kDocs[doc]);
+        u2bench_print_metric(name, (double)text.n * kRounds / ((double)doc_parse_ns / 1e3));
+        snprintf(name, sizeof(name), "%s_serialize_mb_s", kDocs[doc]);
+        u2bench_print_metric(name, (double)out.n * kRounds / ((double)doc_ser_ns / 1e3));
+        free(text.p);
+    }
+
+    u2bench_sink_f64(q.sum);
+    u2bench_print_time_ns(parse_ns + query_ns + ser_ns);
+    u2bench_print_metric("parse_mb_s", (double)in_bytes / ((double)parse_ns / 1e3));
+    u2bench_print_metric("serialize_mb_s", (double)out_bytes / ((double)ser_ns / 1e3));
+    u2bench_print_metric("query_ns_per_path", (double)query_ns / (double)q.paths);
+    u2bench_print_metric("dom_bytes", (double)dom_bytes);
+    u2bench_print_metric("errors", (double)(errors + q.misses));
+    free(out.p);
+    check_arena.destroy();
+    arena.destroy();
+    return errors + q.misses == 0 ? 0 : 1;
+}
@@ -0,0 +1,678 @@
+#include "bench_common.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Log filtering with a small regex engine: a fixed pattern set is compiled (recursive-descent parser -> Thompson
+// NFA program) and searched, unanchored, line by line over a generated ~3 MB access/application log, with
+//   backtrack  re1-style backtracking over the program (explicit thread stack, no memoization)
+//   dfa        lazily built DFA: NFA state sets interned in a hash table, 256-way transition rows filled on first
+//              use; the cache is flushed when it exceeds kMaxStates
+// Syntax: literals, ., [...] / [^...] with ranges, \d \w \s and escaped metacharacters, * + ?, |, (...), ^ and $.
+// Both matchers must agree on every pattern's matching-line count.
+// Metrics: backtrack_mb_s / dfa_mb_s (log bytes x patterns / time), dfa_states, dfa_flushes, matched_lines.
+
+namespace {
+
+constexpr uint32_t kLines = 16000;
+constexpr uint32_t kRounds = 2;
+constexpr uint32_t kMaxInst = 512;
+constexpr uint32_t kMaxClasses = 64;
+constexpr uint32_t kMaxStates = 2048;
+
+const char* const kPatterns[] = {
+    "ERROR|FATAL",
+    "status=5\\d\\d",
+    "latency_ms=\\d\\d\\d+\\.\\d",
+    " /api/v\\d/users/\\d+ HTTP",
+    "ip=10\\.0\\.\\d+\\.\\d+",
+    "[a-z0-9._]+@[a-z0-9]+\\.(com|org|net)",
+    "^\\d\\d\\d\\d-\\d\\d-\\d\\dT\\d\\d:\\d\\d:\\d\\d\\.\\d+Z WARN ",
+    "timeout.*retry",
+    "(GET|POST) [^ ]*/orders/[0-9a-f]+ HTTP/1\\.[01]\"$",
+};
+constexpr uint32_t kNumPatterns = sizeof(kPatterns) / sizeof(kPatterns[0]);
+
+// ---- compiler ------------------------------------------------------------------------------------------------
+
+enum Op : uint8_t { kChar, kClass, kAny, kSplit, kJmp, kBol, kEol, kMatch };
+
+struct Inst {
+    Op op;
+    uint8_t c;
+    uint16_t cls;
+    int32_t x;
+    int32_t y;
+};
+
+struct Program {
+    Inst inst[kMaxInst];
+    uint32_t n = 0;
+    uint32_t classes[kMaxClasses][8];  // 256-bit byte sets
+    uint32_t ncls = 0;
+
+    bool in_class(uint16_t cls, uint8_t b) const { return (classes[cls][b >> 5] >> (b & 31)) & 1u; }
+};
+
+enum NodeType : uint8_t { NLit, NClass, NAny, NCat, NAlt, NStar, NPlus, NQuest, NBol, NEol, NEmpty };
+
+struct Node {
+    NodeType t;
+    uint8_t c;
+    uint16_t cls;
+    int32_t l;
+    int32_t r;
+};
+
+struct Compiler {
+    const char* s;
+    Program* prog;
+    Node nodes[kMaxInst];
+    int32_t nn = 0;
+    bool ok = true;
+
+    int32_t mk(NodeType t, int32_t l = -1, int32_t r = -1) {
+        if (nn == (int32_t)kMaxInst) {
+            ok = false;
+            return 0;
+        }
+        nodes[nn] = Node{t, 0, 0, l, r};
+        return nn++;
+    }
+
+    uint16_t new_class() {
+        if (prog->ncls == kMaxClasses) {
+            ok = false;
+            return 0;
+        }
+        memset(prog->classes[prog->ncls], 0, sizeof(prog->classes[0]));
+        return (uint16_t)prog->ncls++;
+    }
+
+    void set(uint16_t cls, uint8_t b) { prog->classes[cls][b >> 5] |= 1u << (b & 31); }
+
+    void set_range(uint16_t cls, uint8_t lo, uint8_t hi) {
+        for (uint32_t b = lo; b <= hi; ++b) set(cls, (uint8_t)b);
+    }
+
+    // \d \w \s into `cls`; returns false for a plain escaped byte.
+    bool escape_class(char e, uint16_t cls) {
+        switch (e) {
+            case 'd': set_range(cls, '0', '9'); return true;
+            case 'w':
+                set_range(cls, 'a', 'z');
+                set_range(cls, 'A', 'Z');
+                set_range(cls, '0', '9');
+                set(cls, '_');
+                return true;
+            case 's':
+                set(cls, ' ');
+                set(cls, '\t');
+                set(cls, '\r');
+                set(cls, '\n');
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    int32_t atom() {
+        const char c = *s++;
+        switch (c) {
+            case '(': {
+                const int32_t n = alt();
+                if (*s++ != ')') ok = false;
+                return n;
+            }
+            case '.': return mk(NAny);
+            case '^': return mk(NBol);
+            case '$': return mk(NEol);
+            case '[': {
+                const int32_t n = mk(NClass);
+                const uint16_t cls = new_class();
+                nodes[n].cls = cls;
+                const bool neg = *s == '^';
+                if (neg) ++s;
+                bool first = true;
+                while (*s && (*s != ']' || first)) {
+                    first = false;
+                    uint8_t lo = (uint8_t)*s++;
+                    if (lo == '\\') {
+                        const char e = *s++;
+                        if (escape_class(e, cls)) continue;
+                        lo = (uint8_t)e;
+                    }
+                    if (s[0] == '-' && s[1] && s[1] != ']') {
+                        set_range(cls, lo, (uint8_t)s[1]);
+                        s += 2;
+                    } else {
+                        set(cls, lo);
+                    }
+                }
+                if (*s++ != ']') ok = false;
+                if (neg) {
+                    for (uint32_t& w : prog->classes[cls]) w = ~w;
+                }
+                return n;
+            }
+            case '\\': {
+                const char e = *s++;
+                if (e == 'd' || e == 'w' || e == 's') {
+                    const int32_t n = mk(NClass);
+                    nodes[n].cls = new_class();
+                    escape_class(e, nodes[n].cls);
+                    return n;
+                }
+                const int32_t n = mk(NLit);
+                nodes[n].c = (uint8_t)e;
+                return n;
+            }
+            default: {
+                const int32_t n = mk(NLit);
+                nodes[n].c = (uint8_t)c;
+                return n;
+            }
+        }
+    }
+
+    int32_t repeat() {
+        int32_t n = atom();
+        for (;;) {
+            if (*s == '*') {
+                n = mk(NStar, n);
+            } else if (*s == '+') {
+                n = mk(NPlus, n);
+            } else if (*s == '?') {
+                n = mk(NQuest, n);
+            } else {
+                return n;
+            }
+            ++s;
+        }
+    }
+
+    int32_t cat() {
+        int32_t n = -1;
+        while (*s && *s != '|' && *s != ')') {
+            const int32_t r = repeat();
+            n = n < 0 ? r : mk(NCat, n, r);
+        }
+        return n < 0 ? mk(NEmpty) : n;
+    }
+
+    int32_t alt() {
+        int32_t n = cat();
+        while (*s == '|') {
+            ++s;
+            n = mk(NAlt, n, cat());
+        }
+        return n;
+    }
+
+    uint32_t emit(Op op) {
+        if (prog->n == kMaxInst) {
+            ok = false;
+            return 0;
+        }
+        prog->inst[prog->n] = Inst{op, 0, 0, 0, 0};
+        return prog->n++;
+    }
+
+    void gen(int32_t id) {
+        const Node& nd = nodes[id];
+        switch (nd.t) {
+            case NLit: prog->inst[emit(kChar)].c = nd.c; break;
+            case NClass: prog->inst[emit(kClass)].cls = nd.cls; break;
+            case NAny: emit(kAny); break;
+            case NBol: emit(kBol); break;
+            case NEol: emit(kEol); break;
+            case NEmpty: break;
+            case NCat:
+                gen(nd.l);
+                gen(nd.r);
+                break;
+            case NAlt: {
+                const uint32_t split = emit(kSplit);
+                prog->inst[split].x = (int32_t)prog->n;
+                gen(nd.l);
+                const uint32_t jmp = emit(kJmp);
+                prog->inst[split].y = (int32_t)prog->n;
+                gen(nd.r);
+                prog->inst[jmp].x = (int32_t)prog->n;
+                break;
+            }
+            case NQuest: {
+                const uint32_t split = emit(kSplit);
+                prog->inst[split].x = (int32_t)prog->n;
+                gen(nd.l);
+                prog->inst[split].y = (int32_t)prog->n;
+                break;
+            }
+            case NStar: {
+                const uint32_t split = emit(kSplit);
+                prog->inst[split].x = (int32_t)prog->n;
+                gen(nd.l);
+                prog->inst[emit(kJmp)].x = (int32_t)split;
+                prog->inst[split].y = (int32_t)prog->n;
+                break;
+            }
+            case NPlus: {
+                const uint32_t start = prog->n;
+                gen(nd.l);
+                const uint32_t split = emit(kSplit);
+                prog->inst[split].x = (int32_t)start;
+                prog->inst[split].y = (int32_t)prog->n;
+                break;
+            }
+        }
+    }
+};
+
+bool compile(const char* pattern, Program* prog) {
+    static Compiler c;
+    c.s = pattern;
+    c.prog = prog;
+    c.nn = 0;
+    c.ok = true;
+    prog->n = 0;
+    prog->ncls = 0;
+    const int32_t root = c.alt();
+    if (*c.s != '\0') c.ok = false;
+    if (c.ok) c.gen(root);
+    c.emit(kMatch);
+    return c.ok;
+}
+
+// ---- backtracking --------------------------------------------------------------------------------------------
+
+struct Thread {
+    int32_t pc;
+    int32_t sp;
+};
+
+struct Backtracker {
+    Thread* stack = nullptr;
+    uint32_t cap = 0;
+
+    void push(uint32_t* n, int32_t pc, int32_t sp) {
+        if (*n == cap) {
+            cap = cap ? cap * 2 : 64;
+            stack = (Thread*)realloc(stack, cap * sizeof(Thread));
+            if (!stack) {
+                printf("realloc failed\n");
+                exit(1);
+            }
+        }
+        stack[(*n)++] = Thread{pc, sp};
+    }
+
+    bool match_at(const Program& prog, const uint8_t* line, int32_t len, int32_t start) {
+        uint32_t n = 0;
+        push(&n, 0, start);
+        while (n > 0) {
+            Thread t = stack[--n];
+            for (;;) {
+                const Inst& in = prog.inst[t.pc];
+                bool fail = false;
+                switch (in.op) {
+                    case kChar:
+                        fail = t.sp >= len || line[t.sp] != in.c;
+                        ++t.pc;
+                        ++t.sp;
+                        break;
+                    case kClass:
+                        fail = t.sp >= len || !prog.in_class(in.cls, line[t.sp]);
+                        ++t.pc;
+                        ++t.sp;
+                        break;
+                    case kAny:
+                        fail = t.sp >= len;
+                        ++t.pc;
+                        ++t.sp;
+                        break;
+                    case kSplit:
+                        push(&n, in.y, t.sp);
+                        t.pc = in.x;
+                        break;
+                    case kJmp: t.pc = in.x; break;
+                    case kBol:
+                        fail = t.sp != 0;
+                        ++t.pc;
+                        break;
+                    case kEol:
+                        fail = t.sp != len;
+                        ++t.pc;
+                        break;
+                    case kMatch: return true;
+                }
+                if (fail) break;
+            }
+        }
+        return false;
+    }
+
+    bool search(const Program& prog, const uint8_t* line, int32_t len) {
+        for (int32_t start = 0; start <= len; ++start) {
+            if (match_at(prog, line, len, start)) return true;
+        }
+        return false;
+    }
+};
+
+// ---- lazy DFA ------------------------------------------------------------------------------------------------
+
+struct DState {
+    int32_t* pcs;
+    uint32_t npcs;
+    uint32_t hash;
+    int32_t next[256];  // -1: not built yet
+    bool match;
+    bool eol_match;
+};
+
+struct Dfa {
+    const Program* prog = nullptr;
+    DState* states[kMaxStates];
+    uint32_t nstates = 0;
+    int32_t table[kMaxStates * 2];  // open addressing: state id + 1, 0 = empty
+    int32_t start = -1;
+    uint64_t built = 0;
+    uint64_t flushes = 0;
+    // Scratch for closure/step.
+    int32_t set_buf[kMaxInst];
+    uint32_t set_n = 0;
+    uint32_t mark[kMaxInst];
+    uint32_t gen = 0;
+    int32_t work[kMaxInst];
+
+    void init(const Program* p) {
+        prog = p;
+        clear();
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < nstates; ++i) {
+            free(states[i]->pcs);
+            free(states[i]);
+        }
+        nstates = 0;
+        memset(table, 0, sizeof(table));
+        start = -1;
+    }
+
+    void add(int32_t pc, bool at_bol) {
+        int32_t top = 0;
+        work[top++] = pc;
+        while (top > 0) {
+            const int32_t p = work[--top];
+            if (mark[p] == gen) continue;
+            mark[p] = gen;
+            const Inst& in = prog->inst[p];
+            switch (in.op) {
+                case kSplit:
+                    work[top++] = in.y;
+                    work[top++] = in.x;
+                    break;
+                case kJmp: work[top++] = in.x; break;
+                case kBol:
+                    if (at_bol) work[top++] = p + 1;
+                    break;
+                default: set_buf[set_n++] = p; break;  // consuming, Eol or Match
+            }
+        }
+    }
+
+    // Whether `pc` reaches Match when the input ends here (passing Eol assertions).
+    bool eol_reaches_match(int32_t pc) {
+        int32_t top = 0;
+        work[top++] = pc;
+        ++gen;
+        while (top > 0) {
+            const int32_t p = work[--top];
+            if (mark[p] == gen) continue;
+            mark[p] = gen;
+            const Inst& in = prog->inst[p];
+            switch (in.op) {
+                case kMatch: return true;
+                case kSplit:
+                    work[top++] = in.y;
+                    work[top++] = in.x;
+                    break;
+                case kJmp: work[top++] = in.x; break;
+                case kEol: work[top++] = p + 1; break;
+                default: break;
+            }
+        }
+        return false;
+    }
+
+    static uint32_t hash_set(const int32_t* pcs, uint32_t n) {
+        uint32_t h = 2166136261u;
+        for (uint32_t i = 0; i < n; ++i) h = (h ^ (uint32_t)pcs[i]) * 16777619u;
+        return h;
+    }
+
+    // Interns the current set_buf as a state; returns its id or -1 when the cache is full.
+    int32_t intern() {
+        // Sort (insertion sort; sets are small) so equal sets hash equally.
+        for (uint32_t i = 1; i < set_n; ++i) {
+            const int32_t v = set_buf[i];
+            uint32_t j = i;
+            for (; j > 0 && set_buf[j - 1] > v; --j) set_buf[j] = set_buf[j - 1];
+            set_buf[j] = v;
+        }
+        const uint32_t h = hash_set(set_buf, set_n);
+        uint32_t slot = h & (kMaxStates * 2 - 1);
+        for (; table[slot] != 0; slot = (slot + 1) & (kMaxStates * 2 - 1)) {
+            const DState* s = states[table[slot] - 1];
+            if (s->hash == h && s->npcs == set_n && memcmp(s->pcs, set_buf, set_n * sizeof(int32_t)) == 0) {
+                return table[slot] - 1;
+            }
+        }
+        if (nstates == kMaxStates) return -1;
+        DState* s = (DState*)malloc(sizeof(DState));
+        s->pcs = (int32_t*)malloc((set_n ? set_n : 1) * sizeof(int32_t));
+        if (!s || !s->pcs) {
+            printf("malloc failed\n");
+            exit(1);
+        }
+        memcpy(s->pcs, set_buf, set_n * sizeof(int32_t));
+        s->npcs = set_n;
+        s->hash = h;
+        memset(s->next, 0xff, sizeof(s->next));
+        s->match = false;
+        s->eol_match = false;
+        for (uint32_t i = 0; i < set_n; ++i) {
+            const Op op = prog->inst[set_buf[i]].op;
+            s->match |= op == kMatch;
+            if (op == kEol) s->eol_match |= eol_reaches_match(set_buf[i]);
+        }
+        s->eol_match |= s->match;
+        const int32_t id = (int32_t)nstates++;
+        states[id] = s;
+        table[slot] = id + 1;
+        ++built;
+        return id;
+    }
+
+    int32_t start_state() {
+        if (start < 0) {
+            ++gen;
+            set_n = 0;
+            add(0, true);
+            start = intern();
+        }
+        return start;
+    }
+
+    // Builds the transition from state `id` on byte `b` (unanchored: the program restarts at every position).
+    int32_t step(int32_t id, uint8_t b) {
+        const DState* s = states[id];
+        ++gen;
+        set_n = 0;
+        for (uint32_t i = 0; i < s->npcs; ++i) {
+            const int32_t pc = s->pcs[i];
+            const Inst& in = prog->inst[pc];
+            const bool take = (in.op == kChar && in.c == b) || (in.op == kClass && prog->in_class(in.cls, b)) ||
+                              (in.op == kAny && b != '\n');
+            if (take) add(pc + 1, false);
+        }
+        add(0, false);
+        int32_t next = intern();
+        if (next < 0) {
+            // Cache full: keep the target set, drop every state, re-intern it.
+            ++flushes;
+            int32_t saved[kMaxInst];
+            const uint32_t n = set_n;
+            memcpy(saved, set_buf, n * sizeof(int32_t));
+            clear();
+            memcpy(set_buf, saved, n * sizeof(int32_t));
+            set_n = n;
+            return intern();
+        }
+        states[id]->next[b] = next;
+        return next;
+    }
+
+    bool search(const uint8_t* line, int32_t len) {
+        int32_t st = start_state();
+        if (states[st]->match) return true;
+        for (int32_t i = 0; i < len; ++i) {
+            int32_t nx = states[st]->next[line[i]];
+            if (nx < 0) nx = step(st, line[i]);
+            st = nx;
+            if (states[st]->match) return true;
+        }
+        return states[st]->eol_match;
+    }
+};
+
+// ---- log corpus ----------------------------------------------------------------------------------------------
+
+struct Corpus {
+    char* text = nullptr;
+    size_t bytes = 0;
+    uint32_t* starts = nullptr;  // kLines + 1 offsets; lines exclude the '\n'
+};
+
+void generate(Corpus* c) {
+    static const char* const kLevels[] = {"INFO ", "INFO ", "INFO ", "DEBUG", "WARN ", "ERROR"};
+    static const char* const kMethods[] = {"GET", "GET", "POST", "PUT", "DELETE"};
+    static const char* const kDomains[] = {"com", "org", "net", "io"};
+    static const char* const kNotes[] = {
+        "",
+        "",
+        "",
+        " note=\"upstream timeout after 3000ms, scheduling retry\"",
+        " note=\"cache miss\"",
+        " note=\"FATAL: disk quota exceeded\"",
+        " note=\"retry budget exhausted before timeout\"",
+    };
+    const size_t cap = (size_t)kLines * 320;
+    c->text = (char*)malloc(cap);
+    c->starts = (uint32_t*)malloc((kLines + 1) * sizeof(uint32_t));
+    uint32_t rng = 0x0dd5eedu;
+    size_t n = 0;
+    for (uint32_t i = 0; i < kLines; ++i) {
+        c->starts[i] = (uint32_t)n;
+        const uint32_t r0 = u2bench_xorshift32(&rng);
+        const uint32_t r1 = u2bench_xorshift32(&rng);
+        const uint32_t r2 = u2bench_xorshift32(&rng);
+        const uint32_t secs = i * 3u + r0 % 3u;
+        char path[64];
+        if (r1 & 1u) {
+            snprintf(path, sizeof(path), "/api/v%u/users/%u", 1u + (r1 >> 1) % 2u, r2 % 100000u);
+        } else {
+            snprintf(path, sizeof(path), "/api/v%u/orders/%x", 1u + (r1 >> 1) % 3u, r2);
+        }
+        const uint32_t status = (r0 >> 8) % 20u == 0 ? 500u + (r0 >> 16) % 4u : ((r0 >> 8) % 7u == 0 ? 404u : 200u);
+        n += (size_t)snprintf(
+            c->text + n, cap - n,
+            "2024-05-%02uT%02u:%02u:%02u.%03uZ %s [worker-%u] request_id=%08x ip=10.%u.%u.%u user=%c%c%u@example.%s "
+            "status=%u latency_ms=%u.%u%s \"%s %s HTTP/1.%u\"",
+            1u + secs / 86400u % 28u, secs / 3600u % 24u, secs / 60u % 60u, secs % 60u, r2 % 1000u,
+            kLevels[r0 % 6u], r1 % 32u, r1 ^ r2, (r2 >> 4) % 2u, (r2 >> 8) % 4u, (r2 >> 12) % 256u,
+            'a' + (char)(r1 % 26u), 'a' + (char)((r1 >> 5) % 26u), r1 % 1000u, kDomains[(r2 >> 20) % 4u], status,
+            (r2 >> 3) % ((r0 & 0x30u) ? 200u : 3000u), (r2 >> 13) % 10u, kNotes[(r1 >> 9) % 7u],
+            kMethods[(r1 >> 12) % 5u], path, (r2 >> 24) % 2u);
+        c->text[n++] = '\n';
+    }
+    c->starts[kLines] = (uint32_t)n;
+    c->bytes = n;
+}
+
+}  // namespace
+
+int main() {
+    static Corpus corpus;
+    generate(&corpus);
+    static Program progs[kNumPatterns];
+    for (uint32_t p = 0; p < kNumPatterns; ++p) {
+        if (!compile(kPatterns[p], &progs[p])) {
+            printf("bad pattern: %s\n", kPatterns[p]);
+            return 1;
+        }
+    }
+
+    Backtracker bt;
+    static Dfa dfas[kNumPatterns];
+    uint32_t bt_counts[kNumPatterns] = {};
+    uint32_t dfa_counts[kNumPatterns] = {};
+
+    const uint64_t t0 = u2bench_now_ns();
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        for (uint32_t p = 0; p < kNumPatterns; ++p) {
+            uint32_t hits = 0;
+            for (uint32_t i = 0; i < kLines; ++i) {
+                const uint8_t* line = (const uint8_t*)corpus.text + corpus.starts[i];
+                hits += bt.search(progs[p], line, (int32_t)(corpus.starts[i + 1] - corpus.starts[i] - 1));
+            }
+            bt_counts[p] = hits;
+        }
+    }
+    const uint64_t t1 = u2bench_now_ns();
+    for (uint32_t p = 0; p < kNumPatterns; ++p) dfas[p].init(&progs[p]);
+    for (uint32_t round = 0; round < kRounds; ++round) {
+        for (uint32_t p = 0; p < kNumPatterns; ++p) {
+            uint32_t hits = 0;
+            for (uint32_t i = 0; i < kLines; ++i) {
+                const uint8_t* line = (const uint8_t*)corpus.text + corpus.starts[i];
+                hits += dfas[p].search(line, (int32_t)(corpus.starts[i + 1] - corpus.starts[i] - 1));
+            }
+            dfa_counts[p] = hits;
+        }
+    }
+    const uint64_t t2 = u2bench_now_ns();
+
+    uint32_t mismatches = 0;
+    uint64_t matched = 0;
+    uint64_t states = 0;
+    uint64_t flushes = 0;
+    for (uint32_t p = 0; p < kNumPatterns; ++p) {
+        mismatches += bt_counts[p] != dfa_counts[p];
+        matched += dfa_counts[p];
+        states += dfas[p].built;
+        flushes += dfas[p].flushes;
+        dfas[p].clear();
+    }
+    const double mb = (double)corpus.bytes * kNumPatterns * kRounds / 1e6;
+    u2bench_sink_u64(matched);
+    u2bench_print_time_ns(t2 - t0);
+    u2bench_print_metric("backtrack_mb_s", mb / ((double)(t1 - t0) / 1e9));
+    u2bench_print_metric("dfa_mb_s", mb / ((double)(t2 - t1) / 1e9));
+    u2bench_print_metric("log_bytes", (double)corpus.bytes);
+    u2bench_print_metric("dfa_states", (double)states);
+    u2bench_print_metric("dfa_flushes", (double)flushes);
+    u2bench_print_metric("matched_lines", (double)matched);
+    u2bench_print_metric("mismatches", (double)mismatches);
+    if (mismatches) {
+        for (uint32_t p = 0; p < kNumPatterns; ++p) {
+            printf("pattern %u: backtrack %u dfa %u\n", p, bt_counts[p], dfa_counts[p]);
+        }
+    }
+    free(bt.stack);
+    free(corpus.text);
+    free(corpus.starts);
+    return mismatches == 0 ? 0 : 1;
+}
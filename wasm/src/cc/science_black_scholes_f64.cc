@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
 static inline double norm_cdf(double x) {
     // Abramowitz & Stegun 7.1.26 approximation.
     // max error ~ 7e-8 for typical inputs; good enough for benchmarking.
@@ -27,6 +31,27 @@ static inline double norm_cdf(double x) {
     return cdf;
 }
 
+#if defined(__wasm_relaxed_simd__)
+// Relaxed-SIMD tier: N(d1) and N(d2) in the two f64x2 lanes, with the A&S polynomial and the tail
+// evaluated via f64x2.relaxed_madd (fused or not, engine's choice). exp stays scalar per lane.
+static inline v128_t norm_cdf2(v128_t x) {
+    const v128_t one = wasm_f64x2_splat(1.0);
+    const v128_t ax = wasm_f64x2_abs(x);
+    const v128_t t = wasm_f64x2_div(one, wasm_f64x2_relaxed_madd(wasm_f64x2_splat(0.2316419), ax, one));
+    v128_t poly = wasm_f64x2_relaxed_madd(wasm_f64x2_splat(1.330274429), t, wasm_f64x2_splat(-1.821255978));
+    poly = wasm_f64x2_relaxed_madd(poly, t, wasm_f64x2_splat(1.781477937));
+    poly = wasm_f64x2_relaxed_madd(poly, t, wasm_f64x2_splat(-0.356563782));
+    poly = wasm_f64x2_relaxed_madd(poly, t, wasm_f64x2_splat(0.319381530));
+    const double a0 = wasm_f64x2_extract_lane(ax, 0);
+    const double a1 = wasm_f64x2_extract_lane(ax, 1);
+    const v128_t pdf = wasm_f64x2_mul(
+        wasm_f64x2_splat(0.39894228040143267793994605993438), wasm_f64x2_make(exp(-0.5 * a0 * a0), exp(-0.5 * a1 * a1))
+    );
+    const v128_t cdf = wasm_f64x2_relaxed_nmadd(wasm_f64x2_mul(pdf, poly), t, one);
+    return wasm_v128_bitselect(wasm_f64x2_sub(one, cdf), cdf, wasm_f64x2_lt(x, wasm_f64x2_splat(0.0)));
+}
+#endif
+
 int main() {
     constexpr int kN = 20000;
     constexpr int kReps = 25;
@@ -68,8 +93,14 @@ int main() {
             const double d2 = d1 - vt;
             const double disc = exp(-r * t);
 
+#if defined(__wasm_relaxed_simd__)
+            const v128_t nd = norm_cdf2(wasm_f64x2_make(d1, d2));
+            const double nd1 = wasm_f64x2_extract_lane(nd, 0);
+            const double nd2 = wasm_f64x2_extract_lane(nd, 1);
+#else
             const double nd1 = norm_cdf(d1);
             const double nd2 = norm_cdf(d2);
+#endif
             const double call = s * nd1 - k * disc * nd2;
             const double put = call + k * disc - s;
             sum += call + put;
@@ -84,6 +115,7 @@ int main() {
     free(S);
     u2bench_sink_f64(sum);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", sum);
     return 0;
 }
 
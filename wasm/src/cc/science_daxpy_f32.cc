@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
 int main() {
     constexpr size_t kN = 250000;
     constexpr int kReps = 100;
@@ -26,9 +30,21 @@ int main() {
 
     const uint64_t t0 = u2bench_now_ns();
     for (int rep = 0; rep < kReps; ++rep) {
+#if defined(__wasm_relaxed_simd__)
+        // Relaxed-SIMD tier: explicit f32x4.relaxed_madd (fused or not, engine's choice).
+        const v128_t va = wasm_f32x4_splat(a);
+        size_t i = 0;
+        for (; i + 4 <= kN; i += 4) {
+            wasm_v128_store(y + i, wasm_f32x4_relaxed_madd(va, wasm_v128_load(x + i), wasm_v128_load(y + i)));
+        }
+        for (; i < kN; ++i) {
+            y[i] = a * x[i] + y[i];
+        }
+#else
         for (size_t i = 0; i < kN; ++i) {
             y[i] = a * x[i] + y[i];
         }
+#endif
     }
     const uint64_t t1 = u2bench_now_ns();
 
@@ -41,6 +57,7 @@ int main() {
     free(y);
     u2bench_sink_f64(sum);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", sum);
     return 0;
 }
 
@@ -3,6 +3,10 @@
 #include <math.h>
 #include <stdint.h>
 
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
 #ifndef U2BENCH_EXTRA_KIND
 #define U2BENCH_EXTRA_KIND 1
 #endif
@@ -14,6 +18,37 @@ static inline double u2bench_rand_sym(uint64_t* s) {
     return u * 2.0 - 1.0;
 }
 
+// Dot product and w = y + a * x for the Krylov solvers (poisson_cg, bicgstab, gmres). The relaxed-SIMD build
+// runs both on f64x2.relaxed_madd (fused or not, engine's choice); other builds keep the plain scalar loops.
+static inline double u2bench_dot_f64(const double* a, const double* b, int n) {
+    double sum = 0.0;
+    int i = 0;
+#if defined(__wasm_relaxed_simd__)
+    v128_t acc = wasm_f64x2_splat(0.0);
+    for (; i + 2 <= n; i += 2) {
+        acc = wasm_f64x2_relaxed_madd(wasm_v128_load(a + i), wasm_v128_load(b + i), acc);
+    }
+    sum = wasm_f64x2_extract_lane(acc, 0) + wasm_f64x2_extract_lane(acc, 1);
+#endif
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static inline void u2bench_waxpy_f64(double* w, const double* y, double a, const double* x, int n) {
+    int i = 0;
+#if defined(__wasm_relaxed_simd__)
+    const v128_t va = wasm_f64x2_splat(a);
+    for (; i + 2 <= n; i += 2) {
+        wasm_v128_store(w + i, wasm_f64x2_relaxed_madd(va, wasm_v128_load(x + i), wasm_v128_load(y + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        w[i] = y[i] + a * x[i];
+    }
+}
+
 #if U2BENCH_EXTRA_KIND == 1
 
 int main() {
@@ -119,6 +154,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -140,14 +176,6 @@ static inline void poisson_apply(const double* src, double* dst) {
     }
 }
 
-static inline double dot_product(const double* a, const double* b, int n) {
-    double sum = 0.0;
-    for (int i = 0; i < n; ++i) {
-        sum += a[i] * b[i];
-    }
-    return sum;
-}
-
 int main() {
     constexpr int kW = 64;
     constexpr int kH = 64;
@@ -189,22 +217,18 @@ int main() {
             p[i] = r[i];
         }
 
-        double rr = dot_product(r, r, kN);
+        double rr = u2bench_dot_f64(r, r, kN);
         for (int iter = 0; iter < kIters; ++iter) {
             poisson_apply(p, ap);
-            const double pap = dot_product(p, ap, kN) + 1e-18;
+            const double pap = u2bench_dot_f64(p, ap, kN) + 1e-18;
             const double alpha = rr / pap;
 
-            for (int i = 0; i < kN; ++i) {
-                x[i] += alpha * p[i];
-                r[i] -= alpha * ap[i];
-            }
+            u2bench_waxpy_f64(x, x, alpha, p, kN);
+            u2bench_waxpy_f64(r, r, -alpha, ap, kN);
 
-            const double rr_new = dot_product(r, r, kN);
+            const double rr_new = u2bench_dot_f64(r, r, kN);
             const double beta = rr_new / (rr + 1e-30);
-            for (int i = 0; i < kN; ++i) {
-                p[i] = r[i] + beta * p[i];
-            }
+            u2bench_waxpy_f64(p, r, beta, p, kN);
             rr = rr_new;
         }
 
@@ -221,6 +245,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -317,6 +342,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -375,6 +401,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -486,6 +513,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -547,6 +575,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -619,6 +648,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -685,6 +715,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -816,6 +847,7 @@ int main() {
 
     u2bench_sink_f64(payoff);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", payoff);
     return 0;
 }
 
@@ -933,6 +965,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1050,6 +1083,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1195,6 +1229,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1309,6 +1344,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1480,6 +1516,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1613,6 +1650,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1692,6 +1730,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1776,6 +1815,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -1925,6 +1965,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2006,6 +2047,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2117,6 +2159,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2179,10 +2222,7 @@ int main() {
 
     const uint64_t t0 = u2bench_now_ns();
     for (int iter = 0; iter < kIters; ++iter) {
-        double rho = 0.0;
-        for (int i = 0; i < kN; ++i) {
-            rho += r0[i] * r[i];
-        }
+        const double rho = u2bench_dot_f64(r0, r, kN);
         if (fabs(rho) < 1e-18) {
             break;
         }
@@ -2193,9 +2233,8 @@ int main() {
             }
         } else {
             const double beta = (rho / rho_prev) * (alpha / omega);
-            for (int i = 0; i < kN; ++i) {
-                p[i] = r[i] + beta * (p[i] - omega * v[i]);
-            }
+            u2bench_waxpy_f64(p, p, -omega, v, kN);
+            u2bench_waxpy_f64(p, r, beta, p, kN);
         }
 
         for (int i = 0; i < kN; ++i) {
@@ -2203,17 +2242,11 @@ int main() {
         }
         bicgstab_apply(phat, v);
 
-        double denom = 0.0;
-        for (int i = 0; i < kN; ++i) {
-            denom += r0[i] * v[i];
-        }
+        const double denom = u2bench_dot_f64(r0, v, kN);
         alpha = rho / ((fabs(denom) < 1e-18) ? 1e-18 : denom);
 
-        double snorm = 0.0;
-        for (int i = 0; i < kN; ++i) {
-            s[i] = r[i] - alpha * v[i];
-            snorm += s[i] * s[i];
-        }
+        u2bench_waxpy_f64(s, r, -alpha, v, kN);
+        const double snorm = u2bench_dot_f64(s, s, kN);
 
         if (snorm < 1e-16) {
             for (int i = 0; i < kN; ++i) {
@@ -2227,12 +2260,8 @@ int main() {
         }
         bicgstab_apply(shat, t);
 
-        double tt = 0.0;
-        double ts = 0.0;
-        for (int i = 0; i < kN; ++i) {
-            tt += t[i] * t[i];
-            ts += t[i] * s[i];
-        }
+        const double tt = u2bench_dot_f64(t, t, kN);
+        const double ts = u2bench_dot_f64(t, s, kN);
         omega = ts / ((fabs(tt) < 1e-18) ? 1e-18 : tt);
 
         for (int i = 0; i < kN; ++i) {
@@ -2250,6 +2279,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2336,6 +2366,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2415,20 +2446,12 @@ int main() {
         for (; m < kRestart; ++m) {
             gmres_apply(v[m], w);
             for (int i = 0; i <= m; ++i) {
-                double hij = 0.0;
-                for (int k = 0; k < kN; ++k) {
-                    hij += w[k] * v[i][k];
-                }
+                const double hij = u2bench_dot_f64(w, v[i], kN);
                 h[i][m] = hij;
-                for (int k = 0; k < kN; ++k) {
-                    w[k] -= hij * v[i][k];
-                }
+                u2bench_waxpy_f64(w, w, -hij, v[i], kN);
             }
 
-            double normw2 = 0.0;
-            for (int k = 0; k < kN; ++k) {
-                normw2 += w[k] * w[k];
-            }
+            const double normw2 = u2bench_dot_f64(w, w, kN);
             h[m + 1][m] = sqrt(normw2);
             if (h[m + 1][m] > 1e-14) {
                 for (int k = 0; k < kN; ++k) {
@@ -2468,9 +2491,7 @@ int main() {
             ycoef[i] = sum / ((fabs(h[i][i]) < 1e-18) ? 1e-18 : h[i][i]);
         }
         for (int j = 0; j < used; ++j) {
-            for (int i = 0; i < kN; ++i) {
-                x[i] += ycoef[j] * v[j][i];
-            }
+            u2bench_waxpy_f64(x, x, ycoef[j], v[j], kN);
         }
     }
     const uint64_t t1 = u2bench_now_ns();
@@ -2487,6 +2508,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2566,6 +2588,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2704,6 +2727,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2814,6 +2838,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -2944,6 +2969,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
@@ -3049,6 +3075,7 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
 
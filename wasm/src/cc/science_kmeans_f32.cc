@@ -3,6 +3,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
 static inline float u2bench_frand01(uint32_t* state) {
     const uint32_t x = u2bench_xorshift32(state);
     const uint32_t mant = x & 0x00ffffffu;
@@ -13,6 +17,7 @@ int main() {
     constexpr int kN = 50000;
     constexpr int kK = 16;
     constexpr int kIters = 25;
+    static_assert(kK % 4 == 0, "relaxed kernel steps 4 lanes");
 
     float* px = (float*)malloc((size_t)kN * sizeof(float));
     float* py = (float*)malloc((size_t)kN * sizeof(float));
@@ -57,6 +62,24 @@ int main() {
             int bestk = 0;
             const float x = px[i];
             const float y = py[i];
+#if defined(__wasm_relaxed_simd__)
+            // Relaxed-SIMD tier: four centroid distances per f32x4.relaxed_madd, then the same first-min scan.
+            float dist[kK];
+            const v128_t vx = wasm_f32x4_splat(x);
+            const v128_t vy = wasm_f32x4_splat(y);
+            for (int k = 0; k < kK; k += 4) {
+                const v128_t dx = wasm_f32x4_sub(vx, wasm_v128_load(&cx[k]));
+                const v128_t dy = wasm_f32x4_sub(vy, wasm_v128_load(&cy[k]));
+                wasm_v128_store(&dist[k], wasm_f32x4_relaxed_madd(dx, dx, wasm_f32x4_mul(dy, dy)));
+            }
+            for (int k = 0; k < kK; ++k) {
+                const float d = dist[k];
+                if (d < best) {
+                    best = d;
+                    bestk = k;
+                }
+            }
+#else
             for (int k = 0; k < kK; ++k) {
                 const float dx = x - cx[k];
                 const float dy = y - cy[k];
@@ -66,6 +89,7 @@ int main() {
                     bestk = k;
                 }
             }
+#endif
             asg[i] = (uint8_t)bestk;
             sx[bestk] += x;
             sy[bestk] += y;
@@ -101,5 +125,6 @@ int main() {
 
     u2bench_sink_f64(acc);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", acc);
     return 0;
 }
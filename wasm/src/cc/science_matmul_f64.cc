@@ -2,7 +2,12 @@
 
 #include <stdint.h>
 
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
 static constexpr int kN = 48;
+static_assert(kN % 2 == 0, "relaxed kernel steps 2 lanes");
 
 alignas(16) static double a[kN * kN];
 alignas(16) static double b[kN * kN];
@@ -22,9 +27,19 @@ int main() {
         for (int i = 0; i < kN; ++i) {
             for (int k = 0; k < kN; ++k) {
                 const double aik = a[i * kN + k];
+#if defined(__wasm_relaxed_simd__)
+                // Relaxed-SIMD tier: explicit f64x2.relaxed_madd; kN is a multiple of the lane count.
+                const v128_t va = wasm_f64x2_splat(aik);
+                for (int j = 0; j < kN; j += 2) {
+                    double* cp = &c[i * kN + j];
+                    const v128_t bv = wasm_v128_load(&b[k * kN + j]);
+                    wasm_v128_store(cp, wasm_f64x2_relaxed_madd(va, bv, wasm_v128_load(cp)));
+                }
+#else
                 for (int j = 0; j < kN; ++j) {
                     c[i * kN + j] += aik * b[k * kN + j];
                 }
+#endif
             }
         }
     }
@@ -36,6 +51,7 @@ int main() {
     }
     u2bench_sink_f64(sum);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", sum);
     return 0;
 }
 
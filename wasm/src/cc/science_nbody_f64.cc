@@ -3,6 +3,11 @@
 #include <math.h>
 #include <stdint.h>
 
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
+// x/y and vx/vy are adjacent so the relaxed-SIMD kernels can treat each pair as one f64x2.
 struct Body {
     double x;
     double y;
@@ -40,6 +45,40 @@ int main() {
 
     const uint64_t t0 = u2bench_now_ns();
     for (int step = 0; step < kSteps; ++step) {
+#if defined(__wasm_relaxed_simd__)
+        // Relaxed-SIMD tier: (x, y) lanes in f64x2, z scalar; accumulation and both integrations use
+        // f64x2.relaxed_madd (fused or not, engine's choice).
+        const v128_t vdt = wasm_f64x2_splat(kDt);
+        for (int i = 0; i < kN; ++i) {
+            v128_t axy = wasm_f64x2_splat(0.0);
+            double az = 0.0;
+            const v128_t pi = wasm_v128_load(&b[i].x);
+            const double zi = b[i].z;
+
+            for (int j = 0; j < kN; ++j) {
+                if (j == i) {
+                    continue;
+                }
+                const v128_t dxy = wasm_f64x2_sub(wasm_v128_load(&b[j].x), pi);
+                const double dz = b[j].z - zi;
+                const v128_t sq = wasm_f64x2_mul(dxy, dxy);
+                const double d2 = wasm_f64x2_extract_lane(sq, 0) + wasm_f64x2_extract_lane(sq, 1) + dz * dz + kEps;
+                const double inv = 1.0 / sqrt(d2);
+                const double inv3 = inv * inv * inv;
+                const double s = b[j].m * inv3;
+                axy = wasm_f64x2_relaxed_madd(dxy, wasm_f64x2_splat(s), axy);
+                az += dz * s;
+            }
+
+            wasm_v128_store(&b[i].vx, wasm_f64x2_relaxed_madd(axy, vdt, wasm_v128_load(&b[i].vx)));
+            b[i].vz += az * kDt;
+        }
+
+        for (int i = 0; i < kN; ++i) {
+            wasm_v128_store(&b[i].x, wasm_f64x2_relaxed_madd(wasm_v128_load(&b[i].vx), vdt, wasm_v128_load(&b[i].x)));
+            b[i].z += b[i].vz * kDt;
+        }
+#else
         for (int i = 0; i < kN; ++i) {
             double ax = 0.0;
             double ay = 0.0;
@@ -74,6 +113,7 @@ int main() {
             b[i].y += b[i].vy * kDt;
             b[i].z += b[i].vz * kDt;
         }
+#endif
     }
     const uint64_t t1 = u2bench_now_ns();
 
@@ -84,6 +124,7 @@ int main() {
 
     u2bench_sink_f64(sum);
     u2bench_print_time_ns(t1 - t0);
+    u2bench_print_metric("result", sum);
     return 0;
 }
 
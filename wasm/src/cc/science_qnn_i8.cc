@@ -0,0 +1,402 @@
+#include "bench_common.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+// Quantized int8 inference (TFLite-style: asymmetric int8 activations, symmetric per-channel int8 weights,
+// int32 bias, gemmlowp fixed-point requantization to int8 with a ReLU6/linear clamp):
+//   - GEMM: int8 x int8 -> int32 in 4x2 register tiles over K-contiguous operands (weights stored N x K);
+//     simd128 builds use i16x8 widening + i32x4.dot_i16x8, MVP builds the scalar widening loop.
+//   - Depthwise 3x3 (stride 1/2, zero-point padding) and pointwise 1x1 (= GEMM over pixels) convolutions.
+//   - A MobileNet-v1-like net on synthetic weights: 64x64x3 input, 3x3/s2 stem via im2col, five
+//     depthwise-separable blocks up to 128 channels, global average pool, 10-way FC (~4.3M MACs).
+// The tiled GEMM is checked against a naive scalar GEMM, standalone and through one full reference inference
+// (exact int8 equality).
+// Metrics: gemm_gmac_s (256^3 GEMM + requant), inferences_per_s, result (logit checksum, identical across tiers).
+
+namespace {
+
+constexpr uint32_t kGemmDim = 256;
+constexpr uint32_t kGemmReps = 8;
+constexpr uint32_t kInferences = 40;
+constexpr int32_t kMr = 4;
+constexpr int32_t kNr = 2;
+
+struct Requant {
+    int32_t* bias;  // per output channel, input zero-point already folded in
+    int32_t* mult;  // Q31 fixed-point multipliers (< 1.0)
+    int32_t* shift;  // right shifts
+    int32_t out_zp;
+    int32_t act_min;
+    int32_t act_max;
+};
+
+// gemmlowp SaturatingRoundingDoublingHighMul / RoundingDivideByPOT.
+inline int32_t srdhm(int32_t a, int32_t b) {
+    if (a == b && a == INT32_MIN) return INT32_MAX;
+    const int64_t ab = (int64_t)a * b;
+    const int64_t nudge = ab >= 0 ? (1ll << 30) : (1 - (1ll << 30));
+    return (int32_t)((ab + nudge) / (1ll << 31));
+}
+
+inline int32_t rdbpot(int32_t x, int32_t exponent) {
+    const int32_t mask = (int32_t)((1u << exponent) - 1u);
+    const int32_t rem = x & mask;
+    const int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+    return (x >> exponent) + (rem > threshold ? 1 : 0);
+}
+
+inline int8_t requantize(int32_t acc, const Requant& q, int32_t ch) {
+    int32_t v = rdbpot(srdhm(acc + q.bias[ch], q.mult[ch]), q.shift[ch]) + q.out_zp;
+    v = v < q.act_min ? q.act_min : v;
+    v = v > q.act_max ? q.act_max : v;
+    return (int8_t)v;
+}
+
+void quantize_multiplier(double m, int32_t* mult, int32_t* shift) {
+    int exp = 0;
+    const double frac = frexp(m, &exp);  // m = frac * 2^exp, frac in [0.5, 1)
+    int64_t q = (int64_t)llround(frac * (double)(1ll << 31));
+    if (q == (1ll << 31)) {
+        q /= 2;
+        ++exp;
+    }
+    *mult = (int32_t)q;
+    *shift = -exp;
+}
+
+// ---- GEMM ----------------------------------------------------------------------------------------------------
+
+// acc[r][c] = sum_k a[r*lda + k] * w[c*K + k], K a multiple of 16.
+template <int32_t MR, int32_t NR>
+inline void dot_tile(const int8_t* a, int32_t lda, const int8_t* w, int32_t k_len, int32_t acc[MR][NR]) {
+#if defined(__wasm_simd128__)
+    v128_t v[MR][NR];
+    for (int32_t r = 0; r < MR; ++r)
+        for (int32_t c = 0; c < NR; ++c) v[r][c] = wasm_i32x4_splat(0);
+    for (int32_t k = 0; k < k_len; k += 16) {
+        v128_t wl[NR];
+        v128_t wh[NR];
+        for (int32_t c = 0; c < NR; ++c) {
+            const v128_t wv = wasm_v128_load(w + c * k_len + k);
+            wl[c] = wasm_i16x8_extend_low_i8x16(wv);
+            wh[c] = wasm_i16x8_extend_high_i8x16(wv);
+        }
+        for (int32_t r = 0; r < MR; ++r) {
+            const v128_t av = wasm_v128_load(a + r * lda + k);
+            const v128_t al = wasm_i16x8_extend_low_i8x16(av);
+            const v128_t ah = wasm_i16x8_extend_high_i8x16(av);
+            for (int32_t c = 0; c < NR; ++c) {
+                v[r][c] = wasm_i32x4_add(v[r][c], wasm_i32x4_dot_i16x8(al, wl[c]));
+                v[r][c] = wasm_i32x4_add(v[r][c], wasm_i32x4_dot_i16x8(ah, wh[c]));
+            }
+        }
+    }
+    for (int32_t r = 0; r < MR; ++r)
+        for (int32_t c = 0; c < NR; ++c)
+            acc[r][c] = wasm_i32x4_extract_lane(v[r][c], 0) + wasm_i32x4_extract_lane(v[r][c], 1) +
+                        wasm_i32x4_extract_lane(v[r][c], 2) + wasm_i32x4_extract_lane(v[r][c], 3);
+#else
+    for (int32_t r = 0; r < MR; ++r)
+        for (int32_t c = 0; c < NR; ++c) acc[r][c] = 0;
+    for (int32_t k = 0; k < k_len; ++k) {
+        for (int32_t r = 0; r < MR; ++r) {
+            const int32_t av = a[r * lda + k];
+            for (int32_t c = 0; c < NR; ++c) acc[r][c] += av * (int32_t)w[c * k_len + k];
+        }
+    }
+#endif
+}
+
+// out (M x N, int8) = requant(a (M x K) * w^T (N x K)).
+void gemm_i8(const int8_t* a, const int8_t* w, int8_t* out, int32_t m, int32_t n, int32_t k, const Requant& q) {
+    int32_t i = 0;
+    for (; i + kMr <= m; i += kMr) {
+        int32_t j = 0;
+        for (; j + kNr <= n; j += kNr) {
+            int32_t acc[kMr][kNr];
+            dot_tile<kMr, kNr>(a + i * k, k, w + j * k, k, acc);
+            for (int32_t r = 0; r < kMr; ++r)
+                for (int32_t c = 0; c < kNr; ++c) out[(i + r) * n + j + c] = requantize(acc[r][c], q, j + c);
+        }
+        for (; j < n; ++j) {
+            int32_t acc[kMr][1];
+            dot_tile<kMr, 1>(a + i * k, k, w + j * k, k, acc);
+            for (int32_t r = 0; r < kMr; ++r) out[(i + r) * n + j] = requantize(acc[r][0], q, j);
+        }
+    }
+    for (; i < m; ++i) {
+        for (int32_t j = 0; j < n; ++j) {
+            int32_t acc[1][1];
+            dot_tile<1, 1>(a + i * k, k, w + j * k, k, acc);
+            out[i * n + j] = requantize(acc[0][0], q, j);
+        }
+    }
+}
+
+void gemm_i8_ref(const int8_t* a, const int8_t* w, int8_t* out, int32_t m, int32_t n, int32_t k, const Requant& q) {
+    for (int32_t i = 0; i < m; ++i) {
+        for (int32_t j = 0; j < n; ++j) {
+            int32_t acc = 0;
+            for (int32_t kk = 0; kk < k; ++kk) acc += (int32_t)a[i * k + kk] * (int32_t)w[j * k + kk];
+            out[i * n + j] = requantize(acc, q, j);
+        }
+    }
+}
+
+// ---- convolutions (NHWC) -------------------------------------------------------------------------------------
+
+// Depthwise 3x3, pad 1. Out-of-image taps read the input zero-point, i.e. contribute nothing.
+void depthwise3x3(const int8_t* in, int32_t h, int32_t w, int32_t ch, int32_t stride, int32_t in_zp,
+                  const int8_t* wt, int8_t* out, const Requant& q) {
+    const int32_t oh = (h - 1) / stride + 1;
+    const int32_t ow = (w - 1) / stride + 1;
+    int32_t acc[128];
+    for (int32_t y = 0; y < oh; ++y) {
+        for (int32_t x = 0; x < ow; ++x) {
+            for (int32_t c = 0; c < ch; ++c) acc[c] = 0;
+            for (int32_t ky = 0; ky < 3; ++ky) {
+                const int32_t iy = y * stride + ky - 1;
+                if (iy < 0 || iy >= h) continue;
+                for (int32_t kx = 0; kx < 3; ++kx) {
+                    const int32_t ix = x * stride + kx - 1;
+                    if (ix < 0 || ix >= w) continue;
+                    const int8_t* px = in + (iy * w + ix) * ch;
+                    const int8_t* tap = wt + (ky * 3 + kx) * ch;
+                    for (int32_t c = 0; c < ch; ++c) acc[c] += ((int32_t)px[c] - in_zp) * (int32_t)tap[c];
+                }
+            }
+            int8_t* po = out + (y * ow + x) * ch;
+            for (int32_t c = 0; c < ch; ++c) po[c] = requantize(acc[c], q, c);
+        }
+    }
+}
+
+// Stem: 3x3 stride 2 pad 1 over 3 channels as im2col (K = 27 padded to 32 with zero weights) + GEMM.
+void im2col_stem(const int8_t* in, int32_t h, int32_t w, int32_t in_zp, int8_t* cols) {
+    const int32_t oh = (h - 1) / 2 + 1;
+    const int32_t ow = (w - 1) / 2 + 1;
+    for (int32_t y = 0; y < oh; ++y) {
+        for (int32_t x = 0; x < ow; ++x) {
+            int8_t* row = cols + (y * ow + x) * 32;
+            int32_t k = 0;
+            for (int32_t ky = 0; ky < 3; ++ky) {
+                for (int32_t kx = 0; kx < 3; ++kx) {
+                    const int32_t iy = y * 2 + ky - 1;
+                    const int32_t ix = x * 2 + kx - 1;
+                    const bool inside = iy >= 0 && iy < h && ix >= 0 && ix < w;
+                    for (int32_t c = 0; c < 3; ++c) row[k++] = inside ? in[(iy * w + ix) * 3 + c] : (int8_t)in_zp;
+                }
+            }
+            for (; k < 32; ++k) row[k] = 0;
+        }
+    }
+}
+
+// ---- network -------------------------------------------------------------------------------------------------
+
+struct Layer {
+    int32_t cin;
+    int32_t cout;  // == cin for depthwise
+    int32_t k;  // GEMM K (padded) or 9 for depthwise
+    bool depthwise;
+    int32_t stride;
+    bool relu6;
+    int8_t* weights;
+    Requant q;
+};
+
+constexpr int32_t kIn = 64;
+constexpr int32_t kClasses = 10;
+constexpr int32_t kMaxAct = 32 * 32 * 32;  // largest activation tensor (block 1 pointwise output)
+constexpr int32_t kActZp = -16;
+
+struct Net {
+    Layer layers[13];
+    int32_t n = 0;
+    int8_t* act[2];
+    int8_t* cols;
+    int8_t* input;
+};
+
+// Synthetic weights: uniform int8, per-channel scales jittered around a fan-in-normalized multiplier so that
+// activations stay spread over the int8 range through the whole stack.
+void make_layer(Layer& l, uint32_t* rng, int32_t real_k) {
+    const int32_t per = l.depthwise ? 9 : l.k;
+    const int32_t n_w = l.depthwise ? 9 * l.cout : l.cout * l.k;
+    l.weights = (int8_t*)calloc((size_t)n_w, 1);
+    l.q.bias = (int32_t*)malloc(sizeof(int32_t) * (size_t)l.cout);
+    l.q.mult = (int32_t*)malloc(sizeof(int32_t) * (size_t)l.cout);
+    l.q.shift = (int32_t*)malloc(sizeof(int32_t) * (size_t)l.cout);
+    for (int32_t c = 0; c < l.cout; ++c) {
+        int64_t wsum = 0;
+        for (int32_t t = 0; t < real_k; ++t) {
+            const int8_t v = (int8_t)((int32_t)(u2bench_xorshift32(rng) % 255u) - 127);
+            if (l.depthwise) {
+                l.weights[t * l.cout + c] = v;
+            } else {
+                l.weights[c * per + t] = v;
+            }
+            wsum += v;
+        }
+        const int32_t bias = (int32_t)(u2bench_xorshift32(rng) % 4001u) - 2000;
+        // Depthwise subtracts the zero-point per tap (padding-aware); GEMM layers fold it into the bias.
+        l.q.bias[c] = l.depthwise ? bias : bias - kActZp * (int32_t)wsum;
+        const double jitter = 0.75 + (double)(u2bench_xorshift32(rng) % 1000u) / 2000.0;
+        quantize_multiplier(jitter * 1.6 / (sqrt((double)real_k) * 73.0), &l.q.mult[c], &l.q.shift[c]);
+    }
+    l.q.out_zp = kActZp;
+    l.q.act_min = l.relu6 ? kActZp : -128;
+    l.q.act_max = 127;
+}
+
+bool build_net(Net& net) {
+    uint32_t rng = 0xc0ffee11u;
+    auto add = [&](int32_t cin, int32_t cout, int32_t k, bool dw, int32_t stride, bool relu6, int32_t real_k) {
+        Layer& l = net.layers[net.n++];
+        l = Layer{cin, cout, k, dw, stride, relu6, nullptr, Requant{}};
+        make_layer(l, &rng, real_k);
+    };
+    add(3, 16, 32, false, 2, true, 27);  // stem -> 32x32x16
+    const int32_t blocks[5][3] = {{16, 32, 1}, {32, 64, 2}, {64, 64, 1}, {64, 128, 2}, {128, 128, 1}};
+    for (const auto& b : blocks) {
+        add(b[0], b[0], 9, true, b[2], true, 9);
+        add(b[0], b[1], b[0], false, 1, true, b[0]);
+    }
+    add(128, kClasses, 128, false, 1, false, 128);  // FC on pooled features, linear
+    net.act[0] = (int8_t*)malloc(kMaxAct);
+    net.act[1] = (int8_t*)malloc(kMaxAct);
+    net.cols = (int8_t*)malloc(32 * 32 * 32);
+    net.input = (int8_t*)malloc(kIn * kIn * 3);
+    if (!net.act[0] || !net.act[1] || !net.cols || !net.input) return false;
+    for (int32_t i = 0; i < kIn * kIn * 3; ++i) net.input[i] = (int8_t)((int32_t)(u2bench_xorshift32(&rng) & 255u) - 128);
+    return true;
+}
+
+void free_net(Net& net) {
+    for (int32_t i = 0; i < net.n; ++i) {
+        free(net.layers[i].weights);
+        free(net.layers[i].q.bias);
+        free(net.layers[i].q.mult);
+        free(net.layers[i].q.shift);
+    }
+    free(net.act[0]);
+    free(net.act[1]);
+    free(net.cols);
+    free(net.input);
+}
+
+using GemmFn = void (*)(const int8_t*, const int8_t*, int8_t*, int32_t, int32_t, int32_t, const Requant&);
+
+void infer(Net& net, GemmFn gemm, int8_t* logits) {
+    int32_t h = kIn;
+    int32_t w = kIn;
+    im2col_stem(net.input, h, w, kActZp, net.cols);
+    h = (h - 1) / 2 + 1;
+    w = (w - 1) / 2 + 1;
+    const Layer& stem = net.layers[0];
+    gemm(net.cols, stem.weights, net.act[0], h * w, stem.cout, stem.k, stem.q);
+    int32_t cur = 0;
+    for (int32_t li = 1; li < net.n - 1; ++li) {
+        const Layer& l = net.layers[li];
+        if (l.depthwise) {
+            depthwise3x3(net.act[cur], h, w, l.cin, l.stride, kActZp, l.weights, net.act[cur ^ 1], l.q);
+            h = (h - 1) / l.stride + 1;
+            w = (w - 1) / l.stride + 1;
+        } else {
+            gemm(net.act[cur], l.weights, net.act[cur ^ 1], h * w, l.cout, l.k, l.q);
+        }
+        cur ^= 1;
+    }
+    // Global average pool keeps the activation quantization (rounded integer mean).
+    const Layer& fc = net.layers[net.n - 1];
+    alignas(16) int8_t pooled[128];
+    const int32_t hw = h * w;
+    for (int32_t c = 0; c < fc.cin; ++c) {
+        int32_t sum = 0;
+        for (int32_t p = 0; p < hw; ++p) sum += net.act[cur][p * fc.cin + c];
+        pooled[c] = (int8_t)(sum >= 0 ? (sum + hw / 2) / hw : -((-sum + hw / 2) / hw));
+    }
+    gemm(pooled, fc.weights, logits, 1, fc.cout, fc.k, fc.q);
+}
+
+}  // namespace
+
+int main() {
+    // ---- standalone GEMM ----
+    const int32_t d = (int32_t)kGemmDim;
+    int8_t* a = (int8_t*)malloc((size_t)d * d);
+    int8_t* wt = (int8_t*)malloc((size_t)d * d);
+    int8_t* out = (int8_t*)malloc((size_t)d * d);
+    int8_t* ref = (int8_t*)malloc((size_t)d * d);
+    Requant gq{(int32_t*)malloc(sizeof(int32_t) * d), (int32_t*)malloc(sizeof(int32_t) * d),
+               (int32_t*)malloc(sizeof(int32_t) * d), 3, -128, 127};
+    Net net;
+    if (!a || !wt || !out || !ref || !gq.bias || !gq.mult || !gq.shift || !build_net(net)) {
+        printf("alloc failed\n");
+        return 1;
+    }
+    uint32_t rng = 0x51u;
+    for (int32_t i = 0; i < d * d; ++i) {
+        a[i] = (int8_t)((int32_t)(u2bench_xorshift32(&rng) & 255u) - 128);
+        wt[i] = (int8_t)((int32_t)(u2bench_xorshift32(&rng) % 255u) - 127);
+    }
+    for (int32_t j = 0; j < d; ++j) {
+        gq.bias[j] = (int32_t)(u2bench_xorshift32(&rng) % 20001u) - 10000;
+        quantize_multiplier(32.0 / (16.0 * 73.0 * 74.0) * (1.0 + (double)(j % 7) / 8.0), &gq.mult[j], &gq.shift[j]);
+    }
+    uint32_t errors = 0;
+    gemm_i8(a, wt, out, d, d, d, gq);
+    gemm_i8_ref(a, wt, ref, d, d, d, gq);
+    errors += memcmp(out, ref, (size_t)d * d) != 0;
+
+    uint64_t t0 = u2bench_now_ns();
+    for (uint32_t rep = 0; rep < kGemmReps; ++rep) {
+        a[rep] ^= 1;  // keep reps distinct
+        gemm_i8(a, wt, out, d, d, d, gq);
+    }
+    uint64_t t1 = u2bench_now_ns();
+    const uint64_t gemm_ns = t1 - t0;
+    uint64_t sum = 0;
+    for (int32_t i = 0; i < d * d; ++i) sum += (uint8_t)out[i];
+
+    // ---- CNN inference ----
+    alignas(16) int8_t logits[kClasses];
+    alignas(16) int8_t logits_ref[kClasses];
+    infer(net, gemm_i8_ref, logits_ref);
+    t0 = u2bench_now_ns();
+    for (uint32_t it = 0; it < kInferences; ++it) {
+        infer(net, gemm_i8, logits);
+    }
+    t1 = u2bench_now_ns();
+    const uint64_t infer_ns = t1 - t0;
+    errors += memcmp(logits, logits_ref, kClasses) != 0;
+    uint64_t result = 0;
+    int32_t top = 0;
+    for (int32_t c = 0; c < kClasses; ++c) {
+        result = result * 131u + (uint8_t)logits[c];
+        if (logits[c] > logits[top]) top = c;
+    }
+    u2bench_sink_u64(sum ^ (uint64_t)top);
+
+    u2bench_print_time_ns(gemm_ns + infer_ns);
+    u2bench_print_metric("gemm_gmac_s", (double)kGemmDim * kGemmDim * kGemmDim * kGemmReps / (double)gemm_ns);
+    u2bench_print_metric("inferences_per_s", (double)kInferences / ((double)infer_ns / 1e9));
+    u2bench_print_metric("result", (double)(result % (1ull << 52)));
+    u2bench_print_metric("verify_errors", (double)errors);
+    free(a);
+    free(wt);
+    free(out);
+    free(ref);
+    free(gq.bias);
+    free(gq.mult);
+    free(gq.shift);
+    free_net(net);
+    return errors == 0 ? 0 : 1;
+}
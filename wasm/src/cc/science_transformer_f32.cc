@@ -0,0 +1,391 @@
+#include "bench_common.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__wasm_relaxed_simd__)
+#include <wasm_simd128.h>
+#endif
+
+// One pre-LN transformer decoder layer (d_model 256, 4 heads x 64, FFN 1024, synthetic weights), f32:
+//   prefill: U2BENCH_TF_SEQ prompt tokens as a batch (blocked matmuls, causal attention over the prompt),
+//   decode:  32 further tokens one at a time (matrix-vector products, attention over the growing KV cache),
+//            each step feeding the previous output back in.
+// Sub-kernels: cache-blocked i-k-j matmul (matvec when M = 1), attention scores (q.k), softmax with a
+// polynomial exp2 approximation, attention-weighted V sum, layernorm, tanh-GELU (same exp), KV-cache append.
+// Rounds scale as 512 / SEQ so every sweep point prefills the same number of tokens.
+// Checks: fast exp vs expf, and batched prefill vs token-by-token decode over the same 8-token prompt.
+// Metrics: <kernel>_ms per sub-kernel (Time is their sum), prefill_tok_s, decode_tok_s, result (checksum).
+#ifndef U2BENCH_TF_SEQ
+#define U2BENCH_TF_SEQ 256
+#endif
+
+namespace {
+
+constexpr int32_t kSeq = U2BENCH_TF_SEQ;
+constexpr int32_t kDecode = 32;
+constexpr int32_t kModel = 256;
+constexpr int32_t kHeads = 4;
+constexpr int32_t kHeadDim = kModel / kHeads;
+constexpr int32_t kFfn = 1024;
+constexpr int32_t kMaxPos = kSeq + kDecode;
+constexpr int32_t kRounds = kSeq >= 512 ? 1 : 512 / kSeq;
+constexpr int32_t kCheckTokens = 8;
+
+// Matmul blocking: a 64 x 256 B tile (64 KiB) stays cache-resident while 16 A rows stream over it.
+constexpr int32_t kBm = 16;
+constexpr int32_t kBk = 64;
+constexpr int32_t kBn = 256;
+
+static_assert(kSeq >= kCheckTokens, "U2BENCH_TF_SEQ too small");
+
+enum Kernel {
+    kMatmul,
+    kMatvec,
+    kScores,
+    kSoftmax,
+    kAttnV,
+    kLayerNorm,
+    kGelu,
+    kKvAppend,
+    kNumKernels,
+};
+
+const char* const kKernelNames[kNumKernels] = {
+    "matmul_ms", "matvec_ms", "attn_scores_ms", "softmax_ms", "attn_v_ms", "layernorm_ms", "gelu_ms", "kv_append_ms",
+};
+
+uint64_t g_kernel_ns[kNumKernels];
+
+struct Timer {
+    Kernel k;
+    uint64_t t0;
+    explicit Timer(Kernel kernel) : k(kernel), t0(u2bench_now_ns()) {}
+    ~Timer() { g_kernel_ns[k] += u2bench_now_ns() - t0; }
+};
+
+// e^x as 2^n * p(f): n = floor(x log2 e), p a degree-6 polynomial for 2^f on [0, 1).
+inline float fast_exp(float x) {
+    x = x < -87.0f ? -87.0f : (x > 88.0f ? 88.0f : x);
+    const float t = x * 1.44269504f;
+    float fl = (float)(int32_t)t;
+    fl = fl > t ? fl - 1.0f : fl;
+    const float f = t - fl;
+    const float p =
+        1.0f +
+        f * (0.693147181f +
+             f * (0.240226507f + f * (0.0555041087f + f * (0.00961812911f + f * (0.00133335581f + f * 0.000154035304f)))));
+    uint32_t bits;
+    memcpy(&bits, &p, 4);
+    bits += (uint32_t)(int32_t)fl << 23;
+    float r;
+    memcpy(&r, &bits, 4);
+    return r;
+}
+
+// ---- kernels -------------------------------------------------------------------------------------------------
+
+// y[0..n) += a * x[0..n). The relaxed-SIMD tier uses f32x4.relaxed_madd explicitly (fused or not, engine's choice).
+inline void axpy(float* y, const float* x, float a, int32_t n) {
+    int32_t j = 0;
+#if defined(__wasm_relaxed_simd__)
+    const v128_t va = wasm_f32x4_splat(a);
+    for (; j + 4 <= n; j += 4) {
+        wasm_v128_store(y + j, wasm_f32x4_relaxed_madd(va, wasm_v128_load(x + j), wasm_v128_load(y + j)));
+    }
+#endif
+    for (; j < n; ++j) y[j] += a * x[j];
+}
+
+// c (M x N) = a (M x K) * b (K x N) + bias.
+void matmul(const float* a, const float* b, const float* bias, float* c, int32_t m, int32_t k, int32_t n) {
+    Timer t(m == 1 ? kMatvec : kMatmul);
+    for (int32_t i = 0; i < m; ++i) memcpy(c + (size_t)i * n, bias, sizeof(float) * (size_t)n);
+    for (int32_t i0 = 0; i0 < m; i0 += kBm) {
+        const int32_t i1 = i0 + kBm < m ? i0 + kBm : m;
+        for (int32_t k0 = 0; k0 < k; k0 += kBk) {
+            const int32_t k1 = k0 + kBk < k ? k0 + kBk : k;
+            for (int32_t j0 = 0; j0 < n; j0 += kBn) {
+                const int32_t j1 = j0 + kBn < n ? j0 + kBn : n;
+                for (int32_t i = i0; i < i1; ++i) {
+                    float* cr = c + (size_t)i * n;
+                    for (int32_t kk = k0; kk < k1; ++kk) {
+                        axpy(cr + j0, b + (size_t)kk * n + j0, a[(size_t)i * k + kk], j1 - j0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void layernorm(const float* x, const float* g, const float* b, float* y, int32_t m) {
+    Timer t(kLayerNorm);
+    for (int32_t i = 0; i < m; ++i) {
+        const float* xr = x + (size_t)i * kModel;
+        float* yr = y + (size_t)i * kModel;
+        float mean = 0.0f;
+        for (int32_t j = 0; j < kModel; ++j) mean += xr[j];
+        mean *= 1.0f / kModel;
+        float var = 0.0f;
+        for (int32_t j = 0; j < kModel; ++j) {
+            const float d = xr[j] - mean;
+            var += d * d;
+        }
+        const float inv = 1.0f / sqrtf(var * (1.0f / kModel) + 1e-5f);
+        for (int32_t j = 0; j < kModel; ++j) yr[j] = (xr[j] - mean) * inv * g[j] + b[j];
+    }
+}
+
+// 0.5 x (1 + tanh(sqrt(2/pi) (x + 0.044715 x^3))), tanh(u) = 1 - 2 / (e^(2u) + 1).
+void gelu(float* x, size_t n) {
+    Timer t(kGelu);
+    for (size_t i = 0; i < n; ++i) {
+        const float v = x[i];
+        const float u = 0.797884561f * (v + 0.044715f * v * v * v);
+        const float th = 1.0f - 2.0f / (fast_exp(2.0f * u) + 1.0f);
+        x[i] = 0.5f * v * (1.0f + th);
+    }
+}
+
+struct KvCache {
+    float* k;  // [head][pos][head_dim]
+    float* v;
+    int32_t len = 0;
+};
+
+// Copies the K/V columns of m fresh qkv rows into the cache at positions len..len+m-1.
+void kv_append(KvCache& kv, const float* qkv, int32_t m) {
+    Timer t(kKvAppend);
+    for (int32_t i = 0; i < m; ++i) {
+        const float* row = qkv + (size_t)i * 3 * kModel;
+        const size_t pos = (size_t)(kv.len + i);
+        for (int32_t h = 0; h < kHeads; ++h) {
+            memcpy(kv.k + ((size_t)h * kMaxPos + pos) * kHeadDim, row + kModel + h * kHeadDim, sizeof(float) * kHeadDim);
+            memcpy(kv.v + ((size_t)h * kMaxPos + pos) * kHeadDim, row + 2 * kModel + h * kHeadDim,
+                   sizeof(float) * kHeadDim);
+        }
+    }
+    kv.len += m;
+}
+
+// Causal attention for m query rows at positions p0..p0+m-1 (already appended). scores is m x kMaxPos scratch.
+void attention(const KvCache& kv, const float* qkv, int32_t m, int32_t p0, float* scores, float* out) {
+    const float scale = 1.0f / sqrtf((float)kHeadDim);
+    for (int32_t h = 0; h < kHeads; ++h) {
+        const float* kh = kv.k + (size_t)h * kMaxPos * kHeadDim;
+        const float* vh = kv.v + (size_t)h * kMaxPos * kHeadDim;
+        {
+            Timer t(kScores);
+            for (int32_t i = 0; i < m; ++i) {
+                const float* q = qkv + (size_t)i * 3 * kModel + h * kHeadDim;
+                float* s = scores + (size_t)i * kMaxPos;
+                const int32_t len = p0 + i + 1;
+                for (int32_t p = 0; p < len; ++p) {
+                    const float* kr = kh + (size_t)p * kHeadDim;
+                    float acc = 0.0f;
+                    for (int32_t d = 0; d < kHeadDim; ++d) acc += q[d] * kr[d];
+                    s[p] = acc * scale;
+                }
+            }
+        }
+        {
+            Timer t(kSoftmax);
+            for (int32_t i = 0; i < m; ++i) {
+                float* s = scores + (size_t)i * kMaxPos;
+                const int32_t len = p0 + i + 1;
+                float mx = s[0];
+                for (int32_t p = 1; p < len; ++p) mx = s[p] > mx ? s[p] : mx;
+                float sum = 0.0f;
+                for (int32_t p = 0; p < len; ++p) {
+                    s[p] = fast_exp(s[p] - mx);
+                    sum += s[p];
+                }
+                const float inv = 1.0f / sum;
+                for (int32_t p = 0; p < len; ++p) s[p] *= inv;
+            }
+        }
+        {
+            Timer t(kAttnV);
+            for (int32_t i = 0; i < m; ++i) {
+                const float* s = scores + (size_t)i * kMaxPos;
+                float* o = out + (size_t)i * kModel + h * kHeadDim;
+                const int32_t len = p0 + i + 1;
+                for (int32_t d = 0; d < kHeadDim; ++d) o[d] = 0.0f;
+                for (int32_t p = 0; p < len; ++p) axpy(o, vh + (size_t)p * kHeadDim, s[p], kHeadDim);
+            }
+        }
+    }
+}
+
+// ---- layer ---------------------------------------------------------------------------------------------------
+
+struct Layer {
+    float ln1_g[kModel], ln1_b[kModel], ln2_g[kModel], ln2_b[kModel];
+    float* w_qkv;  // kModel x 3 kModel
+    float* b_qkv;
+    float* w_o;  // kModel x kModel
+    float* b_o;
+    float* w_up;  // kModel x kFfn
+    float* b_up;
+    float* w_down;  // kFfn x kModel
+    float* b_down;
+};
+
+struct Scratch {
+    float* norm;  // m x kModel
+    float* qkv;  // m x 3 kModel
+    float* attn;  // m x kModel
+    float* proj;  // m x kModel
+    float* hidden;  // m x kFfn
+    float* scores;  // m x kMaxPos
+};
+
+float* alloc_uniform(size_t n, float bound, uint32_t* rng) {
+    float* p = (float*)malloc(sizeof(float) * n);
+    if (!p) return nullptr;
+    for (size_t i = 0; i < n; ++i) {
+        p[i] = ((float)(u2bench_xorshift32(rng) >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * bound;
+    }
+    return p;
+}
+
+bool init_layer(Layer& l, uint32_t* rng) {
+    for (int32_t j = 0; j < kModel; ++j) {
+        l.ln1_g[j] = 1.0f + 0.1f * ((float)(u2bench_xorshift32(rng) % 1000u) / 1000.0f - 0.5f);
+        l.ln2_g[j] = 1.0f + 0.1f * ((float)(u2bench_xorshift32(rng) % 1000u) / 1000.0f - 0.5f);
+        l.ln1_b[j] = 0.02f * ((float)(u2bench_xorshift32(rng) % 1000u) / 1000.0f - 0.5f);
+        l.ln2_b[j] = 0.02f * ((float)(u2bench_xorshift32(rng) % 1000u) / 1000.0f - 0.5f);
+    }
+    // Uniform with variance 1 / fan_in, so activations keep unit scale through each sub-layer.
+    const float in_model = sqrtf(3.0f / kModel);
+    const float in_ffn = sqrtf(3.0f / kFfn);
+    l.w_qkv = alloc_uniform((size_t)kModel * 3 * kModel, in_model, rng);
+    l.b_qkv = alloc_uniform(3 * kModel, 0.02f, rng);
+    l.w_o = alloc_uniform((size_t)kModel * kModel, in_model, rng);
+    l.b_o = alloc_uniform(kModel, 0.02f, rng);
+    l.w_up = alloc_uniform((size_t)kModel * kFfn, in_model, rng);
+    l.b_up = alloc_uniform(kFfn, 0.02f, rng);
+    l.w_down = alloc_uniform((size_t)kFfn * kModel, in_ffn, rng);
+    l.b_down = alloc_uniform(kModel, 0.02f, rng);
+    return l.w_qkv && l.b_qkv && l.w_o && l.b_o && l.w_up && l.b_up && l.w_down && l.b_down;
+}
+
+void free_layer(Layer& l) {
+    free(l.w_qkv);
+    free(l.b_qkv);
+    free(l.w_o);
+    free(l.b_o);
+    free(l.w_up);
+    free(l.b_up);
+    free(l.w_down);
+    free(l.b_down);
+}
+
+// x (m x kModel) -> x + attn(ln1(x)), then + ffn(ln2(.)), in place. Rows sit at positions kv.len.. on entry.
+void forward(const Layer& l, KvCache& kv, Scratch& s, float* x, int32_t m) {
+    const int32_t p0 = kv.len;
+    layernorm(x, l.ln1_g, l.ln1_b, s.norm, m);
+    matmul(s.norm, l.w_qkv, l.b_qkv, s.qkv, m, kModel, 3 * kModel);
+    kv_append(kv, s.qkv, m);
+    attention(kv, s.qkv, m, p0, s.scores, s.attn);
+    matmul(s.attn, l.w_o, l.b_o, s.proj, m, kModel, kModel);
+    for (size_t i = 0; i < (size_t)m * kModel; ++i) x[i] += s.proj[i];
+    layernorm(x, l.ln2_g, l.ln2_b, s.norm, m);
+    matmul(s.norm, l.w_up, l.b_up, s.hidden, m, kModel, kFfn);
+    gelu(s.hidden, (size_t)m * kFfn);
+    matmul(s.hidden, l.w_down, l.b_down, s.proj, m, kFfn, kModel);
+    for (size_t i = 0; i < (size_t)m * kModel; ++i) x[i] += s.proj[i];
+}
+
+}  // namespace
+
+int main() {
+    uint32_t rng = 0x7f4a7c15u;
+    Layer layer;
+    KvCache kv;
+    Scratch s;
+    kv.k = (float*)malloc(sizeof(float) * kHeads * kMaxPos * kHeadDim);
+    kv.v = (float*)malloc(sizeof(float) * kHeads * kMaxPos * kHeadDim);
+    s.norm = (float*)malloc(sizeof(float) * kSeq * kModel);
+    s.qkv = (float*)malloc(sizeof(float) * kSeq * 3 * kModel);
+    s.attn = (float*)malloc(sizeof(float) * kSeq * kModel);
+    s.proj = (float*)malloc(sizeof(float) * kSeq * kModel);
+    s.hidden = (float*)malloc(sizeof(float) * kSeq * kFfn);
+    s.scores = (float*)malloc(sizeof(float) * (size_t)kSeq * kMaxPos);
+    float* prompt = alloc_uniform((size_t)kSeq * kModel, 1.7f, &rng);
+    float* x = (float*)malloc(sizeof(float) * kSeq * kModel);
+    float* check = (float*)malloc(sizeof(float) * kCheckTokens * kModel);
+    if (!init_layer(layer, &rng) || !kv.k || !kv.v || !s.norm || !s.qkv || !s.attn || !s.proj || !s.hidden ||
+        !s.scores || !prompt || !x || !check) {
+        printf("alloc failed\n");
+        return 1;
+    }
+
+    uint32_t errors = 0;
+    for (float v = -20.0f; v <= 20.0f; v += 0.01f) {
+        const float want = expf(v);
+        errors += fabsf(fast_exp(v) - want) > 1e-5f * want;
+    }
+    // Batched prefill and token-by-token decode must agree on the same prompt.
+    memcpy(x, prompt, sizeof(float) * kCheckTokens * kModel);
+    kv.len = 0;
+    forward(layer, kv, s, x, kCheckTokens);
+    memcpy(check, x, sizeof(float) * kCheckTokens * kModel);
+    kv.len = 0;
+    for (int32_t i = 0; i < kCheckTokens; ++i) {
+        memcpy(x, prompt + (size_t)i * kModel, sizeof(float) * kModel);
+        forward(layer, kv, s, x, 1);
+        for (int32_t j = 0; j < kModel; ++j) {
+            const float want = check[(size_t)i * kModel + j];
+            errors += !(fabsf(x[j] - want) <= 1e-4f * (1.0f + fabsf(want)));
+        }
+    }
+    memset(g_kernel_ns, 0, sizeof(g_kernel_ns));
+
+    uint64_t prefill_ns = 0;
+    uint64_t decode_ns = 0;
+    double result = 0.0;
+    for (int32_t round = 0; round < kRounds; ++round) {
+        kv.len = 0;
+        memcpy(x, prompt, sizeof(float) * kSeq * kModel);
+        x[round] += 0.001f;  // keep rounds distinct
+        uint64_t t0 = u2bench_now_ns();
+        forward(layer, kv, s, x, kSeq);
+        uint64_t t1 = u2bench_now_ns();
+        prefill_ns += t1 - t0;
+        // Feed the last prompt position's output back as the next token.
+        float* tok = x + (size_t)(kSeq - 1) * kModel;
+        t0 = u2bench_now_ns();
+        for (int32_t step = 0; step < kDecode; ++step) forward(layer, kv, s, tok, 1);
+        t1 = u2bench_now_ns();
+        decode_ns += t1 - t0;
+        for (int32_t j = 0; j < kModel; ++j) result += (double)tok[j] * (double)(j + 1);
+    }
+    if (!(result == result)) ++errors;
+
+    uint64_t total_ns = 0;
+    for (int32_t k = 0; k < kNumKernels; ++k) total_ns += g_kernel_ns[k];
+    u2bench_print_time_ns(total_ns);
+    for (int32_t k = 0; k < kNumKernels; ++k) u2bench_print_metric(kKernelNames[k], (double)g_kernel_ns[k] / 1e6);
+    u2bench_print_metric("prefill_tok_s", (double)kSeq * kRounds / ((double)prefill_ns / 1e9));
+    u2bench_print_metric("decode_tok_s", (double)kDecode * kRounds / ((double)decode_ns / 1e9));
+    u2bench_print_metric("result", result);
+    u2bench_print_metric("verify_errors", (double)errors);
+    u2bench_sink_f64(result);
+
+    free_layer(layer);
+    free(kv.k);
+    free(kv.v);
+    free(s.norm);
+    free(s.qkv);
+    free(s.attn);
+    free(s.proj);
+    free(s.hidden);
+    free(s.scores);
+    free(prompt);
+    free(x);
+    free(check);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#include "bench_common.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// stdout throughput: kTotal bytes of 64-byte text lines, written kChunk bytes at a time.
+//   U2BENCH_STDOUT_MODE 0: write(1, ...) per chunk (no stdio buffering)
+//   U2BENCH_STDOUT_MODE 1: fwrite through a fully buffered 64 KiB stdio buffer
+//   U2BENCH_STDOUT_MODE 2: fwrite through a line-buffered stdout (flush at every '\n')
+// stdout carries only the payload; Time/Metric lines go to stderr, so the harness can send stdout to a file or
+// /dev/null (--stdout file|null) without losing them.
+#ifndef U2BENCH_STDOUT_MODE
+#define U2BENCH_STDOUT_MODE 0
+#endif
+#ifndef U2BENCH_STDOUT_CHUNK
+#define U2BENCH_STDOUT_CHUNK 64
+#endif
+
+#if U2BENCH_STDOUT_MODE == 0
+static bool write_all(int fd, const char* buf, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        const ssize_t rc = write(fd, buf + off, len - off);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        off += (size_t)rc;
+    }
+    return true;
+}
+#endif
+
+int main() {
+    constexpr size_t kTotal = 64u * 1024u * 1024u;
+    constexpr size_t kChunk = U2BENCH_STDOUT_CHUNK;
+    constexpr size_t kLine = 64;
+    static_assert(kChunk % kLine == 0 && kTotal % kChunk == 0, "chunk must be whole lines and divide the total");
+
+    static char chunk[kChunk];
+    for (size_t i = 0; i < kChunk; ++i) {
+        chunk[i] = (i % kLine) == kLine - 1 ? '\n' : (char)('a' + (i * 7 + i / kLine) % 26);
+    }
+
+#if U2BENCH_STDOUT_MODE == 1
+    static char stdio_buf[64 * 1024];
+    setvbuf(stdout, stdio_buf, _IOFBF, sizeof(stdio_buf));
+#elif U2BENCH_STDOUT_MODE == 2
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+#endif
+
+    size_t written = 0;
+    uint64_t writes = 0;
+    const uint64_t t0 = u2bench_now_ns();
+    while (written < kTotal) {
+#if U2BENCH_STDOUT_MODE == 0
+        if (!write_all(1, chunk, kChunk)) break;
+#else
+        if (fwrite(chunk, 1, kChunk, stdout) != kChunk) break;
+#endif
+        written += kChunk;
+        ++writes;
+    }
+#if U2BENCH_STDOUT_MODE != 0
+    fflush(stdout);
+#endif
+    const uint64_t t1 = u2bench_now_ns();
+
+    const double ms = (double)(t1 - t0) / 1000000.0;
+    fprintf(stderr, "Time: %.3f ms\n", ms);
+    fprintf(stderr, "Metric: bytes %.17g\n", (double)written);
+    fprintf(stderr, "Metric: chunk_bytes %.17g\n", (double)kChunk);
+    fprintf(stderr, "Metric: writes %.17g\n", (double)writes);
+    fprintf(stderr, "Metric: mib_per_s %.17g\n", ms > 0.0 ? (double)written / (1024.0 * 1024.0) / (ms / 1000.0) : 0.0);
+    return written == kTotal ? 0 : 1;
+}
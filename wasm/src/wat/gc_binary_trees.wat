@@ -0,0 +1,275 @@
+(module
+  (import "wasi_snapshot_preview1" "fd_write"
+    (func $fd_write (param i32 i32 i32 i32) (result i32)))
+  (import "wasi_snapshot_preview1" "clock_time_get"
+    (func $clock_time_get (param i32 i64 i32) (result i32)))
+  (import "wasi_snapshot_preview1" "proc_exit"
+    (func $proc_exit (param i32)))
+
+  (memory (export "memory") 2)
+
+  (type $tree (struct (field $left (ref null $tree)) (field $right (ref null $tree))))
+
+  ;; Metric names for $report_gc.
+  (data (i32.const 512) "allocs")
+  (data (i32.const 528) "batches")
+  (data (i32.const 544) "batch_p50_us")
+  (data (i32.const 560) "batch_max_us")
+
+  (func $bottom_up (param $depth i32) (result (ref null $tree))
+    (if (result (ref null $tree)) (i32.le_s (local.get $depth) (i32.const 0))
+      (then (struct.new $tree (ref.null $tree) (ref.null $tree)))
+      (else
+        (local.set $depth (i32.sub (local.get $depth) (i32.const 1)))
+        (struct.new $tree (call $bottom_up (local.get $depth)) (call $bottom_up (local.get $depth))))))
+
+  (func $check (param $t (ref null $tree)) (result i32)
+    (if (result i32) (ref.is_null (struct.get $tree $left (local.get $t)))
+      (then (i32.const 1))
+      (else
+        (i32.add
+          (i32.const 1)
+          (i32.add
+            (call $check (struct.get $tree $left (local.get $t)))
+            (call $check (struct.get $tree $right (local.get $t))))))))
+
+  (func $xorshift32 (param $x i32) (result i32)
+    (local.set $x (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 13))))
+    (local.set $x (i32.xor (local.get $x) (i32.shr_u (local.get $x) (i32.const 17))))
+    (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 5))))
+
+  ;; Stores the ns elapsed since $since into batch slot $b (at 4096) and returns the new batch start.
+  (func $batch_mark (param $b i32) (param $since i64) (result i64)
+    (local $now i64)
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 24))
+    drop
+    (local.set $now (i64.load (i32.const 24)))
+    (i64.store
+      (i32.add (i32.const 4096) (i32.shl (local.get $b) (i32.const 3)))
+      (i64.sub (local.get $now) (local.get $since)))
+    (local.get $now))
+
+  (func $sort_u64 (param $base i32) (param $n i32)
+    (local $i i32)
+    (local $j i32)
+    (local $pj i32)
+    (local $v i64)
+    (local.set $i (i32.const 1))
+    (block $done
+      (loop $outer
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (local.set $v (i64.load (i32.add (local.get $base) (i32.shl (local.get $i) (i32.const 3)))))
+        (local.set $j (local.get $i))
+        (block $placed
+          (loop $inner
+            (br_if $placed (i32.eqz (local.get $j)))
+            (local.set $pj (i32.add (local.get $base) (i32.shl (local.get $j) (i32.const 3))))
+            (br_if $placed (i64.le_u (i64.load (i32.sub (local.get $pj) (i32.const 8))) (local.get $v)))
+            (i64.store (local.get $pj) (i64.load (i32.sub (local.get $pj) (i32.const 8))))
+            (local.set $j (i32.sub (local.get $j) (i32.const 1)))
+            (br $inner)))
+        (i64.store (i32.add (local.get $base) (i32.shl (local.get $j) (i32.const 3))) (local.get $v))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $outer))))
+
+  ;; Writes "Metric: <name> <v>\n"; the harness picks these up next to "Time:".
+  (func $write_metric (param $name i32) (param $name_len i32) (param $v i64)
+    (local $p i32)
+    (local $i i32)
+    (local $nlen i32)
+    (local.set $p (i32.const 768))
+    ;; "Metric: " as a little-endian i64
+    (i64.store (local.get $p) (i64.const 0x203a63697274654d))
+    (local.set $i (i32.const 0))
+    (block $copied
+      (loop $copy
+        (br_if $copied (i32.ge_u (local.get $i) (local.get $name_len)))
+        (i32.store8
+          (i32.add (local.get $p) (i32.add (i32.const 8) (local.get $i)))
+          (i32.load8_u (i32.add (local.get $name) (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $copy)))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 8) (local.get $name_len))) (i32.const 32))
+    (local.set $nlen
+      (call $write_u64_dec (local.get $v) (i32.add (local.get $p) (i32.add (i32.const 9) (local.get $name_len)))))
+    (i32.store8
+      (i32.add (local.get $p) (i32.add (i32.add (i32.const 9) (local.get $name_len)) (local.get $nlen)))
+      (i32.const 10))
+    (call $write (local.get $p) (i32.add (i32.add (i32.const 10) (local.get $name_len)) (local.get $nlen))))
+
+  ;; Allocation count plus the median/worst batch time. A collector that stops the world shows
+  ;; up as batch_max_us far above batch_p50_us even when the total time looks fine.
+  (func $report_gc (param $allocs i64) (param $n i32)
+    (call $sort_u64 (i32.const 4096) (local.get $n))
+    (call $write_metric (i32.const 512) (i32.const 6) (local.get $allocs))
+    (call $write_metric (i32.const 528) (i32.const 7) (i64.extend_i32_u (local.get $n)))
+    (call $write_metric (i32.const 544) (i32.const 12)
+      (i64.div_u
+        (i64.load (i32.add (i32.const 4096) (i32.shl (i32.shr_u (local.get $n) (i32.const 1)) (i32.const 3))))
+        (i64.const 1000)))
+    (call $write_metric (i32.const 560) (i32.const 12)
+      (i64.div_u
+        (i64.load (i32.add (i32.const 4096) (i32.shl (i32.sub (local.get $n) (i32.const 1)) (i32.const 3))))
+        (i64.const 1000))))
+
+  (func $write (param $ptr i32) (param $len i32)
+    (i32.store (i32.const 0) (local.get $ptr))
+    (i32.store (i32.const 4) (local.get $len))
+    (call $fd_write (i32.const 1) (i32.const 0) (i32.const 1) (i32.const 8))
+    drop)
+
+  (func $write_u64_dec (param $n i64) (param $out i32) (result i32)
+    (local $scratch i32)
+    (local $p i32)
+    (local $len i32)
+    (local $i i32)
+
+    (if (i64.eq (local.get $n) (i64.const 0))
+      (then
+        (i32.store8 (local.get $out) (i32.const 48))
+        (return (i32.const 1))))
+
+    (local.set $scratch (i32.add (local.get $out) (i32.const 32)))
+    (local.set $p (local.get $scratch))
+
+    (block $done
+      (loop $loop
+        (br_if $done (i64.eq (local.get $n) (i64.const 0)))
+        (local.set $p (i32.sub (local.get $p) (i32.const 1)))
+        (i32.store8
+          (local.get $p)
+          (i32.add
+            (i32.wrap_i64 (i64.rem_u (local.get $n) (i64.const 10)))
+            (i32.const 48)))
+        (local.set $n (i64.div_u (local.get $n) (i64.const 10)))
+        (br $loop)))
+
+    (local.set $len (i32.sub (local.get $scratch) (local.get $p)))
+    (local.set $i (i32.const 0))
+    (block $copy_done
+      (loop $copy
+        (br_if $copy_done (i32.ge_u (local.get $i) (local.get $len)))
+        (i32.store8
+          (i32.add (local.get $out) (local.get $i))
+          (i32.load8_u (i32.add (local.get $p) (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $copy)))
+    (local.get $len))
+
+  (func $write_u32_pad3 (param $v i32) (param $out i32)
+    (i32.store8
+      (local.get $out)
+      (i32.add (i32.div_u (local.get $v) (i32.const 100)) (i32.const 48)))
+    (i32.store8
+      (i32.add (local.get $out) (i32.const 1))
+      (i32.add
+        (i32.rem_u (i32.div_u (local.get $v) (i32.const 10)) (i32.const 10))
+        (i32.const 48)))
+    (i32.store8
+      (i32.add (local.get $out) (i32.const 2))
+      (i32.add (i32.rem_u (local.get $v) (i32.const 10)) (i32.const 48))))
+
+  (func (export "_start")
+    (local $depth i32)
+    (local $iters i32)
+    (local $per_batch i32)
+    (local $i i32)
+    (local $k i32)
+    (local $acc i32)
+    (local $long_lived (ref null $tree))
+    (local $allocs i64)
+    (local $batches i32)
+    (local $tb i64)
+    (local $t0 i64)
+    (local $t1 i64)
+    (local $diff i64)
+    (local $ms_int i64)
+    (local $ms_frac i32)
+    (local $p i32)
+    (local $nlen i32)
+
+    ;; start timing
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 16))
+    drop
+    (local.set $t0 (i64.load (i32.const 16)))
+    (local.set $tb (local.get $t0))
+
+    ;; Classic binary-trees, max depth 16: a stretch tree, one long-lived tree, then
+    ;; 2^(20-d) short-lived trees of depth d for d = 4, 6, .., 16 (~2^21 nodes per depth).
+    (local.set $acc (call $check (call $bottom_up (i32.const 17))))
+    (local.set $allocs (i64.const 262143))
+    (local.set $long_lived (call $bottom_up (i32.const 16)))
+    (local.set $allocs (i64.add (local.get $allocs) (i64.const 131071)))
+    ;; restart the batch clock; slot 0 is overwritten by the first real batch
+    (local.set $tb (call $batch_mark (i32.const 0) (local.get $tb)))
+    (local.set $batches (i32.const 0))
+
+    ;; each depth is split into 16 equally sized batches
+    (local.set $depth (i32.const 4))
+    (block $depths_done
+      (loop $depths
+        (br_if $depths_done (i32.gt_s (local.get $depth) (i32.const 16)))
+        (local.set $iters (i32.shl (i32.const 1) (i32.sub (i32.const 20) (local.get $depth))))
+        (local.set $per_batch (i32.shr_u (local.get $iters) (i32.const 4)))
+        (local.set $k (i32.const 0))
+        (block $batches_done
+          (loop $batch
+            (br_if $batches_done (i32.ge_u (local.get $k) (i32.const 16)))
+            (local.set $i (i32.const 0))
+            (block $done
+              (loop $loop
+                (br_if $done (i32.ge_u (local.get $i) (local.get $per_batch)))
+                (local.set $acc (i32.add (local.get $acc) (call $check (call $bottom_up (local.get $depth)))))
+                (local.set $i (i32.add (local.get $i) (i32.const 1)))
+                (br $loop)))
+            (local.set $allocs
+              (i64.add
+                (local.get $allocs)
+                (i64.mul
+                  (i64.extend_i32_u (local.get $per_batch))
+                  (i64.extend_i32_u
+                    (i32.sub (i32.shl (i32.const 2) (local.get $depth)) (i32.const 1))))))
+            (local.set $tb (call $batch_mark (local.get $batches) (local.get $tb)))
+            (local.set $batches (i32.add (local.get $batches) (i32.const 1)))
+            (local.set $k (i32.add (local.get $k) (i32.const 1)))
+            (br $batch)))
+        (local.set $depth (i32.add (local.get $depth) (i32.const 2)))
+        (br $depths)))
+
+    (local.set $acc (i32.add (local.get $acc) (call $check (local.get $long_lived))))
+    (i32.store (i32.const 32) (local.get $acc))
+
+    ;; end timing
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 24))
+    drop
+    (local.set $t1 (i64.load (i32.const 24)))
+
+    (local.set $diff (i64.sub (local.get $t1) (local.get $t0)))
+    (local.set $ms_int (i64.div_u (local.get $diff) (i64.const 1000000)))
+    (local.set $ms_frac
+      (i32.wrap_i64
+        (i64.div_u
+          (i64.rem_u (local.get $diff) (i64.const 1000000))
+          (i64.const 1000))))
+
+    (local.set $p (i32.const 256))
+    (i32.store8 (i32.add (local.get $p) (i32.const 0)) (i32.const 84))
+    (i32.store8 (i32.add (local.get $p) (i32.const 1)) (i32.const 105))
+    (i32.store8 (i32.add (local.get $p) (i32.const 2)) (i32.const 109))
+    (i32.store8 (i32.add (local.get $p) (i32.const 3)) (i32.const 101))
+    (i32.store8 (i32.add (local.get $p) (i32.const 4)) (i32.const 58))
+    (i32.store8 (i32.add (local.get $p) (i32.const 5)) (i32.const 32))
+
+    (local.set $nlen (call $write_u64_dec (local.get $ms_int) (i32.add (local.get $p) (i32.const 6))))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 6) (local.get $nlen))) (i32.const 46))
+    (call $write_u32_pad3 (local.get $ms_frac) (i32.add (local.get $p) (i32.add (i32.const 7) (local.get $nlen))))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 10) (local.get $nlen))) (i32.const 32))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 11) (local.get $nlen))) (i32.const 109))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 12) (local.get $nlen))) (i32.const 115))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 13) (local.get $nlen))) (i32.const 10))
+
+    (call $write (local.get $p) (i32.add (i32.const 14) (local.get $nlen)))
+    (call $report_gc (local.get $allocs) (local.get $batches))
+    (call $proc_exit (i32.const 0)))
+)
+
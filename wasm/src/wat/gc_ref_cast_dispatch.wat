@@ -0,0 +1,235 @@
+(module
+  (import "wasi_snapshot_preview1" "fd_write"
+    (func $fd_write (param i32 i32 i32 i32) (result i32)))
+  (import "wasi_snapshot_preview1" "clock_time_get"
+    (func $clock_time_get (param i32 i64 i32) (result i32)))
+  (import "wasi_snapshot_preview1" "proc_exit"
+    (func $proc_exit (param i32)))
+
+  (memory (export "memory") 2)
+
+  ;; Kotlin/Dart-style objects: every instance points at a vtable of typed funcrefs, and each
+  ;; method receives the base type and ref.casts `this` down to its concrete class.
+  (rec
+    (type $shape (sub (struct (field $vt (ref $vtable)))))
+    (type $vtable (struct (field $area (ref $method)) (field $scale (ref $method))))
+    (type $method (func (param (ref $shape)) (result i32))))
+  (type $square (sub final $shape (struct (field $vt (ref $vtable)) (field $s (mut i32)))))
+  (type $rect (sub final $shape (struct (field $vt (ref $vtable)) (field $w (mut i32)) (field $h (mut i32)))))
+  (type $tri (sub final $shape (struct (field $vt (ref $vtable)) (field $b (mut i32)) (field $h (mut i32)))))
+  (type $shapes (array (mut (ref null $shape))))
+
+  (global $vt_square (ref $vtable) (struct.new $vtable (ref.func $square_area) (ref.func $square_scale)))
+  (global $vt_rect (ref $vtable) (struct.new $vtable (ref.func $rect_area) (ref.func $rect_scale)))
+  (global $vt_tri (ref $vtable) (struct.new $vtable (ref.func $tri_area) (ref.func $tri_scale)))
+
+  (func $square_area (type $method) (param $self (ref $shape)) (result i32)
+    (i32.mul
+      (struct.get $square $s (ref.cast (ref $square) (local.get $self)))
+      (struct.get $square $s (ref.cast (ref $square) (local.get $self)))))
+
+  (func $square_scale (type $method) (param $self (ref $shape)) (result i32)
+    (struct.set $square $s
+      (ref.cast (ref $square) (local.get $self))
+      (i32.and
+        (i32.add (struct.get $square $s (ref.cast (ref $square) (local.get $self))) (i32.const 1))
+        (i32.const 255)))
+    (i32.const 1))
+
+  (func $rect_area (type $method) (param $self (ref $shape)) (result i32)
+    (i32.mul
+      (struct.get $rect $w (ref.cast (ref $rect) (local.get $self)))
+      (struct.get $rect $h (ref.cast (ref $rect) (local.get $self)))))
+
+  (func $rect_scale (type $method) (param $self (ref $shape)) (result i32)
+    (struct.set $rect $w
+      (ref.cast (ref $rect) (local.get $self))
+      (i32.and
+        (i32.add (struct.get $rect $w (ref.cast (ref $rect) (local.get $self))) (i32.const 3))
+        (i32.const 255)))
+    (i32.const 2))
+
+  (func $tri_area (type $method) (param $self (ref $shape)) (result i32)
+    (i32.shr_u
+      (i32.mul
+        (struct.get $tri $b (ref.cast (ref $tri) (local.get $self)))
+        (struct.get $tri $h (ref.cast (ref $tri) (local.get $self))))
+      (i32.const 1)))
+
+  (func $tri_scale (type $method) (param $self (ref $shape)) (result i32)
+    (struct.set $tri $h
+      (ref.cast (ref $tri) (local.get $self))
+      (i32.and
+        (i32.add (struct.get $tri $h (ref.cast (ref $tri) (local.get $self))) (i32.const 5))
+        (i32.const 255)))
+    (i32.const 3))
+
+  (func $new_shape (param $x i32) (result (ref $shape))
+    (local $sel i32)
+    (local.set $sel (i32.rem_u (local.get $x) (i32.const 3)))
+    (if (result (ref $shape)) (i32.eqz (local.get $sel))
+      (then (struct.new $square (global.get $vt_square) (i32.and (local.get $x) (i32.const 255))))
+      (else
+        (if (result (ref $shape)) (i32.eq (local.get $sel) (i32.const 1))
+          (then
+            (struct.new $rect
+              (global.get $vt_rect)
+              (i32.and (local.get $x) (i32.const 255))
+              (i32.and (i32.shr_u (local.get $x) (i32.const 8)) (i32.const 255))))
+          (else
+            (struct.new $tri
+              (global.get $vt_tri)
+              (i32.and (local.get $x) (i32.const 255))
+              (i32.and (i32.shr_u (local.get $x) (i32.const 16)) (i32.const 255))))))))
+
+  (func $xorshift32 (param $x i32) (result i32)
+    (local.set $x (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 13))))
+    (local.set $x (i32.xor (local.get $x) (i32.shr_u (local.get $x) (i32.const 17))))
+    (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 5))))
+
+  (func $write (param $ptr i32) (param $len i32)
+    (i32.store (i32.const 0) (local.get $ptr))
+    (i32.store (i32.const 4) (local.get $len))
+    (call $fd_write (i32.const 1) (i32.const 0) (i32.const 1) (i32.const 8))
+    drop)
+
+  (func $write_u64_dec (param $n i64) (param $out i32) (result i32)
+    (local $scratch i32)
+    (local $p i32)
+    (local $len i32)
+    (local $i i32)
+
+    (if (i64.eq (local.get $n) (i64.const 0))
+      (then
+        (i32.store8 (local.get $out) (i32.const 48))
+        (return (i32.const 1))))
+
+    (local.set $scratch (i32.add (local.get $out) (i32.const 32)))
+    (local.set $p (local.get $scratch))
+
+    (block $done
+      (loop $loop
+        (br_if $done (i64.eq (local.get $n) (i64.const 0)))
+        (local.set $p (i32.sub (local.get $p) (i32.const 1)))
+        (i32.store8
+          (local.get $p)
+          (i32.add
+            (i32.wrap_i64 (i64.rem_u (local.get $n) (i64.const 10)))
+            (i32.const 48)))
+        (local.set $n (i64.div_u (local.get $n) (i64.const 10)))
+        (br $loop)))
+
+    (local.set $len (i32.sub (local.get $scratch) (local.get $p)))
+    (local.set $i (i32.const 0))
+    (block $copy_done
+      (loop $copy
+        (br_if $copy_done (i32.ge_u (local.get $i) (local.get $len)))
+        (i32.store8
+          (i32.add (local.get $out) (local.get $i))
+          (i32.load8_u (i32.add (local.get $p) (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $copy)))
+    (local.get $len))
+
+  (func $write_u32_pad3 (param $v i32) (param $out i32)
+    (i32.store8
+      (local.get $out)
+      (i32.add (i32.div_u (local.get $v) (i32.const 100)) (i32.const 48)))
+    (i32.store8
+      (i32.add (local.get $out) (i32.const 1))
+      (i32.add
+        (i32.rem_u (i32.div_u (local.get $v) (i32.const 10)) (i32.const 10))
+        (i32.const 48)))
+    (i32.store8
+      (i32.add (local.get $out) (i32.const 2))
+      (i32.add (i32.rem_u (local.get $v) (i32.const 10)) (i32.const 48))))
+
+  (func (export "_start")
+    (local $i i32)
+    (local $x i32)
+    (local $acc i32)
+    (local $obj (ref null $shape))
+    (local $shapes (ref null $shapes))
+    (local $t0 i64)
+    (local $t1 i64)
+    (local $diff i64)
+    (local $ms_int i64)
+    (local $ms_frac i32)
+    (local $p i32)
+    (local $nlen i32)
+
+    ;; 1024 objects in random class order, so call_ref targets are megamorphic
+    (local.set $x (i32.const 2463534242))
+    (local.set $shapes (array.new_default $shapes (i32.const 1024)))
+    (local.set $i (i32.const 0))
+    (block $filled
+      (loop $fill
+        (br_if $filled (i32.ge_u (local.get $i) (i32.const 1024)))
+        (local.set $x (call $xorshift32 (local.get $x)))
+        (array.set $shapes (local.get $shapes) (local.get $i) (call $new_shape (local.get $x)))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $fill)))
+
+    ;; start timing
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 16))
+    drop
+    (local.set $t0 (i64.load (i32.const 16)))
+
+    ;; 20M virtual calls: area() on every object, plus scale() on every 4th
+    (local.set $i (i32.const 0))
+    (block $done
+      (loop $loop
+        (br_if $done (i32.ge_u (local.get $i) (i32.const 20000000)))
+        (local.set $obj (array.get $shapes (local.get $shapes) (i32.and (local.get $i) (i32.const 1023))))
+        (local.set $acc
+          (i32.add
+            (local.get $acc)
+            (call_ref $method
+              (ref.as_non_null (local.get $obj))
+              (struct.get $vtable $area (struct.get $shape $vt (local.get $obj))))))
+        (if (i32.eqz (i32.and (local.get $i) (i32.const 3)))
+          (then
+            (local.set $acc
+              (i32.xor
+                (local.get $acc)
+                (call_ref $method
+                  (ref.as_non_null (local.get $obj))
+                  (struct.get $vtable $scale (struct.get $shape $vt (local.get $obj))))))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $loop)))
+
+    (i32.store (i32.const 32) (local.get $acc))
+
+    ;; end timing
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 24))
+    drop
+    (local.set $t1 (i64.load (i32.const 24)))
+
+    (local.set $diff (i64.sub (local.get $t1) (local.get $t0)))
+    (local.set $ms_int (i64.div_u (local.get $diff) (i64.const 1000000)))
+    (local.set $ms_frac
+      (i32.wrap_i64
+        (i64.div_u
+          (i64.rem_u (local.get $diff) (i64.const 1000000))
+          (i64.const 1000))))
+
+    (local.set $p (i32.const 256))
+    (i32.store8 (i32.add (local.get $p) (i32.const 0)) (i32.const 84))
+    (i32.store8 (i32.add (local.get $p) (i32.const 1)) (i32.const 105))
+    (i32.store8 (i32.add (local.get $p) (i32.const 2)) (i32.const 109))
+    (i32.store8 (i32.add (local.get $p) (i32.const 3)) (i32.const 101))
+    (i32.store8 (i32.add (local.get $p) (i32.const 4)) (i32.const 58))
+    (i32.store8 (i32.add (local.get $p) (i32.const 5)) (i32.const 32))
+
+    (local.set $nlen (call $write_u64_dec (local.get $ms_int) (i32.add (local.get $p) (i32.const 6))))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 6) (local.get $nlen))) (i32.const 46))
+    (call $write_u32_pad3 (local.get $ms_frac) (i32.add (local.get $p) (i32.add (i32.const 7) (local.get $nlen))))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 10) (local.get $nlen))) (i32.const 32))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 11) (local.get $nlen))) (i32.const 109))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 12) (local.get $nlen))) (i32.const 115))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 13) (local.get $nlen))) (i32.const 10))
+
+    (call $write (local.get $p) (i32.add (i32.const 14) (local.get $nlen)))
+    (call $proc_exit (i32.const 0)))
+)
+
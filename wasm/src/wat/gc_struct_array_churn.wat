@@ -0,0 +1,270 @@
+(module
+  (import "wasi_snapshot_preview1" "fd_write"
+    (func $fd_write (param i32 i32 i32 i32) (result i32)))
+  (import "wasi_snapshot_preview1" "clock_time_get"
+    (func $clock_time_get (param i32 i64 i32) (result i32)))
+  (import "wasi_snapshot_preview1" "proc_exit"
+    (func $proc_exit (param i32)))
+
+  (memory (export "memory") 2)
+
+  ;; Short-lived structs and byte arrays; a 1024-slot ring keeps the most recent ones
+  ;; reachable so young objects regularly survive into the next collection.
+  (type $pair (struct (field $a (mut i32)) (field $b (mut i64))))
+  (type $bytes (array (mut i8)))
+  (type $ring (array (mut (ref null $pair))))
+
+  ;; Metric names for $report_gc.
+  (data (i32.const 512) "allocs")
+  (data (i32.const 528) "batches")
+  (data (i32.const 544) "batch_p50_us")
+  (data (i32.const 560) "batch_max_us")
+
+  (func $xorshift32 (param $x i32) (result i32)
+    (local.set $x (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 13))))
+    (local.set $x (i32.xor (local.get $x) (i32.shr_u (local.get $x) (i32.const 17))))
+    (i32.xor (local.get $x) (i32.shl (local.get $x) (i32.const 5))))
+
+  ;; Stores the ns elapsed since $since into batch slot $b (at 4096) and returns the new batch start.
+  (func $batch_mark (param $b i32) (param $since i64) (result i64)
+    (local $now i64)
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 24))
+    drop
+    (local.set $now (i64.load (i32.const 24)))
+    (i64.store
+      (i32.add (i32.const 4096) (i32.shl (local.get $b) (i32.const 3)))
+      (i64.sub (local.get $now) (local.get $since)))
+    (local.get $now))
+
+  (func $sort_u64 (param $base i32) (param $n i32)
+    (local $i i32)
+    (local $j i32)
+    (local $pj i32)
+    (local $v i64)
+    (local.set $i (i32.const 1))
+    (block $done
+      (loop $outer
+        (br_if $done (i32.ge_u (local.get $i) (local.get $n)))
+        (local.set $v (i64.load (i32.add (local.get $base) (i32.shl (local.get $i) (i32.const 3)))))
+        (local.set $j (local.get $i))
+        (block $placed
+          (loop $inner
+            (br_if $placed (i32.eqz (local.get $j)))
+            (local.set $pj (i32.add (local.get $base) (i32.shl (local.get $j) (i32.const 3))))
+            (br_if $placed (i64.le_u (i64.load (i32.sub (local.get $pj) (i32.const 8))) (local.get $v)))
+            (i64.store (local.get $pj) (i64.load (i32.sub (local.get $pj) (i32.const 8))))
+            (local.set $j (i32.sub (local.get $j) (i32.const 1)))
+            (br $inner)))
+        (i64.store (i32.add (local.get $base) (i32.shl (local.get $j) (i32.const 3))) (local.get $v))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $outer))))
+
+  ;; Writes "Metric: <name> <v>\n"; the harness picks these up next to "Time:".
+  (func $write_metric (param $name i32) (param $name_len i32) (param $v i64)
+    (local $p i32)
+    (local $i i32)
+    (local $nlen i32)
+    (local.set $p (i32.const 768))
+    ;; "Metric: " as a little-endian i64
+    (i64.store (local.get $p) (i64.const 0x203a63697274654d))
+    (local.set $i (i32.const 0))
+    (block $copied
+      (loop $copy
+        (br_if $copied (i32.ge_u (local.get $i) (local.get $name_len)))
+        (i32.store8
+          (i32.add (local.get $p) (i32.add (i32.const 8) (local.get $i)))
+          (i32.load8_u (i32.add (local.get $name) (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $copy)))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 8) (local.get $name_len))) (i32.const 32))
+    (local.set $nlen
+      (call $write_u64_dec (local.get $v) (i32.add (local.get $p) (i32.add (i32.const 9) (local.get $name_len)))))
+    (i32.store8
+      (i32.add (local.get $p) (i32.add (i32.add (i32.const 9) (local.get $name_len)) (local.get $nlen)))
+      (i32.const 10))
+    (call $write (local.get $p) (i32.add (i32.add (i32.const 10) (local.get $name_len)) (local.get $nlen))))
+
+  ;; Allocation count plus the median/worst batch time. A collector that stops the world shows
+  ;; up as batch_max_us far above batch_p50_us even when the total time looks fine.
+  (func $report_gc (param $allocs i64) (param $n i32)
+    (call $sort_u64 (i32.const 4096) (local.get $n))
+    (call $write_metric (i32.const 512) (i32.const 6) (local.get $allocs))
+    (call $write_metric (i32.const 528) (i32.const 7) (i64.extend_i32_u (local.get $n)))
+    (call $write_metric (i32.const 544) (i32.const 12)
+      (i64.div_u
+        (i64.load (i32.add (i32.const 4096) (i32.shl (i32.shr_u (local.get $n) (i32.const 1)) (i32.const 3))))
+        (i64.const 1000)))
+    (call $write_metric (i32.const 560) (i32.const 12)
+      (i64.div_u
+        (i64.load (i32.add (i32.const 4096) (i32.shl (i32.sub (local.get $n) (i32.const 1)) (i32.const 3))))
+        (i64.const 1000))))
+
+  (func $write (param $ptr i32) (param $len i32)
+    (i32.store (i32.const 0) (local.get $ptr))
+    (i32.store (i32.const 4) (local.get $len))
+    (call $fd_write (i32.const 1) (i32.const 0) (i32.const 1) (i32.const 8))
+    drop)
+
+  (func $write_u64_dec (param $n i64) (param $out i32) (result i32)
+    (local $scratch i32)
+    (local $p i32)
+    (local $len i32)
+    (local $i i32)
+
+    (if (i64.eq (local.get $n) (i64.const 0))
+      (then
+        (i32.store8 (local.get $out) (i32.const 48))
+        (return (i32.const 1))))
+
+    (local.set $scratch (i32.add (local.get $out) (i32.const 32)))
+    (local.set $p (local.get $scratch))
+
+    (block $done
+      (loop $loop
+        (br_if $done (i64.eq (local.get $n) (i64.const 0)))
+        (local.set $p (i32.sub (local.get $p) (i32.const 1)))
+        (i32.store8
+          (local.get $p)
+          (i32.add
+            (i32.wrap_i64 (i64.rem_u (local.get $n) (i64.const 10)))
+            (i32.const 48)))
+        (local.set $n (i64.div_u (local.get $n) (i64.const 10)))
+        (br $loop)))
+
+    (local.set $len (i32.sub (local.get $scratch) (local.get $p)))
+    (local.set $i (i32.const 0))
+    (block $copy_done
+      (loop $copy
+        (br_if $copy_done (i32.ge_u (local.get $i) (local.get $len)))
+        (i32.store8
+          (i32.add (local.get $out) (local.get $i))
+          (i32.load8_u (i32.add (local.get $p) (local.get $i))))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $copy)))
+    (local.get $len))
+
+  (func $write_u32_pad3 (param $v i32) (param $out i32)
+    (i32.store8
+      (local.get $out)
+      (i32.add (i32.div_u (local.get $v) (i32.const 100)) (i32.const 48)))
+    (i32.store8
+      (i32.add (local.get $out) (i32.const 1))
+      (i32.add
+        (i32.rem_u (i32.div_u (local.get $v) (i32.const 10)) (i32.const 10))
+        (i32.const 48)))
+    (i32.store8
+      (i32.add (local.get $out) (i32.const 2))
+      (i32.add (i32.rem_u (local.get $v) (i32.const 10)) (i32.const 48))))
+
+  (func (export "_start")
+    (local $i i32)
+    (local $j i32)
+    (local $x i32)
+    (local $slot i32)
+    (local $acc i64)
+    (local $ring (ref null $ring))
+    (local $obj (ref null $pair))
+    (local $buf (ref null $bytes))
+    (local $allocs i64)
+    (local $batches i32)
+    (local $tb i64)
+    (local $t0 i64)
+    (local $t1 i64)
+    (local $diff i64)
+    (local $ms_int i64)
+    (local $ms_frac i32)
+    (local $p i32)
+    (local $nlen i32)
+
+    (local.set $x (i32.const 2463534242))
+    (local.set $ring (array.new $ring (struct.new $pair (i32.const 0) (i64.const 0)) (i32.const 1024)))
+
+    ;; start timing
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 16))
+    drop
+    (local.set $t0 (i64.load (i32.const 16)))
+    (local.set $tb (local.get $t0))
+
+    ;; 100 batches x 200k iterations: one struct each, one 16..79 byte array every 4th.
+    (local.set $batches (i32.const 100))
+    (local.set $j (i32.const 0))
+    (block $batches_done
+      (loop $batch
+        (br_if $batches_done (i32.ge_u (local.get $j) (local.get $batches)))
+        (local.set $i (i32.const 0))
+        (block $done
+          (loop $loop
+            (br_if $done (i32.ge_u (local.get $i) (i32.const 200000)))
+            (local.set $x (call $xorshift32 (local.get $x)))
+            (local.set $slot (i32.and (local.get $x) (i32.const 1023)))
+
+            ;; read the survivor we are about to drop, then replace it
+            (local.set $obj (array.get $ring (local.get $ring) (local.get $slot)))
+            (local.set $acc
+              (i64.add
+                (local.get $acc)
+                (i64.add
+                  (struct.get $pair $b (local.get $obj))
+                  (i64.extend_i32_u (struct.get $pair $a (local.get $obj))))))
+            (array.set $ring
+              (local.get $ring)
+              (local.get $slot)
+              (struct.new $pair (local.get $x) (i64.extend_i32_u (local.get $i))))
+
+            (if (i32.eqz (i32.and (local.get $i) (i32.const 3)))
+              (then
+                (local.set $buf
+                  (array.new_default $bytes (i32.add (i32.const 16) (i32.and (local.get $x) (i32.const 63)))))
+                (array.set $bytes (local.get $buf) (i32.const 0) (local.get $x))
+                (local.set $acc
+                  (i64.add
+                    (local.get $acc)
+                    (i64.extend_i32_u
+                      (i32.add
+                        (array.len (local.get $buf))
+                        (array.get_u $bytes (local.get $buf) (i32.const 0))))))
+                (local.set $allocs (i64.add (local.get $allocs) (i64.const 1)))))
+
+            (local.set $i (i32.add (local.get $i) (i32.const 1)))
+            (br $loop)))
+        (local.set $allocs (i64.add (local.get $allocs) (i64.const 200000)))
+        (local.set $tb (call $batch_mark (local.get $j) (local.get $tb)))
+        (local.set $j (i32.add (local.get $j) (i32.const 1)))
+        (br $batch)))
+
+    (i64.store (i32.const 32) (local.get $acc))
+
+    ;; end timing
+    (call $clock_time_get (i32.const 1) (i64.const 0) (i32.const 24))
+    drop
+    (local.set $t1 (i64.load (i32.const 24)))
+
+    (local.set $diff (i64.sub (local.get $t1) (local.get $t0)))
+    (local.set $ms_int (i64.div_u (local.get $diff) (i64.const 1000000)))
+    (local.set $ms_frac
+      (i32.wrap_i64
+        (i64.div_u
+          (i64.rem_u (local.get $diff) (i64.const 1000000))
+          (i64.const 1000))))
+
+    (local.set $p (i32.const 256))
+    (i32.store8 (i32.add (local.get $p) (i32.const 0)) (i32.const 84))
+    (i32.store8 (i32.add (local.get $p) (i32.const 1)) (i32.const 105))
+    (i32.store8 (i32.add (local.get $p) (i32.const 2)) (i32.const 109))
+    (i32.store8 (i32.add (local.get $p) (i32.const 3)) (i32.const 101))
+    (i32.store8 (i32.add (local.get $p) (i32.const 4)) (i32.const 58))
+    (i32.store8 (i32.add (local.get $p) (i32.const 5)) (i32.const 32))
+
+    (local.set $nlen (call $write_u64_dec (local.get $ms_int) (i32.add (local.get $p) (i32.const 6))))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 6) (local.get $nlen))) (i32.const 46))
+    (call $write_u32_pad3 (local.get $ms_frac) (i32.add (local.get $p) (i32.add (i32.const 7) (local.get $nlen))))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 10) (local.get $nlen))) (i32.const 32))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 11) (local.get $nlen))) (i32.const 109))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 12) (local.get $nlen))) (i32.const 115))
+    (i32.store8 (i32.add (local.get $p) (i32.add (i32.const 13) (local.get $nlen))) (i32.const 10))
+
+    (call $write (local.get $p) (i32.add (i32.const 14) (local.get $nlen)))
+    (call $report_gc (local.get $allocs) (local.get $batches))
+    (call $proc_exit (i32.const 0)))
+)
+
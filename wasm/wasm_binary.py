@@ -0,0 +1,770 @@
+#!/usr/bin/env python3
+"""
+Minimal WebAssembly binary encoding helpers (MVP subset).
+
+Used by build_corpus.py to emit generated modules directly; a multi-megabyte module
+is much cheaper to write as bytes than to round-trip through WAT text.
+"""
+
+from __future__ import annotations
+
+import struct
+from dataclasses import dataclass, field
+from typing import Iterable, Sequence
+
+MAGIC = b"\0asm\x01\0\0\0"
+
+I32 = 0x7F
+I64 = 0x7E
+F32 = 0x7D
+F64 = 0x7C
+FUNCREF = 0x70
+
+SEC_TYPE = 1
+SEC_IMPORT = 2
+SEC_FUNCTION = 3
+SEC_TABLE = 4
+SEC_MEMORY = 5
+SEC_GLOBAL = 6
+SEC_EXPORT = 7
+SEC_START = 8
+SEC_ELEM = 9
+SEC_CODE = 10
+SEC_DATA = 11
+SEC_DATACOUNT = 12
+
+# Opcodes without immediates, plus the ones that take (index) or (memarg) immediates.
+OP: dict[str, int] = {
+    "unreachable": 0x00,
+    "nop": 0x01,
+    "block": 0x02,
+    "loop": 0x03,
+    "if": 0x04,
+    "else": 0x05,
+    "end": 0x0B,
+    "br": 0x0C,
+    "br_if": 0x0D,
+    "return": 0x0F,
+    "call": 0x10,
+    "drop": 0x1A,
+    "select": 0x1B,
+    "local.get": 0x20,
+    "local.set": 0x21,
+    "local.tee": 0x22,
+    "global.get": 0x23,
+    "global.set": 0x24,
+    "i32.load": 0x28,
+    "i64.load": 0x29,
+    "f64.load": 0x2B,
+    "i32.load8_u": 0x2D,
+    "i32.store": 0x36,
+    "i64.store": 0x37,
+    "f64.store": 0x39,
+    "i32.store8": 0x3A,
+    "memory.size": 0x3F,
+    "memory.grow": 0x40,
+    "i32.const": 0x41,
+    "i64.const": 0x42,
+    "f64.const": 0x44,
+    "i32.eqz": 0x45,
+    "i32.eq": 0x46,
+    "i32.ne": 0x47,
+    "i32.lt_u": 0x49,
+    "i32.ge_u": 0x4F,
+    "i64.eqz": 0x50,
+    "i64.lt_u": 0x54,
+    "i64.gt_u": 0x56,
+    "i64.ge_u": 0x5A,
+    "i32.add": 0x6A,
+    "i32.sub": 0x6B,
+    "i32.mul": 0x6C,
+    "i32.and": 0x71,
+    "i32.or": 0x72,
+    "i32.xor": 0x73,
+    "i32.shl": 0x74,
+    "i32.shr_u": 0x76,
+    "i32.rotl": 0x77,
+    "i64.clz": 0x79,
+    "i64.add": 0x7C,
+    "i64.sub": 0x7D,
+    "i64.mul": 0x7E,
+    "i64.div_u": 0x80,
+    "i64.rem_u": 0x82,
+    "i64.xor": 0x85,
+    "i64.shl": 0x86,
+    "i64.shr_u": 0x88,
+    "f64.add": 0xA0,
+    "f64.sub": 0xA1,
+    "f64.mul": 0xA2,
+    "i32.wrap_i64": 0xA7,
+    "i64.extend_i32_u": 0xAD,
+}
+
+_MEM_ALIGN = {
+    "i32.load": 2,
+    "i64.load": 3,
+    "f64.load": 3,
+    "i32.load8_u": 0,
+    "i32.store": 2,
+    "i64.store": 3,
+    "f64.store": 3,
+    "i32.store8": 0,
+}
+_MEM_OPS = set(_MEM_ALIGN)
+_IDX_OPS = {"br", "br_if", "call", "local.get", "local.set", "local.tee", "global.get", "global.set"}
+BLOCK_EMPTY = 0x40
+
+
+def uleb(n: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def sleb(n: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if (n == 0 and not b & 0x40) or (n == -1 and b & 0x40):
+            out.append(b)
+            return bytes(out)
+        out.append(b | 0x80)
+
+
+def name(s: str) -> bytes:
+    raw = s.encode("utf-8")
+    return uleb(len(raw)) + raw
+
+
+def vec(items: Iterable[bytes]) -> bytes:
+    items = list(items)
+    return uleb(len(items)) + b"".join(items)
+
+
+def section(sid: int, payload: bytes) -> bytes:
+    return bytes([sid]) + uleb(len(payload)) + payload
+
+
+def functype(params: Iterable[int], results: Iterable[int]) -> bytes:
+    return b"\x60" + vec(bytes([t]) for t in params) + vec(bytes([t]) for t in results)
+
+
+def code(*ops: tuple | str) -> bytes:
+    """
+    Encode an instruction sequence. Each op is a mnemonic or a (mnemonic, immediate) tuple:
+    ("i32.const", 7), ("call", 3), ("i64.load", offset), ("block", blocktype).
+    """
+
+    out = bytearray()
+    for op in ops:
+        mnem, imm = (op, None) if isinstance(op, str) else (op[0], op[1] if len(op) > 1 else None)
+        out.append(OP[mnem])
+        if mnem in ("i32.const", "i64.const"):
+            out += sleb(int(imm))  # type: ignore[arg-type]
+        elif mnem == "f64.const":
+            out += struct.pack("<d", float(imm))  # type: ignore[arg-type]
+        elif mnem in _MEM_OPS:
+            out += uleb(_MEM_ALIGN[mnem]) + uleb(int(imm or 0))  # type: ignore[arg-type]
+        elif mnem in _IDX_OPS:
+            out += uleb(int(imm))  # type: ignore[arg-type]
+        elif mnem in ("memory.size", "memory.grow"):
+            out.append(0)  # memory index
+        elif mnem in ("block", "loop", "if"):
+            out.append(BLOCK_EMPTY if imm is None else int(imm))  # type: ignore[arg-type]
+    return bytes(out)
+
+
+def func_body(body: bytes, locals_: Iterable[tuple[int, int]] = ()) -> bytes:
+    """body must already end with `end`; locals_ is [(count, valtype), ...]."""
+    decl = vec(uleb(n) + bytes([t]) for n, t in locals_)
+    payload = decl + body
+    return uleb(len(payload)) + payload
+
+
+# WASI timing scaffold shared by generated tiers: same `Time:` / `Metric:` output as the WAT guests.
+FIRST_TYPE = 7  # caller-supplied types start here
+FIRST_FUNC = 7  # caller-supplied functions start here (after 3 imports, 3 helpers and _start)
+VOID_TYPE = 6  # `() -> ()`, the type `bench` must have
+SINK = 32  # 8-byte slot a timed body can store its result to, so the work stays observable
+_METRIC_NAMES = 1024
+
+_F_FD_WRITE, _F_CLOCK, _F_EXIT, _F_WRITE, _F_U64DEC, _F_METRIC, _F_START = range(7)
+
+
+def print_helpers(fd_write: int = _F_FD_WRITE, first: int = _F_WRITE) -> list[bytes]:
+    """
+    Bodies of write(ptr, len), write_u64_dec(n, out) -> len and write_metric(name, name_len, v), in that order,
+    for a module that imports fd_write as function fd_write and places these at function first, first+1, first+2.
+    They use memory [0, 1024) as scratch.
+    """
+
+    write_f, u64dec_f = first, first + 1
+    write = code(
+        ("i32.const", 0), ("local.get", 0), ("i32.store", 0),
+        ("i32.const", 0), ("local.get", 1), ("i32.store", 4),
+        ("i32.const", 1), ("i32.const", 0), ("i32.const", 1), ("i32.const", 8), ("call", fd_write), "drop",
+        "end",
+    )  # fmt: skip
+    # (n i64, out i32) -> len; locals: 2 p, 3 len, 4 i, 5 scratch
+    u64dec = code(
+        ("local.get", 0), "i64.eqz", "if",
+        ("local.get", 1), ("i32.const", 48), ("i32.store8", 0), ("i32.const", 1), "return",
+        "end",
+        ("local.get", 1), ("i32.const", 32), "i32.add", ("local.tee", 5), ("local.set", 2),
+        "block", "loop",
+        ("local.get", 0), "i64.eqz", ("br_if", 1),
+        ("local.get", 2), ("i32.const", 1), "i32.sub", ("local.tee", 2),
+        ("local.get", 0), ("i64.const", 10), "i64.rem_u", "i32.wrap_i64", ("i32.const", 48), "i32.add",
+        ("i32.store8", 0),
+        ("local.get", 0), ("i64.const", 10), "i64.div_u", ("local.set", 0),
+        ("br", 0),
+        "end", "end",
+        ("local.get", 5), ("local.get", 2), "i32.sub", ("local.set", 3),
+        ("i32.const", 0), ("local.set", 4),
+        "block", "loop",
+        ("local.get", 4), ("local.get", 3), "i32.ge_u", ("br_if", 1),
+        ("local.get", 1), ("local.get", 4), "i32.add",
+        ("local.get", 2), ("local.get", 4), "i32.add", ("i32.load8_u", 0),
+        ("i32.store8", 0),
+        ("local.get", 4), ("i32.const", 1), "i32.add", ("local.set", 4),
+        ("br", 0),
+        "end", "end",
+        ("local.get", 3),
+        "end",
+    )  # fmt: skip
+    # (name, name_len, v i64): "Metric: <name> <v>\n" built at 256; locals: 3 i, 4 digits
+    metric = code(
+        ("i32.const", 256), ("i64.const", 0x203A63697274654D), ("i64.store", 0),
+        ("i32.const", 0), ("local.set", 3),
+        "block", "loop",
+        ("local.get", 3), ("local.get", 1), "i32.ge_u", ("br_if", 1),
+        ("local.get", 3), ("i32.const", 264), "i32.add",
+        ("local.get", 0), ("local.get", 3), "i32.add", ("i32.load8_u", 0),
+        ("i32.store8", 0),
+        ("local.get", 3), ("i32.const", 1), "i32.add", ("local.set", 3),
+        ("br", 0),
+        "end", "end",
+        ("local.get", 1), ("i32.const", 264), "i32.add", ("i32.const", 32), ("i32.store8", 0),
+        ("local.get", 2), ("local.get", 1), ("i32.const", 265), "i32.add", ("call", u64dec_f), ("local.set", 4),
+        ("local.get", 1), ("i32.const", 265), "i32.add", ("local.get", 4), "i32.add", ("i32.const", 10), ("i32.store8", 0),
+        ("i32.const", 256), ("local.get", 1), ("i32.const", 10), "i32.add", ("local.get", 4), "i32.add",
+        ("call", write_f),
+        "end",
+    )  # fmt: skip
+    return [func_body(write), func_body(u64dec, [(4, I32)]), func_body(metric, [(2, I32)])]
+
+
+def wasi_timed_module(
+    *,
+    types: Sequence[bytes],
+    funcs: Sequence[tuple[int, bytes]],
+    bench: int,
+    metrics: Sequence[tuple[str, int | bytes]] = (),
+    stamp_realtime: bool = False,
+    memory_pages: int = 1,
+    imports: Sequence[tuple[str, bytes]] = (),
+) -> bytes:
+    """
+    WASI command whose _start calls `bench` (a `() -> ()` function) between two monotonic clock reads,
+    prints `Time: <ms> ms`, then `Metric: <name> <value>` per entry of `metrics`, and exits 0. A metric value
+    is a constant, or an instruction sequence that leaves an i64 (run after Time is printed, in order).
+
+    types: extra functypes, indexed from FIRST_TYPE. funcs: [(type_index, func_body(...)), ...], indexed
+    from FIRST_FUNC. With stamp_realtime, _start reads CLOCK_REALTIME before anything else and reports it
+    as `start_realtime_ns` (host-side time to first instruction).
+
+    imports: extra wasi_snapshot_preview1 functions as (name, functype(...)); they become functions 3, 4, ...
+    and shift every defined function, so caller functions then start at FIRST_FUNC + len(imports).
+    """
+
+    k = len(imports)
+    f_write, f_u64dec, f_metric, f_start = _F_WRITE + k, _F_U64DEC + k, _F_METRIC + k, _F_START + k
+
+    all_types = [
+        functype([I32] * 4, [I32]),  # fd_write
+        functype([I32, I64, I32], [I32]),  # clock_time_get
+        functype([I32], []),  # proc_exit
+        functype([I32, I32], []),  # write
+        functype([I64, I32], [I32]),  # write_u64_dec
+        functype([I32, I32, I64], []),  # write_metric
+        functype([], []),  # _start
+        *types,
+        *(t for _, t in imports),
+    ]
+    import_sec = vec(
+        name("wasi_snapshot_preview1") + name(n) + b"\x00" + uleb(t)
+        for n, t in (
+            ("fd_write", 0),
+            ("clock_time_get", 1),
+            ("proc_exit", 2),
+            *((n, FIRST_TYPE + len(types) + i) for i, (n, _) in enumerate(imports)),
+        )
+    )
+    func_types = vec(uleb(t) for t in [3, 4, 5, 6, *(t for t, _ in funcs)])
+    exports = vec([name("memory") + b"\x02\x00", name("_start") + b"\x00" + uleb(f_start)])
+
+    names: list[tuple[int, bytes]] = []
+    off = _METRIC_NAMES
+    all_metrics = ([("start_realtime_ns", -1)] if stamp_realtime else []) + list(metrics)
+    for n, _ in all_metrics:
+        names.append((off, n.encode("ascii")))
+        off += len(n)
+    report = bytearray()
+    for (n_off, raw), (_, value) in zip(names, all_metrics):
+        if isinstance(value, bytes):
+            load = value
+        elif value < 0:  # -1: the realtime stamp
+            load = code(("i32.const", 40), ("i64.load", 0))
+        else:
+            load = code(("i64.const", value))
+        report += code(("i32.const", n_off), ("i32.const", len(raw))) + load + code(("call", f_metric))
+
+    # locals: 0 diff (i64), 1 digits
+    start = (
+        (code(("i32.const", 0), ("i64.const", 0), ("i32.const", 40), ("call", _F_CLOCK), "drop") if stamp_realtime else b"")
+        + code(
+            ("i32.const", 1), ("i64.const", 0), ("i32.const", 16), ("call", _F_CLOCK), "drop",
+            ("call", bench),
+            ("i32.const", 1), ("i64.const", 0), ("i32.const", 24), ("call", _F_CLOCK), "drop",
+            ("i32.const", 24), ("i64.load", 0), ("i32.const", 16), ("i64.load", 0), "i64.sub", ("local.set", 0),
+            # "Time: <ms>.<frac3> ms\n"; the fraction is written as 1000+frac and its leading 1 becomes '.'
+            ("i32.const", 256), ("i32.const", 0x656D6954), ("i32.store", 0),
+            ("i32.const", 260), ("i32.const", 58), ("i32.store8", 0),
+            ("i32.const", 261), ("i32.const", 32), ("i32.store8", 0),
+            ("local.get", 0), ("i64.const", 1000000), "i64.div_u", ("i32.const", 262), ("call", f_u64dec), ("local.set", 1),
+            ("local.get", 0), ("i64.const", 1000000), "i64.rem_u", ("i64.const", 1000), "i64.div_u",
+            ("i64.const", 1000), "i64.add", ("local.get", 1), ("i32.const", 262), "i32.add", ("call", f_u64dec), "drop",
+            ("local.get", 1), ("i32.const", 262), "i32.add", ("i32.const", 46), ("i32.store8", 0),
+            ("local.get", 1), ("i32.const", 266), "i32.add", ("i32.const", 32), ("i32.store8", 0),
+            ("local.get", 1), ("i32.const", 267), "i32.add", ("i32.const", 109), ("i32.store8", 0),
+            ("local.get", 1), ("i32.const", 268), "i32.add", ("i32.const", 115), ("i32.store8", 0),
+            ("local.get", 1), ("i32.const", 269), "i32.add", ("i32.const", 10), ("i32.store8", 0),
+            ("i32.const", 256), ("local.get", 1), ("i32.const", 14), "i32.add", ("call", f_write),
+        )
+        + bytes(report)
+        + code(("i32.const", 0), ("call", _F_EXIT), "end")
+    )  # fmt: skip
+
+    bodies = [*print_helpers(_F_FD_WRITE, f_write), func_body(start, [(1, I64), (1, I32)]), *(b for _, b in funcs)]
+    data = vec(b"\x00" + code(("i32.const", o), "end") + uleb(len(raw)) + raw for o, raw in names)
+    return (
+        MAGIC
+        + section(SEC_TYPE, vec(all_types))
+        + section(SEC_IMPORT, import_sec)
+        + section(SEC_FUNCTION, func_types)
+        + section(SEC_MEMORY, vec([b"\x00" + uleb(memory_pages)]))
+        + section(SEC_EXPORT, exports)
+        + section(SEC_CODE, vec(bodies))
+        + (section(SEC_DATA, data) if names else b"")
+    )
+
+
+def clock_calibration_module(calls: int = 100_000) -> bytes:
+    """
+    WASI command that reads CLOCK_MONOTONIC `calls` times back to back and prints
+      Metric: clock_res_ns <clock_res_get>
+      Metric: clock_call_ps <mean cost of one clock_time_get, picoseconds>
+      Metric: clock_step_ns <smallest non-zero difference between consecutive reads (effective resolution)>
+      Metric: clock_zero_steps <consecutive reads that returned the same value>
+    """
+
+    types = [
+        functype([I32] * 4, [I32]),  # fd_write
+        functype([I32, I64, I32], [I32]),  # clock_time_get
+        functype([I32, I32], [I32]),  # clock_res_get
+        functype([I32], []),  # proc_exit
+        functype([I32, I32], []),  # write
+        functype([I64, I32], [I32]),  # write_u64_dec
+        functype([I32, I32, I64], []),  # write_metric
+        functype([], []),  # _start
+    ]
+    imports = vec(
+        name("wasi_snapshot_preview1") + name(n) + b"\x00" + uleb(t)
+        for t, n in enumerate(("fd_write", "clock_time_get", "clock_res_get", "proc_exit"))
+    )
+    clock, res_get, proc_exit, metric = 1, 2, 3, 6
+    read = (("i32.const", 1), ("i64.const", 0), ("i32.const", 24), ("call", clock), "drop")
+    # locals: 0 prev, 1 cur, 2 min step, 3 zero steps, 4 delta (i64); 5 remaining calls (i32)
+    measure = code(
+        ("i32.const", 1), ("i32.const", 48), ("call", res_get), "drop",
+        ("i32.const", 1), ("i64.const", 0), ("i32.const", 16), ("call", clock), "drop",
+        ("i32.const", 16), ("i64.load", 0), ("local.set", 0),
+        ("i64.const", -1), ("local.set", 2),
+        ("i32.const", calls), ("local.set", 5),
+        "block", "loop",
+        ("local.get", 5), "i32.eqz", ("br_if", 1),
+        *read,
+        ("i32.const", 24), ("i64.load", 0), ("local.tee", 1), ("local.get", 0), "i64.sub", ("local.tee", 4),
+        "i64.eqz", "if",
+        ("local.get", 3), ("i64.const", 1), "i64.add", ("local.set", 3),
+        "else",
+        ("local.get", 4), ("local.get", 2), "i64.lt_u", "if", ("local.get", 4), ("local.set", 2), "end",
+        "end",
+        ("local.get", 1), ("local.set", 0),
+        ("local.get", 5), ("i32.const", 1), "i32.sub", ("local.set", 5),
+        ("br", 0),
+        "end", "end",
+        # min step stays u64 max when every read returned the same value; report 0 then
+        ("local.get", 2), ("i64.const", 1), "i64.add", "i64.eqz", "if", ("i64.const", 0), ("local.set", 2), "end",
+    )  # fmt: skip
+    metrics = [
+        ("clock_res_ns", code(("i32.const", 48), ("i64.load", 0))),
+        ("clock_call_ps", code(("local.get", 0), ("i32.const", 16), ("i64.load", 0), "i64.sub",
+                               ("i64.const", 1000), "i64.mul", ("i64.const", calls), "i64.div_u")),
+        ("clock_step_ns", code(("local.get", 2))),
+        ("clock_zero_steps", code(("local.get", 3))),
+    ]  # fmt: skip
+    start = bytearray(measure)
+    data = []
+    off = _METRIC_NAMES
+    for n, value in metrics:
+        raw = n.encode("ascii")
+        data.append(b"\x00" + code(("i32.const", off), "end") + uleb(len(raw)) + raw)
+        start += code(("i32.const", off), ("i32.const", len(raw))) + value + code(("call", metric))
+        off += len(raw)
+    start += code(("i32.const", 0), ("call", proc_exit), "end")
+    return (
+        MAGIC
+        + section(SEC_TYPE, vec(types))
+        + section(SEC_IMPORT, imports)
+        + section(SEC_FUNCTION, vec(uleb(t) for t in (4, 5, 6, 7)))
+        + section(SEC_MEMORY, vec([b"\x00\x01"]))
+        + section(SEC_EXPORT, vec([name("memory") + b"\x02\x00", name("_start") + b"\x00" + uleb(7)]))
+        + section(SEC_CODE, vec([*print_helpers(0, 4), func_body(bytes(start), [(5, I64), (1, I32)])]))
+        + section(SEC_DATA, vec(data))
+    )
+
+
+def empty_command_module(memory_pages: int = 1) -> bytes:
+    """Exports memory and an empty _start, imports nothing: process startup plus a minimal instantiate."""
+
+    return (
+        MAGIC
+        + section(SEC_TYPE, vec([functype([], [])]))
+        + section(SEC_FUNCTION, vec([uleb(0)]))
+        + section(SEC_MEMORY, vec([b"\x00" + uleb(memory_pages)]))
+        + section(SEC_EXPORT, vec([name("memory") + b"\x02\x00", name("_start") + b"\x00\x00"]))
+        + section(SEC_CODE, vec([func_body(code("end"))]))
+    )
+
+
+# Decoding: enough of the binary format (MVP plus the post-MVP opcode spaces the corpus uses) to walk every
+# instruction with its byte span. Prefixed opcodes are keyed as (prefix << 12) | subopcode.
+SEC_IMPORT_KINDS = ("func", "table", "memory", "global", "tag")
+PREFIX_FC, PREFIX_FD, PREFIX_FB, PREFIX_FE = 0xFC, 0xFD, 0xFB, 0xFE
+
+
+def op_key(prefix: int, sub: int) -> int:
+    return (prefix << 12) | sub
+
+
+class Reader:
+    def __init__(self, data: bytes, pos: int = 0, end: int | None = None) -> None:
+        self.data = data
+        self.pos = pos
+        self.end = len(data) if end is None else end
+
+    def at_end(self) -> bool:
+        return self.pos >= self.end
+
+    def byte(self) -> int:
+        if self.pos >= self.end:
+            raise ValueError("unexpected end of wasm data")
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def bytes(self, n: int) -> bytes:
+        if self.pos + n > self.end:
+            raise ValueError("unexpected end of wasm data")
+        out = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return out
+
+    def uleb(self) -> int:
+        result = shift = 0
+        while True:
+            b = self.byte()
+            result |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return result
+
+    def sleb(self) -> int:
+        result = shift = 0
+        while True:
+            b = self.byte()
+            result |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return result - (1 << shift) if b & 0x40 else result
+
+    def name(self) -> str:
+        return self.bytes(self.uleb()).decode("utf-8", errors="replace")
+
+    def heaptype(self) -> int:
+        return self.sleb()
+
+    def valtype(self) -> int:
+        t = self.byte()
+        if t in (0x63, 0x64):  # (ref null ht) / (ref ht)
+            self.heaptype()
+        return t
+
+    def limits(self) -> tuple[int, int | None]:
+        flags = self.byte()
+        lo = self.uleb()
+        return lo, (self.uleb() if flags & 1 else None)
+
+    def blocktype(self) -> int | None:
+        """None for the empty block type, -valtype for a single result, else a type index."""
+
+        b = self.data[self.pos] if self.pos < self.end else 0
+        if b == BLOCK_EMPTY:
+            self.pos += 1
+            return None
+        if 0x40 < b < 0x80:  # single-byte negative s33: a value type
+            return -self.valtype()
+        return self.sleb()
+
+    def memarg(self) -> int:
+        align = self.uleb()
+        if align & 0x40:  # multi-memory index
+            self.uleb()
+        return self.uleb()
+
+
+@dataclass
+class FuncType:
+    params: list[int]
+    results: list[int]
+
+
+@dataclass
+class ModuleInfo:
+    types: dict[int, FuncType]  # function types by type index (struct/array types are skipped)
+    imports: list[tuple[str, str, str, int]]  # (module, name, kind, type index or -1)
+    func_types: list[int]  # type index per function, imported functions first
+    num_imported_funcs: int
+    bodies: list[tuple[int, int]]  # (start, end) byte span of each code entry, after its size prefix
+    code_section: tuple[int, int]  # (start, end) of the code section payload
+    sections: list[tuple[int, int, int]]  # (id, payload start, payload end)
+    struct_fields: dict[int, int] = field(default_factory=dict)  # field count per GC struct type index
+    num_types: int = 0  # type index space (rec groups flattened)
+    num_globals: int = 0  # global index space, imported globals first
+    exports: list[tuple[str, int, int]] = field(default_factory=list)  # (name, kind, index)
+
+
+def _read_comptype(r: Reader, form: int) -> FuncType | int | None:
+    """FuncType for func types, the field count for structs, None for arrays."""
+
+    if form == 0x60:
+        params = [r.valtype() for _ in range(r.uleb())]
+        results = [r.valtype() for _ in range(r.uleb())]
+        return FuncType(params, results)
+    if form == 0x5F:  # struct
+        n = r.uleb()
+        for _ in range(n):
+            r.valtype()
+            r.byte()
+        return n
+    if form == 0x5E:  # array
+        r.valtype()
+        r.byte()
+        return None
+    raise ValueError(f"unknown composite type 0x{form:02x}")
+
+
+def read_module(data: bytes) -> ModuleInfo:
+    if data[:4] != MAGIC[:4]:
+        raise ValueError("not a wasm binary")
+    r = Reader(data, 8)
+    info = ModuleInfo({}, [], [], 0, [], (0, 0), [])
+    while not r.at_end():
+        sid = r.byte()
+        size = r.uleb()
+        start, end = r.pos, r.pos + size
+        info.sections.append((sid, start, end))
+        s = Reader(data, start, end)
+        if sid == SEC_TYPE:
+            idx = 0
+            for _ in range(s.uleb()):
+                form = s.byte()
+                group = s.uleb() if form == 0x4E else 1  # rec group
+                for _ in range(group):
+                    f = s.byte() if form == 0x4E else form
+                    if f in (0x50, 0x4F):  # sub / sub final
+                        for _ in range(s.uleb()):
+                            s.uleb()
+                        f = s.byte()
+                    ct = _read_comptype(s, f)
+                    if isinstance(ct, FuncType):
+                        info.types[idx] = ct
+                    elif ct is not None:
+                        info.struct_fields[idx] = ct
+                    idx += 1
+            info.num_types = idx
+        elif sid == SEC_IMPORT:
+            for _ in range(s.uleb()):
+                mod, nm, kind = s.name(), s.name(), s.byte()
+                tidx = -1
+                if kind == 0:
+                    tidx = s.uleb()
+                    info.func_types.append(tidx)
+                elif kind == 1:
+                    s.valtype()
+                    s.limits()
+                elif kind == 2:
+                    s.limits()
+                elif kind == 3:
+                    s.valtype()
+                    s.byte()
+                    info.num_globals += 1
+                elif kind == 4:
+                    s.byte()
+                    tidx = s.uleb()
+                info.imports.append((mod, nm, SEC_IMPORT_KINDS[kind], tidx))
+            info.num_imported_funcs = len(info.func_types)
+        elif sid == SEC_FUNCTION:
+            info.func_types.extend(s.uleb() for _ in range(s.uleb()))
+        elif sid == SEC_GLOBAL:
+            info.num_globals += s.uleb()
+        elif sid == SEC_EXPORT:
+            for _ in range(s.uleb()):
+                nm = s.name()
+                kind = s.byte()
+                info.exports.append((nm, kind, s.uleb()))
+        elif sid == SEC_CODE:
+            info.code_section = (start, end)
+            for _ in range(s.uleb()):
+                n = s.uleb()
+                info.bodies.append((s.pos, s.pos + n))
+                s.pos += n
+        r.pos = end
+    return info
+
+
+def read_locals(data: bytes, body: tuple[int, int]) -> tuple[list[tuple[int, int]], int]:
+    """([(count, valtype), ...], offset of the first instruction) for a code entry."""
+
+    r = Reader(data, body[0], body[1])
+    decls = []
+    for _ in range(r.uleb()):
+        n = r.uleb()
+        decls.append((n, r.valtype()))
+    return decls, r.pos
+
+
+def _skip_fc(r: Reader, sub: int) -> None:
+    if sub in (8, 12, 14):
+        r.uleb()
+        r.uleb()
+    elif sub in (9, 13, 15, 16, 17):
+        r.uleb()
+    elif sub == 10:
+        r.uleb()
+        r.uleb()
+    elif sub == 11:
+        r.uleb()
+
+
+def _skip_fd(r: Reader, sub: int) -> None:
+    if sub <= 11 or sub in (92, 93):
+        r.memarg()
+    elif sub in (12, 13):
+        r.bytes(16)
+    elif 21 <= sub <= 34:
+        r.byte()
+    elif 84 <= sub <= 91:
+        r.memarg()
+        r.byte()
+
+
+def _skip_fb(r: Reader, sub: int) -> None:
+    if sub in (0, 1, 6, 7, 11, 12, 13, 14, 16):
+        r.uleb()
+    elif sub in (2, 3, 4, 5, 8, 9, 10, 17, 18, 19):
+        r.uleb()
+        r.uleb()
+    elif sub in (20, 21, 22, 23):
+        r.heaptype()
+    elif sub in (24, 25):
+        r.byte()
+        r.uleb()
+        r.heaptype()
+        r.heaptype()
+
+
+def iter_ops(data: bytes, start: int, end: int):
+    """
+    Yield (key, pos, imm) for each instruction in [start, end): key is the opcode (prefixed ones as
+    op_key(prefix, sub)), pos the offset of its first byte, imm the first index-like immediate for
+    block types / branches / calls / locals / globals (None otherwise).
+    """
+
+    r = Reader(data, start, end)
+    while not r.at_end():
+        pos = r.pos
+        op = r.byte()
+        imm: int | None = None
+        if op in (0x02, 0x03, 0x04, 0x06):
+            imm = r.blocktype()
+        elif op in (0x0C, 0x0D, 0x10, 0x12, 0x14, 0x15, 0xD2, 0xD5, 0xD6, 0x07, 0x08, 0x09, 0x18) or 0x20 <= op <= 0x26:
+            imm = r.uleb()
+        elif op == 0x0E:
+            for _ in range(r.uleb()):
+                r.uleb()
+            r.uleb()
+        elif op in (0x11, 0x13):
+            imm = r.uleb()
+            r.uleb()
+        elif op == 0x1C:
+            for _ in range(r.uleb()):
+                r.valtype()
+        elif op == 0x1F:  # try_table
+            imm = r.blocktype()
+            for _ in range(r.uleb()):
+                if r.byte() in (0, 1):
+                    r.uleb()
+                r.uleb()
+        elif 0x28 <= op <= 0x3E:
+            r.memarg()
+        elif op in (0x3F, 0x40):
+            r.uleb()
+        elif op == 0x41:
+            r.sleb()
+        elif op == 0x42:
+            r.sleb()
+        elif op == 0x43:
+            r.bytes(4)
+        elif op == 0x44:
+            r.bytes(8)
+        elif op == 0xD0:
+            r.heaptype()
+        elif op == PREFIX_FC:
+            sub = r.uleb()
+            _skip_fc(r, sub)
+            op = op_key(PREFIX_FC, sub)
+        elif op == PREFIX_FD:
+            sub = r.uleb()
+            _skip_fd(r, sub)
+            op = op_key(PREFIX_FD, sub)
+        elif op == PREFIX_FB:
+            sub = r.uleb()
+            _skip_fb(r, sub)
+            op = op_key(PREFIX_FB, sub)
+        elif op == PREFIX_FE:
+            sub = r.uleb()
+            if sub == 3:
+                r.byte()
+            else:
+                r.memarg()
+            op = op_key(PREFIX_FE, sub)
+        yield op, pos, imm
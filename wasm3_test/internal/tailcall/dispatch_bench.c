@@ -0,0 +1,441 @@
+//
+//  dispatch_bench.c
+//
+//  Runs the same synthetic op stream through several interpreter dispatch strategies:
+//
+//      tailcall        threaded handlers in the ops.c calling convention (d_m3OpSig), _r0/_fp0 pinned in
+//                      argument registers, each handler tail-calls the next
+//      tailcall_mem    the same handlers with _r0/_fp0 kept in memory (pc, sp, mem, regs only)
+//      switch          a loop around switch (opcode)
+//      goto            computed goto (labels as values), threaded like tailcall
+//
+//  Every op is one handler word plus one immediate word, so all strategies walk the same layout.
+//  A plain reference interpreter runs first: it gives the exact number of executed ops and the expected
+//  checksum each strategy has to reproduce.
+//
+//  usage: dispatch_bench <strategy> <stream> [body_ops] [iters] [repeat] [seed]
+//  output: u2bench guest lines (Time: / Metric:), best of `repeat` runs
+//
+//  Build with optimizations; tailcall strategies need sibling-call optimization (-O2 or musttail).
+//
+
+#include <iso646.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef double          f64;
+typedef uint64_t        u64;
+typedef int64_t         i64;
+typedef uint32_t        u32;
+typedef int32_t         i32;
+typedef uint8_t         u8;
+
+typedef i64             m3reg_t;
+typedef void *          code_t;
+typedef code_t const *  pc_t;
+typedef const void *    m3ret_t;
+
+#if defined(__has_attribute)
+#   if __has_attribute(musttail)
+#       define d_m3MustTail         __attribute__((musttail))
+#   endif
+#endif
+#ifndef d_m3MustTail
+#   define d_m3MustTail
+#endif
+
+#define vectorcall
+
+#define d_m3OpSig                   pc_t _pc, u64 * _sp, u8 * _mem, m3reg_t _r0, f64 _fp0
+#define d_m3OpArgs                  _sp, _mem, _r0, _fp0
+
+typedef struct M3Regs { m3reg_t r0; f64 fp0; } M3Regs;
+
+#define d_m3OpSigMem                pc_t _pc, u64 * _sp, u8 * _mem, M3Regs * _regs
+#define d_m3OpArgsMem               _sp, _mem, _regs
+
+typedef m3ret_t (vectorcall * IM3Operation)    (d_m3OpSig);
+typedef m3ret_t (vectorcall * IM3OperationMem) (d_m3OpSigMem);
+
+#define immediate(TYPE)             ((TYPE) (intptr_t) * _pc++)
+#define slot(TYPE)                  * (TYPE *) (_sp + immediate (i32))
+
+#define nextOp()                    ((IM3Operation) (* _pc)) (_pc + 1, d_m3OpArgs)
+#define nextOpMem()                 ((IM3OperationMem) (* _pc)) (_pc + 1, d_m3OpArgsMem)
+
+
+enum { c_slots = 16, c_counterSlot = 0, c_memBytes = 1 << 16, c_memMask = c_memBytes - 8 };
+
+// Op bodies, written once against R0 / FP0 so each strategy can place the registers where it wants.
+// br and loop move _pc; every other op consumes exactly its one immediate.
+#define d_bodyList(X)  X(add) X(xor) X(mul) X(shr) X(set) X(load) X(store) X(fadd) X(fmul) X(br) X(loop)
+
+#define body_add        R0 = (i64) ((u64) R0 + slot (u64));
+#define body_xor        R0 ^= (i64) slot (u64);
+#define body_mul        R0 = (i64) ((u64) R0 * (slot (u64) | 1));
+#define body_shr        { i32 s = immediate (i32); R0 ^= (i64) ((u64) R0 >> s); }
+#define body_set        slot (u64) = (u64) R0;
+#define body_load       { i32 o = immediate (i32); R0 = (i64) ((u64) R0 + * (u64 *) (_mem + (((u64) R0 + (u64) o) & c_memMask))); }
+#define body_store      { u64 v = slot (u64); * (u64 *) (_mem + (((u64) R0 >> 7) & c_memMask)) = v ^ (u64) R0; }
+#define body_fadd       { i32 s = immediate (i32); FP0 += (f64) (R0 & 0xff) * (1.0 / (f64) (s + 1)); }
+#define body_fmul       { i32 s = immediate (i32); FP0 = FP0 * 0.9999999 + (f64) s; }
+#define body_br         { i32 skip = immediate (i32); if (R0 & 1) _pc += skip; }
+#define body_loop       { i32 back = immediate (i32); if (-- _sp [c_counterSlot]) _pc -= back; }
+
+enum
+{
+#define d_enum(NAME) c_op_##NAME,
+    d_bodyList (d_enum)
+#undef d_enum
+    c_op_end,
+    c_numOps
+};
+
+
+//--------------------------------------------------------------------------------------------------------------------
+// tailcall: registers pinned in the handler arguments
+
+#define R0 _r0
+#define FP0 _fp0
+#define d_m3Op(NAME)                                                    \
+static m3ret_t vectorcall op_##NAME (d_m3OpSig)                         \
+{                                                                       \
+    body_##NAME                                                         \
+    d_m3MustTail return nextOp ();                                      \
+}
+d_bodyList (d_m3Op)
+#undef d_m3Op
+
+static m3ret_t vectorcall op_end (d_m3OpSig)
+{
+    M3Regs * out = (M3Regs *) (intptr_t) * _pc;
+    (void) _sp; (void) _mem;
+    out->r0 = _r0;
+    out->fp0 = _fp0;
+    return NULL;
+}
+#undef R0
+#undef FP0
+
+static const IM3Operation c_tailOps [c_numOps] = {
+#define d_ptr(NAME) op_##NAME,
+    d_bodyList (d_ptr)
+#undef d_ptr
+    op_end
+};
+
+
+//--------------------------------------------------------------------------------------------------------------------
+// tailcall_mem: same handlers, registers live in memory
+
+#define R0 _regs->r0
+#define FP0 _regs->fp0
+#define d_m3Op(NAME)                                                    \
+static m3ret_t vectorcall opm_##NAME (d_m3OpSigMem)                     \
+{                                                                       \
+    body_##NAME                                                         \
+    d_m3MustTail return nextOpMem ();                                   \
+}
+d_bodyList (d_m3Op)
+#undef d_m3Op
+
+static m3ret_t vectorcall opm_end (d_m3OpSigMem)
+{
+    (void) _pc; (void) _sp; (void) _mem; (void) _regs;
+    return NULL;
+}
+#undef R0
+#undef FP0
+
+static const IM3OperationMem c_memOps [c_numOps] = {
+#define d_ptr(NAME) opm_##NAME,
+    d_bodyList (d_ptr)
+#undef d_ptr
+    opm_end
+};
+
+
+//--------------------------------------------------------------------------------------------------------------------
+// switch and goto: one function, registers in locals
+
+#define R0 _r0
+#define FP0 _fp0
+
+static void RunSwitch (pc_t _pc, u64 * _sp, u8 * _mem, M3Regs * o_regs)
+{
+    m3reg_t _r0 = o_regs->r0;
+    f64 _fp0 = o_regs->fp0;
+    for (;;)
+    {
+        switch ((intptr_t) * _pc++)
+        {
+#define d_case(NAME) case c_op_##NAME: body_##NAME break;
+            d_bodyList (d_case)
+#undef d_case
+            default: goto done;
+        }
+    }
+done:
+    o_regs->r0 = _r0;
+    o_regs->fp0 = _fp0;
+}
+
+#if defined(__GNUC__)
+#   define d_hasComputedGoto 1
+
+// Called with a null _pc it only hands out its label table (labels are local to the function).
+static void RunGoto (pc_t _pc, u64 * _sp, u8 * _mem, M3Regs * o_regs, const void * const ** o_labels)
+{
+    static const void * const labels [c_numOps] = {
+#define d_label(NAME) && L_##NAME,
+        d_bodyList (d_label)
+#undef d_label
+        && L_end
+    };
+    if (_pc == NULL) { * o_labels = labels; return; }
+
+    m3reg_t _r0 = o_regs->r0;
+    f64 _fp0 = o_regs->fp0;
+#   define d_dispatch() goto * (* _pc++)
+    d_dispatch ();
+#define d_label(NAME) L_##NAME: body_##NAME d_dispatch ();
+    d_bodyList (d_label)
+#undef d_label
+L_end:
+    o_regs->r0 = _r0;
+    o_regs->fp0 = _fp0;
+#   undef d_dispatch
+}
+#else
+#   define d_hasComputedGoto 0
+#endif
+
+#undef R0
+#undef FP0
+
+
+//--------------------------------------------------------------------------------------------------------------------
+// Streams: a loop body of `body_ops` ops drawn from a per-stream mix, then loop and end.
+
+typedef struct Op { u8 op; i32 imm; } Op;
+
+typedef struct Stream { const char * name; const u8 * mix; u32 mixLen; } Stream;
+
+static const u8 c_mixAlu []     = { c_op_add, c_op_xor, c_op_mul, c_op_shr, c_op_set };
+static const u8 c_mixMem []     = { c_op_load, c_op_store, c_op_add, c_op_set, c_op_load };
+static const u8 c_mixFloat []   = { c_op_fadd, c_op_fmul, c_op_fadd, c_op_add };
+static const u8 c_mixBranchy [] = { c_op_br, c_op_add, c_op_br, c_op_xor, c_op_shr };
+static const u8 c_mixMixed []   = { c_op_add, c_op_xor, c_op_mul, c_op_shr, c_op_set, c_op_load, c_op_store,
+                                    c_op_fadd, c_op_fmul, c_op_br };
+
+static const Stream c_streams [] = {
+    { "alu",     c_mixAlu,     sizeof (c_mixAlu) },
+    { "mem",     c_mixMem,     sizeof (c_mixMem) },
+    { "float",   c_mixFloat,   sizeof (c_mixFloat) },
+    { "branchy", c_mixBranchy, sizeof (c_mixBranchy) },
+    { "mixed",   c_mixMixed,   sizeof (c_mixMixed) },
+};
+
+static u32 XorShift (u32 * io_state)
+{
+    u32 x = * io_state;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return * io_state = x;
+}
+
+// Returns the op count (body + loop + end). A br never sits in the last body position, so its skip
+// of one op (two words) always lands inside the body.
+static u32 BuildStream (const Stream * i_stream, u32 i_bodyOps, u32 i_seed, Op * o_ops)
+{
+    u32 rng = i_seed ? i_seed : 1;
+    for (u32 i = 0; i < i_bodyOps; ++i)
+    {
+        u8 op = i_stream->mix [XorShift (&rng) % i_stream->mixLen];
+        if (op == c_op_br and i + 1 >= i_bodyOps)
+            op = c_op_add;
+
+        i32 imm = 1 + (i32) (XorShift (&rng) % (c_slots - 1));
+        if (op == c_op_shr)     imm = 1 + (i32) (XorShift (&rng) % 31);
+        if (op == c_op_load)    imm = (i32) (XorShift (&rng) % c_memBytes);
+        if (op == c_op_br)      imm = 2;
+        o_ops [i] = (Op) { op, imm };
+    }
+    o_ops [i_bodyOps] = (Op) { c_op_loop, (i32) (2 * i_bodyOps + 2) };
+    o_ops [i_bodyOps + 1] = (Op) { c_op_end, 0 };
+    return i_bodyOps + 2;
+}
+
+static void ResetState (u64 * o_sp, u8 * o_mem, u64 i_iters, M3Regs * o_regs)
+{
+    for (u32 i = 0; i < c_slots; ++i)
+        o_sp [i] = 0x9e3779b97f4a7c15ull * (i + 1) | 1;
+    o_sp [c_counterSlot] = i_iters;
+    for (u32 i = 0; i < c_memBytes; ++i)
+        o_mem [i] = (u8) (i * 131 + 7);
+    o_regs->r0 = 0x1234567;
+    o_regs->fp0 = 1.0;
+}
+
+static u64 Checksum (const u64 * i_sp, const u8 * i_mem, const M3Regs * i_regs)
+{
+    u64 h = (u64) i_regs->r0, bits;
+    memcpy (& bits, & i_regs->fp0, sizeof (bits));
+    h ^= bits + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    for (u32 i = 1; i < c_slots; ++i)
+        h ^= i_sp [i] + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    for (u32 i = 0; i < c_memBytes; i += 8)
+    {
+        u64 w;
+        memcpy (& w, i_mem + i, 8);
+        h ^= w + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+// Reference: the op list walked directly, counting executed ops.
+static u64 RunReference (const Op * i_ops, u64 * _sp, u8 * _mem, M3Regs * io_regs)
+{
+    m3reg_t R0 = io_regs->r0;
+    f64 FP0 = io_regs->fp0;
+    u64 executed = 0;
+    for (u32 i = 0;; ++i)
+    {
+        const Op op = i_ops [i];
+        ++executed;
+        u64 * s = _sp + op.imm;
+        switch (op.op)
+        {
+            case c_op_add:   R0 = (i64) ((u64) R0 + * s); break;
+            case c_op_xor:   R0 ^= (i64) * s; break;
+            case c_op_mul:   R0 = (i64) ((u64) R0 * (* s | 1)); break;
+            case c_op_shr:   R0 ^= (i64) ((u64) R0 >> op.imm); break;
+            case c_op_set:   * s = (u64) R0; break;
+            case c_op_load:  R0 = (i64) ((u64) R0 + * (u64 *) (_mem + (((u64) R0 + (u64) op.imm) & c_memMask))); break;
+            case c_op_store: * (u64 *) (_mem + (((u64) R0 >> 7) & c_memMask)) = * s ^ (u64) R0; break;
+            case c_op_fadd:  FP0 += (f64) (R0 & 0xff) * (1.0 / (f64) (op.imm + 1)); break;
+            case c_op_fmul:  FP0 = FP0 * 0.9999999 + (f64) op.imm; break;
+            case c_op_br:    if (R0 & 1) i += 1; break;
+            case c_op_loop:  if (-- _sp [c_counterSlot]) i -= (u32) (op.imm / 2); break;
+            default:
+                io_regs->r0 = R0;
+                io_regs->fp0 = FP0;
+                return executed;
+        }
+    }
+}
+
+static u64 NowNs (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, & ts);
+    return (u64) ts.tv_sec * 1000000000ull + (u64) ts.tv_nsec;
+}
+
+enum { c_tailcall, c_tailcallMem, c_switch, c_goto };
+
+static int ParseStrategy (const char * i_name)
+{
+    if (strcmp (i_name, "tailcall") == 0)       return c_tailcall;
+    if (strcmp (i_name, "tailcall_mem") == 0)   return c_tailcallMem;
+    if (strcmp (i_name, "switch") == 0)         return c_switch;
+    if (d_hasComputedGoto and strcmp (i_name, "goto") == 0)
+                                                return c_goto;
+    return -1;
+}
+
+int main (int argc, const char * argv [])
+{
+    if (argc < 3)
+    {
+        fprintf (stderr, "usage: %s <tailcall|tailcall_mem|switch|goto> <stream> [body_ops] [iters] [repeat] [seed]\n", argv [0]);
+        return 2;
+    }
+    int strategy = ParseStrategy (argv [1]);
+    if (strategy < 0)
+    {
+        fprintf (stderr, "unsupported strategy: %s\n", argv [1]);
+        return 2;
+    }
+    const Stream * stream = NULL;
+    for (u32 i = 0; i < sizeof (c_streams) / sizeof (c_streams [0]); ++i)
+        if (strcmp (c_streams [i].name, argv [2]) == 0)
+            stream = & c_streams [i];
+    if (not stream)
+    {
+        fprintf (stderr, "unknown stream: %s\n", argv [2]);
+        return 2;
+    }
+    u32 bodyOps = argc > 3 ? (u32) strtoul (argv [3], NULL, 10) : 64;
+    u64 iters = argc > 4 ? strtoull (argv [4], NULL, 10) : 1000000;
+    u32 repeat = argc > 5 ? (u32) strtoul (argv [5], NULL, 10) : 3;
+    u32 seed = argc > 6 ? (u32) strtoul (argv [6], NULL, 10) : 12345;
+    if (bodyOps < 1 or iters < 1 or repeat < 1)
+    {
+        fprintf (stderr, "body_ops, iters and repeat must be positive\n");
+        return 2;
+    }
+
+    Op * ops = malloc ((bodyOps + 2) * sizeof (Op));
+    code_t * code = malloc ((bodyOps + 2) * 2 * sizeof (code_t));
+    u64 sp [c_slots];
+    u8 * mem = malloc (c_memBytes);
+    M3Regs regs;
+    if (not ops or not code or not mem)
+        return 1;
+    u32 numOps = BuildStream (stream, bodyOps, seed, ops);
+
+    ResetState (sp, mem, iters, & regs);
+    u64 executed = RunReference (ops, sp, mem, & regs);
+    u64 expected = Checksum (sp, mem, & regs);
+
+    // Link: handler word per op (function pointer, label address or opcode), then its immediate.
+    const void * const * labels = NULL;
+    for (u32 i = 0; i < numOps; ++i)
+    {
+        code_t handler = (code_t) (intptr_t) ops [i].op;
+        if (strategy == c_tailcall)         handler = (code_t) c_tailOps [ops [i].op];
+        if (strategy == c_tailcallMem)      handler = (code_t) c_memOps [ops [i].op];
+#if d_hasComputedGoto
+        if (strategy == c_goto)
+        {
+            if (not labels)
+                RunGoto (NULL, NULL, NULL, NULL, & labels);
+            handler = (code_t) labels [ops [i].op];
+        }
+#endif
+        code [2 * i] = handler;
+        code [2 * i + 1] = (code_t) (intptr_t) ops [i].imm;
+    }
+
+    u64 best = UINT64_MAX, checksum = 0;
+    for (u32 r = 0; r < repeat; ++r)
+    {
+        ResetState (sp, mem, iters, & regs);
+        code [2 * numOps - 1] = (code_t) & regs;  // op_end writes the pinned registers back through this
+        u64 t0 = NowNs ();
+        switch (strategy)
+        {
+            case c_tailcall:    ((IM3Operation) code [0]) (code + 1, sp, mem, regs.r0, regs.fp0); break;
+            case c_tailcallMem: ((IM3OperationMem) code [0]) (code + 1, sp, mem, & regs); break;
+            case c_switch:      RunSwitch (code, sp, mem, & regs); break;
+#if d_hasComputedGoto
+            case c_goto:        RunGoto (code, sp, mem, & regs, NULL); break;
+#endif
+        }
+        u64 dt = NowNs () - t0;
+        if (dt < best)
+            best = dt;
+        checksum = Checksum (sp, mem, & regs);
+    }
+
+    printf ("Time: %.3f ms\n", (f64) best / 1e6);
+    printf ("Metric: ops %llu\n", (unsigned long long) executed);
+    printf ("Metric: ns_per_op %.4f\n", (f64) best / (f64) executed);
+    printf ("Metric: checksum_ok %d\n", checksum == expected);
+    printf ("Metric: result %llu\n", (unsigned long long) (checksum & ((1ull << 53) - 1)));
+    free (ops); free (code); free (mem);
+    return checksum == expected ? 0 : 3;
+}